@@ -0,0 +1,72 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <chrono>
+#include <memory>
+#include "pplx/pplxtasks.h"
+
+namespace signalr
+{
+    enum class admission_priority
+    {
+        low,
+        normal,
+        high
+    };
+
+    struct admission_statistics
+    {
+        // number of attempts admitted, including the ones admitted without waiting
+        uint64_t admitted;
+        // number of attempts cancelled (e.g. because the connection was stopped) while waiting to be admitted
+        uint64_t cancelled;
+        // number of admitted attempts that have not been released yet
+        size_t active;
+        size_t queue_depth;
+        size_t max_queue_depth;
+        // time the admitted attempts spent waiting to be admitted
+        std::chrono::microseconds total_wait_time;
+        std::chrono::microseconds max_wait_time;
+    };
+
+    // Limits how many connection attempts (negotiate, connect and reconnect) run at the same time and how fast new
+    // attempts are started. Without it all the connections in the process reconnect at the same moment when a server
+    // restarts which saturates the CPU with TLS handshakes and gets most of the attempts rejected by the server.
+    // When an admission controller is set in the `signalr_client_config` every attempt of the connection waits to be
+    // admitted. Waiting attempts are admitted in the order of their priority (which is set per connection in the
+    // `signalr_client_config`) and then in the order they started waiting. A single admission controller is meant to
+    // be shared by all the connections in the process.
+    class admission_controller
+    {
+    public:
+        // `max_concurrent_attempts` limits the number of admitted attempts that have not been released yet and
+        // `attempts_per_second` limits the rate at which attempts are admitted allowing bursts of up to `burst`
+        // attempts (token bucket). 0 means no limit.
+        SIGNALRCLIENT_API explicit admission_controller(size_t max_concurrent_attempts, double attempts_per_second = 0, size_t burst = 1);
+
+        admission_controller(const admission_controller&) = delete;
+
+        admission_controller& operator=(const admission_controller&) = delete;
+
+        // attempts still waiting are cancelled
+        SIGNALRCLIENT_API ~admission_controller();
+
+        // thread safe - the returned task completes when the attempt is admitted or is cancelled (with
+        // `pplx::task_canceled`) if the `cancellation_token` is cancelled before. Each admitted attempt must be
+        // released with `release` when it completes.
+        SIGNALRCLIENT_API pplx::task<void> __cdecl acquire(admission_priority priority,
+            const pplx::cancellation_token& cancellation_token = pplx::cancellation_token::none());
+
+        SIGNALRCLIENT_API void __cdecl release();
+
+        SIGNALRCLIENT_API admission_statistics __cdecl get_statistics() const;
+
+    private:
+        // shared with the cancellation callbacks and the token bucket timer which may outlive the admission controller
+        struct state;
+        std::shared_ptr<state> m_state;
+    };
+}
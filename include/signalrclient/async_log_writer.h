@@ -0,0 +1,64 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "cpprest/asyncrt_utils.h"
+#include "binary_log_writer.h"
+#include "log_writer.h"
+#include "trace_level.h"
+
+namespace signalr
+{
+    enum class log_overflow_policy
+    {
+        // entries logged when the buffer is full are dropped (and counted)
+        drop,
+        // the logging thread waits until the background thread has made room in the buffer
+        block
+    };
+
+    // A log writer that takes logging off the threads of the connection. Entries are copied into a fixed size lock
+    // free buffer and a background thread formats them (including the timestamp) and passes them in batches to the
+    // wrapped log writer which is therefore only ever called from a single thread. If the wrapped writer is a
+    // `binary_log_writer` the entries are recorded with their structure on the background thread instead. Entries
+    // written by the time `flush` is called or the writer is destroyed are written to the wrapped writer before it
+    // returns.
+    class async_log_writer : public log_writer
+    {
+    public:
+        // `capacity` is rounded up to a power of 2
+        SIGNALRCLIENT_API explicit async_log_writer(const std::shared_ptr<log_writer>& log_writer, size_t capacity = 8192,
+            log_overflow_policy overflow_policy = log_overflow_policy::drop);
+
+        async_log_writer(const async_log_writer&) = delete;
+
+        async_log_writer& operator=(const async_log_writer&) = delete;
+
+        SIGNALRCLIENT_API ~async_log_writer();
+
+        // thread safe - the entry is written as is
+        SIGNALRCLIENT_API void __cdecl write(const utility::string_t &entry) override;
+
+        // blocks until all the entries written before the call have been passed to the wrapped log writer
+        SIGNALRCLIENT_API void __cdecl flush();
+
+        SIGNALRCLIENT_API uint64_t __cdecl get_dropped_entry_count() const;
+
+    private:
+        // shared with the background thread
+        struct state;
+        std::shared_ptr<state> m_state;
+        std::thread m_thread;
+
+        // entries logged by the connection are formatted (including the text of the event and the timestamp) or
+        // recorded by the binary log writer on the background thread
+        friend class logger;
+        void enqueue(trace_level level, log_event event, const utility::string_t& connection_id,
+            std::chrono::steady_clock::time_point timestamp, const utility::string_t& payload);
+    };
+}
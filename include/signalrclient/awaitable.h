@@ -0,0 +1,267 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+// Optional C++20 coroutine surface over the task based API. It is header only and is available only when the
+// compiler supports coroutines - including this header with an older compiler or language version is a no-op.
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#define SIGNALRCLIENT_HAS_COROUTINES
+
+#include <atomic>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include "pplx/pplxtasks.h"
+#include "cpprest/json.h"
+#include "connection.h"
+#include "hub_connection.h"
+#include "hub_proxy.h"
+
+namespace signalr
+{
+    namespace coro
+    {
+        // Awaits a `pplx::task`. The coroutine is resumed from the task's continuation.
+        template<typename T>
+        class task_awaitable
+        {
+        public:
+            explicit task_awaitable(pplx::task<T> task)
+                : m_task(std::move(task))
+            {}
+
+            bool await_ready() const
+            {
+                return m_task.is_done();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                // the exception (if any) is observed in await_resume
+                m_task.then([handle](pplx::task<T>) { handle.resume(); });
+            }
+
+            T await_resume()
+            {
+                return m_task.get();
+            }
+
+        private:
+            pplx::task<T> m_task;
+        };
+
+        // Awaits a hub method invocation. Unlike `task_awaitable` this does not go through a task - the coroutine
+        // is resumed inline on the thread that completed the invocation (typically the thread that received the
+        // response) so the code after `co_await` should not block. If the invocation completes before `invoke()`
+        // returns (e.g. the connection is gone) the coroutine is not suspended at all.
+        class invoke_awaitable
+        {
+        private:
+            // shared with the completion callback which can run on another thread before `await_suspend` returns
+            struct state
+            {
+                web::json::value result;
+                std::exception_ptr error;
+                std::coroutine_handle<> handle;
+                // set by whichever of `await_suspend` and the completion callback finishes first - the other one
+                // then knows the coroutine can continue
+                std::atomic<bool> handoff{ false };
+            };
+
+        public:
+            invoke_awaitable(hub_proxy proxy, utility::string_t method_name, web::json::value arguments)
+                : m_proxy(std::move(proxy)), m_method_name(std::move(method_name)), m_arguments(std::move(arguments)),
+                m_state(std::make_shared<state>())
+            {}
+
+            bool await_ready() const
+            {
+                return false;
+            }
+
+            bool await_suspend(std::coroutine_handle<> handle)
+            {
+                // the coroutine cannot be resumed (and the awaitable destroyed) before the handoff below so the
+                // members are still valid while `invoke()` is running. `this` must not be used after the handoff.
+                auto state = m_state;
+                state->handle = handle;
+                m_proxy.invoke(m_method_name, m_arguments, [state](const web::json::value& result, std::exception_ptr error)
+                {
+                    state->result = result;
+                    state->error = error;
+                    if (state->handoff.exchange(true, std::memory_order_acq_rel))
+                    {
+                        // `await_suspend` has already returned and the coroutine is suspended
+                        state->handle.resume();
+                    }
+                });
+
+                // if the invocation has already completed the coroutine continues on this thread without suspending
+                return !state->handoff.exchange(true, std::memory_order_acq_rel);
+            }
+
+            web::json::value await_resume()
+            {
+                if (m_state->error)
+                {
+                    std::rethrow_exception(m_state->error);
+                }
+
+                return std::move(m_state->result);
+            }
+
+        private:
+            hub_proxy m_proxy;
+            utility::string_t m_method_name;
+            web::json::value m_arguments;
+            std::shared_ptr<state> m_state;
+        };
+
+        inline task_awaitable<void> start(connection& connection)
+        {
+            return task_awaitable<void>(connection.start());
+        }
+
+        inline task_awaitable<void> start(hub_connection& hub_connection)
+        {
+            return task_awaitable<void>(hub_connection.start());
+        }
+
+        inline task_awaitable<void> stop(connection& connection)
+        {
+            return task_awaitable<void>(connection.stop());
+        }
+
+        inline task_awaitable<void> stop(hub_connection& hub_connection)
+        {
+            return task_awaitable<void>(hub_connection.stop());
+        }
+
+        inline task_awaitable<void> send(connection& connection, const utility::string_t& data)
+        {
+            return task_awaitable<void>(connection.send(data));
+        }
+
+        inline invoke_awaitable invoke(const hub_proxy& proxy, const utility::string_t& method_name,
+            const web::json::value& arguments = web::json::value::array())
+        {
+            return invoke_awaitable(proxy, method_name, arguments);
+        }
+
+        // Asynchronous sequence of messages received by a `connection`. The stream takes over the message received
+        // and disconnected callbacks of the connection so it has to be created before the connection is started.
+        // `co_await stream.next()` completes with the next message or with an empty optional once the connection has
+        // been stopped and all buffered messages have been consumed. Only one `next()` may be outstanding at a time.
+        class message_stream
+        {
+        private:
+            struct state
+            {
+                std::mutex lock;
+                std::deque<utility::string_t> messages;
+                std::coroutine_handle<> waiter;
+                std::optional<utility::string_t>* waiter_slot = nullptr;
+                bool completed = false;
+
+                void push(const utility::string_t& message)
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    if (!waiter)
+                    {
+                        messages.push_back(message);
+                        return;
+                    }
+
+                    *waiter_slot = message;
+                    resume_waiter(guard);
+                }
+
+                void complete()
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    completed = true;
+                    if (waiter)
+                    {
+                        resume_waiter(guard);
+                    }
+                }
+
+                // resumes the waiting coroutine inline on the current thread without holding the lock
+                void resume_waiter(std::unique_lock<std::mutex>& guard)
+                {
+                    auto handle = waiter;
+                    waiter = nullptr;
+                    waiter_slot = nullptr;
+                    guard.unlock();
+                    handle.resume();
+                }
+            };
+
+        public:
+            class next_awaitable
+            {
+            public:
+                explicit next_awaitable(std::shared_ptr<state> state)
+                    : m_state(std::move(state))
+                {}
+
+                bool await_ready()
+                {
+                    return false;
+                }
+
+                bool await_suspend(std::coroutine_handle<> handle)
+                {
+                    std::lock_guard<std::mutex> guard(m_state->lock);
+                    if (!m_state->messages.empty())
+                    {
+                        m_result = std::move(m_state->messages.front());
+                        m_state->messages.pop_front();
+                        return false;
+                    }
+
+                    if (m_state->completed)
+                    {
+                        return false;
+                    }
+
+                    m_state->waiter = handle;
+                    m_state->waiter_slot = &m_result;
+                    return true;
+                }
+
+                std::optional<utility::string_t> await_resume()
+                {
+                    return std::move(m_result);
+                }
+
+            private:
+                std::shared_ptr<state> m_state;
+                std::optional<utility::string_t> m_result;
+            };
+
+            explicit message_stream(connection& connection)
+                : m_state(std::make_shared<state>())
+            {
+                auto state = m_state;
+                connection.set_message_received([state](const utility::string_t& message) { state->push(message); });
+                connection.set_disconnected([state]() { state->complete(); });
+            }
+
+            next_awaitable next()
+            {
+                return next_awaitable(m_state);
+            }
+
+        private:
+            std::shared_ptr<state> m_state;
+        };
+    }
+}
+
+#endif
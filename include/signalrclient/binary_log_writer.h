@@ -0,0 +1,63 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <cstdint>
+#include <memory>
+#include "cpprest/asyncrt_utils.h"
+#include "log_writer.h"
+#include "trace_level.h"
+
+namespace signalr
+{
+    // codes of the events recorded in the binary log - the values are part of the file format and must not change
+    enum class log_event : uint16_t
+    {
+        // a free form entry
+        text = 0,
+        message_received = 1,
+        message_sent = 2
+    };
+
+    // A log writer that records entries as compact binary records in a memory-mapped, append-only file instead of
+    // formatting them as text. Each record holds the trace level, the event code, the connection id (written once
+    // per file and then referred to by index), the timestamp (as a delta from the previous record) and the payload.
+    // The file is created (or truncated) with `max_file_size` bytes and is trimmed to the recorded entries when the
+    // writer is destroyed. Once it is full further entries are dropped (and counted). Because the file is mapped
+    // the entries recorded before the process crashed can still be decoded. Use `decode` (or the binlogdecode tool)
+    // to turn the file back into text. Entries are recorded on the logging thread - wrap the writer in an
+    // `async_log_writer` to record them on its background thread instead.
+    class binary_log_writer : public log_writer
+    {
+    public:
+        // throws signalr_exception if the file cannot be created
+        SIGNALRCLIENT_API explicit binary_log_writer(const utility::string_t& file_path, size_t max_file_size = 64 * 1024 * 1024);
+
+        binary_log_writer(const binary_log_writer&) = delete;
+
+        binary_log_writer& operator=(const binary_log_writer&) = delete;
+
+        SIGNALRCLIENT_API ~binary_log_writer();
+
+        // thread safe - the entry is recorded as is and decoded unchanged
+        SIGNALRCLIENT_API void __cdecl write(const utility::string_t &entry) override;
+
+        SIGNALRCLIENT_API uint64_t __cdecl get_dropped_entry_count() const;
+
+        // writes the entries recorded in the file to `output` as text - one call to `write` per entry. A truncated
+        // last record is ignored. Throws signalr_exception if the file cannot be read or is not a binary log.
+        SIGNALRCLIENT_API static void __cdecl decode(const utility::string_t& file_path, log_writer& output);
+
+    private:
+        struct state;
+        std::unique_ptr<state> m_state;
+
+        // entries logged by the connection are recorded with their structure
+        friend class logger;
+        friend class async_log_writer;
+        void write_event(trace_level level, log_event event, const utility::string_t& connection_id,
+            const utility::datetime& timestamp, const utility::string_t& payload);
+    };
+}
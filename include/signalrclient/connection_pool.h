@@ -0,0 +1,79 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "pplx/pplxtasks.h"
+#include "connection.h"
+#include "hub_connection.h"
+#include "dispatch_pool.h"
+#include "timer_queue.h"
+#include "signalr_client_config.h"
+
+namespace signalr
+{
+    struct connection_pool_health
+    {
+        size_t connections;
+        size_t connecting;
+        size_t connected;
+        size_t reconnecting;
+        size_t disconnecting;
+        size_t disconnected;
+        // totals across all the connections in the pool
+        uint64_t reconnects;
+        uint64_t failed_reconnects;
+    };
+
+    // Creates and supervises many connections that share a `dispatch_pool` (so messages of all the connections are
+    // processed by a fixed number of threads) and a single `timer_queue` (so timeouts and reconnect delays don't
+    // block a thread per connection). Unless the config already has one, the connections also share an
+    // `http_client_cache` so their http requests reuse keep-alive connections to the server. Connections created by
+    // the pool use the pool's client config and must not be given a different event loop or timer queue. The pool
+    // stops all its connections when it is destroyed.
+    class connection_pool
+    {
+    public:
+        SIGNALRCLIENT_API explicit connection_pool(size_t dispatch_thread_count, const signalr_client_config& config = signalr_client_config());
+
+        connection_pool(const connection_pool&) = delete;
+
+        connection_pool& operator=(const connection_pool&) = delete;
+
+        SIGNALRCLIENT_API ~connection_pool();
+
+        SIGNALRCLIENT_API std::shared_ptr<connection> __cdecl create_connection(const utility::string_t& url,
+            const utility::string_t& query_string = _XPLATSTR(""), trace_level trace_level = trace_level::all,
+            std::shared_ptr<log_writer> log_writer = nullptr);
+
+        SIGNALRCLIENT_API std::shared_ptr<hub_connection> __cdecl create_hub_connection(const utility::string_t& url,
+            const utility::string_t& query_string = _XPLATSTR(""), trace_level trace_level = trace_level::all,
+            std::shared_ptr<log_writer> log_writer = nullptr, bool use_default_url = true);
+
+        // the connection is not stopped
+        SIGNALRCLIENT_API void __cdecl remove(const std::shared_ptr<connection>& connection);
+        SIGNALRCLIENT_API void __cdecl remove(const std::shared_ptr<hub_connection>& hub_connection);
+
+        // starts all the connections that are disconnected. The task fails if any of the connections failed to start.
+        SIGNALRCLIENT_API pplx::task<void> __cdecl start_all();
+
+        SIGNALRCLIENT_API pplx::task<void> __cdecl stop_all();
+
+        SIGNALRCLIENT_API connection_pool_health __cdecl get_health() const;
+
+    private:
+        signalr_client_config m_config;
+        dispatch_pool m_dispatch_pool;
+        std::shared_ptr<timer_queue> m_timer_queue;
+
+        mutable std::mutex m_lock;
+        std::vector<std::shared_ptr<connection>> m_connections;
+        std::vector<std::shared_ptr<hub_connection>> m_hub_connections;
+
+        signalr_client_config create_client_config();
+    };
+}
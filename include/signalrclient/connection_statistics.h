@@ -0,0 +1,49 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace signalr
+{
+    // A snapshot of the counters of a connection. The counters cover the lifetime of the connection object (i.e.
+    // they are not reset when the connection is restarted). Sizes are in bytes of `utility::string_t` characters.
+    struct connection_statistics
+    {
+        // frames received from the transport - a frame can carry several messages
+        uint64_t frames_received;
+        uint64_t bytes_received;
+        uint64_t frames_parsed;
+        // frames that were not valid JSON objects
+        uint64_t parse_errors;
+        // messages passed on to the message received handler (hub invocation results included)
+        uint64_t messages_received;
+        // messages handed to the transport
+        uint64_t messages_sent;
+        uint64_t bytes_sent;
+        // messages buffered in the reconnect outbox
+        size_t outbound_queue_depth;
+        // hub invocations waiting for their results - always 0 for a `connection`
+        size_t pending_invocations;
+        // allocations (and bytes allocated) for the messages buffered in the reconnect outbox (messages that are not
+        // buffered are not counted) and for the callbacks of hub invocations (always 0 for a `connection`) - taken from
+        // the memory allocator of the client config if set
+        uint64_t outbox_allocations;
+        uint64_t outbox_allocated_bytes;
+        uint64_t invocation_allocations;
+        uint64_t invocation_allocated_bytes;
+        // bytes allocated for the above that have not been freed yet
+        uint64_t outbox_bytes_in_use;
+        uint64_t invocation_bytes_in_use;
+        uint64_t reconnect_attempts;
+        std::chrono::milliseconds last_reconnect_duration;
+        // total time spent in each state, the time spent in the current state included
+        std::chrono::milliseconds time_connecting;
+        std::chrono::milliseconds time_connected;
+        std::chrono::milliseconds time_reconnecting;
+        std::chrono::milliseconds time_disconnecting;
+        std::chrono::milliseconds time_disconnected;
+    };
+}
@@ -0,0 +1,61 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "cpprest/details/basic_types.h"
+#include "event_loop.h"
+
+namespace signalr
+{
+    struct dispatch_thread_statistics
+    {
+        utility::string_t thread_name;
+        uint64_t executed_work_items;
+        std::chrono::nanoseconds busy_time;
+        // time since the thread was started - `busy_time / uptime` is the utilization of the thread
+        std::chrono::nanoseconds uptime;
+        size_t pending_work_items;
+    };
+
+    // A fixed set of named dispatch threads, each driving its own `event_loop`. Loops are handed out in a round
+    // robin fashion and are meant to be set in `signalr_client_config` so that the messages and callbacks of a
+    // connection are always processed on the same thread (which preserves ordering) while multiple connections are
+    // spread over all the threads. If `cpu_affinity` is not empty all the threads are pinned to the given CPUs
+    // (e.g. the CPUs of a single NUMA node). Thread names and affinity are applied on Windows and Linux only - thread
+    // names on Windows require Windows 10 version 1607 or newer.
+    // A non-zero `spin_duration` makes the threads busy poll their loops before blocking (see `event_loop::run`).
+    // Note that the pool must not be destroyed from one of its own threads.
+    class dispatch_pool
+    {
+    public:
+        SIGNALRCLIENT_API explicit dispatch_pool(size_t thread_count, const utility::string_t& thread_name_prefix = _XPLATSTR("signalr-dispatch"),
+            const std::vector<unsigned int>& cpu_affinity = std::vector<unsigned int>(),
+            std::chrono::microseconds spin_duration = std::chrono::microseconds::zero());
+
+        dispatch_pool(const dispatch_pool&) = delete;
+
+        dispatch_pool& operator=(const dispatch_pool&) = delete;
+
+        SIGNALRCLIENT_API ~dispatch_pool();
+
+        SIGNALRCLIENT_API std::shared_ptr<event_loop> __cdecl get_event_loop();
+
+        SIGNALRCLIENT_API size_t __cdecl get_thread_count() const;
+
+        SIGNALRCLIENT_API std::vector<dispatch_thread_statistics> __cdecl get_statistics() const;
+
+    private:
+        std::vector<std::shared_ptr<event_loop>> m_event_loops;
+        std::vector<utility::string_t> m_thread_names;
+        std::vector<std::thread> m_threads;
+        std::atomic<size_t> m_next_event_loop;
+        std::chrono::steady_clock::time_point m_start_time;
+    };
+}
@@ -0,0 +1,73 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include "cpprest/details/basic_types.h"
+
+namespace signalr
+{
+    struct event_loop_statistics
+    {
+        // number of work items executed since the loop was created
+        uint64_t executed_work_items;
+        // total time spent executing work items - comparing it with the wall clock time gives the loop utilization
+        std::chrono::nanoseconds busy_time;
+        // number of work items waiting to be executed
+        size_t pending_work_items;
+    };
+
+    // A user owned queue of work items executed on the thread that drives the loop. When a loop is set in the
+    // `signalr_client_config` the connection processes incoming messages and invokes all user callbacks (including
+    // hub method handlers and invocation results) on the loop instead of on the thread pool. A single loop can be
+    // shared by multiple connections. Note that the loop has to be driven for the connection to start because the
+    // message that completes starting the connection is processed on the loop.
+    class event_loop
+    {
+    public:
+        SIGNALRCLIENT_API event_loop();
+
+        event_loop(const event_loop&) = delete;
+
+        event_loop& operator=(const event_loop&) = delete;
+
+        // thread safe - can be called from any thread
+        SIGNALRCLIENT_API void __cdecl post(const std::function<void __cdecl()>& work);
+
+        // executes at most one queued work item without blocking. Returns `true` if a work item was executed.
+        SIGNALRCLIENT_API bool __cdecl run_once();
+
+        // executes work items on the calling thread until `stop()` is called
+        SIGNALRCLIENT_API void __cdecl run();
+
+        // same as `run()` but when the queue is empty the calling thread busy polls for new work items for up to
+        // `spin_duration` before it blocks. This avoids a thread wake up per message at the cost of burning a core
+        // and is only worth it if the thread is dedicated to the loop (ideally pinned to an isolated CPU).
+        SIGNALRCLIENT_API void __cdecl run(std::chrono::microseconds spin_duration);
+
+        SIGNALRCLIENT_API void __cdecl stop();
+
+        // thread safe - can be called from any thread
+        SIGNALRCLIENT_API event_loop_statistics __cdecl get_statistics() const;
+
+    private:
+        std::deque<std::function<void()>> m_work_items;
+        std::mutex m_lock;
+        std::condition_variable m_work_available;
+        // read without taking the lock when spinning
+        std::atomic<bool> m_stop_requested;
+        std::atomic<size_t> m_pending_work_items;
+        std::atomic<uint64_t> m_executed_work_items;
+        std::atomic<int64_t> m_busy_time_ns;
+
+        void spin(std::chrono::microseconds spin_duration) const;
+        void execute(const std::function<void()>& work);
+    };
+}
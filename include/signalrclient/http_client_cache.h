@@ -0,0 +1,53 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "cpprest/http_client.h"
+
+namespace signalr
+{
+    struct http_client_cache_statistics
+    {
+        // number of requests sent using the cache
+        uint64_t requests;
+        // number of requests sent using an http client that had already been created for the host. These requests
+        // can reuse the pooled keep-alive connections of the client and skip the TCP and TLS handshakes.
+        uint64_t hits;
+        // number of hosts with a cached http client
+        size_t hosts;
+    };
+
+    // Keeps one http client per host (scheme, host and port) so that the negotiate, start, reconnect, ping and abort
+    // requests sent by all the connections using the cache go through the same pool of keep-alive connections
+    // instead of opening (and handshaking) a new connection per request. When a cache is set in the
+    // `signalr_client_config` it is shared by all the connections using that config. The http client for a host is
+    // created with the http client config of the first request to that host, so all the connections sharing a cache
+    // should use the same http client config.
+    class http_client_cache
+    {
+    public:
+        SIGNALRCLIENT_API http_client_cache();
+
+        http_client_cache(const http_client_cache&) = delete;
+
+        http_client_cache& operator=(const http_client_cache&) = delete;
+
+        // thread safe - returns the http client for the host of the `url`, creating it if needed
+        SIGNALRCLIENT_API std::shared_ptr<web::http::client::http_client> __cdecl get_client(const web::uri& url,
+            const web::http::client::http_client_config& http_client_config);
+
+        SIGNALRCLIENT_API http_client_cache_statistics __cdecl get_statistics() const;
+
+    private:
+        mutable std::mutex m_lock;
+        std::unordered_map<utility::string_t, std::shared_ptr<web::http::client::http_client>> m_clients;
+        std::atomic<uint64_t> m_requests;
+        std::atomic<uint64_t> m_hits;
+    };
+}
@@ -6,12 +6,16 @@
 #include "_exports.h"
 #include <memory>
 #include <functional>
+#include <vector>
 #include "pplx/pplxtasks.h"
 #include "cpprest/json.h"
 #include "connection_state.h"
+#include "connection_statistics.h"
 #include "trace_level.h"
 #include "log_writer.h"
+#include "reconnect_policy.h"
 #include "hub_proxy.h"
+#include "latency_histogram.h"
 #include "signalr_client_config.h"
 
 namespace signalr
@@ -30,6 +34,13 @@ namespace signalr
 
         hub_connection& operator=(const hub_connection&) = delete;
 
+        // Optional. Checks in the background that the host names of the connection's endpoints can be resolved so
+        // that the connection skips endpoints whose names cannot be resolved when it starts and reconnects. The
+        // results are cached and shared by all the connections in the process. The resolved addresses are not used
+        // to connect - the transports still resolve the host names themselves. The task fails only if none of the
+        // endpoints could be resolved.
+        SIGNALRCLIENT_API pplx::task<void> __cdecl prepare();
+
         SIGNALRCLIENT_API pplx::task<void> __cdecl start();
         SIGNALRCLIENT_API pplx::task<void> __cdecl stop();
 
@@ -45,6 +56,44 @@ namespace signalr
 
         SIGNALRCLIENT_API void __cdecl set_client_config(const signalr_client_config& config);
 
+        SIGNALRCLIENT_API void __cdecl set_reconnect_policy(const std::shared_ptr<reconnect_policy>& reconnect_policy);
+        SIGNALRCLIENT_API reconnect_statistics __cdecl get_reconnect_statistics() const;
+
+        // cheap enough to be called periodically (e.g. to export metrics)
+        SIGNALRCLIENT_API connection_statistics __cdecl get_statistics() const;
+
+        // Latencies of the invocations of each hub method (`hub_proxy::invoke`) that completed since the connection
+        // was created or the latencies were last reset. Only invocations completed by a response from the server
+        // are included. Empty unless recording is enabled with `signalr_client_config::set_record_invocation_latencies`.
+        SIGNALRCLIENT_API std::vector<invocation_latency> __cdecl get_invocation_latencies() const;
+        // returns the latencies and starts recording them from scratch
+        SIGNALRCLIENT_API std::vector<invocation_latency> __cdecl reset_invocation_latencies();
+
+        // Equivalent endpoints (e.g. servers behind a scaleout backplane) the connection can fail over to. When set,
+        // the connection measures the round trip time to all the endpoints before starting and reconnecting, uses
+        // the fastest healthy one and temporarily stops using endpoints that failed.
+        SIGNALRCLIENT_API void __cdecl set_failover_urls(const std::vector<utility::string_t>& failover_urls);
+
+        // Keeps a second, fully negotiated connection (on a failover endpoint if there is one) connected in the
+        // background. When the connection is lost it switches to the standby immediately instead of reconnecting and
+        // a new standby is built in the background. Doubles the number of server connections.
+        SIGNALRCLIENT_API void __cdecl set_hot_standby(bool hot_standby);
+
+        // Buffers up to `max_messages` messages (holding at most `max_bytes` of data) sent while the connection is
+        // reconnecting instead of failing them. Buffered messages are sent in order once the connection has been
+        // re-established and fail if the connection is stopped instead. Disabled by default.
+        SIGNALRCLIENT_API void __cdecl set_reconnect_outbox(size_t max_messages, size_t max_bytes);
+
+        // When enabled, starting the connection again (after it was stopped or could not reconnect) reuses the
+        // connection token of the previous negotiation if it is not older than `max_negotiation_age` milliseconds
+        // which saves the negotiate request. The connection negotiates again if the server rejects the token.
+        // 0 (the default) disables fast restart.
+        SIGNALRCLIENT_API void __cdecl set_fast_restart(int max_negotiation_age);
+
+        // When enabled, the websocket client (including its TLS context) is created while the negotiate request is in
+        // flight instead of after the negotiate response has been received. Disabled by default.
+        SIGNALRCLIENT_API void __cdecl set_speculative_connect(bool speculative_connect);
+
     private:
         std::shared_ptr<hub_connection_impl> m_pImpl;
         pplx::task<web::json::value> invoke_json(const utility::string_t& hub_name, const utility::string_t& method_name, const web::json::value& arguments,
@@ -20,6 +20,7 @@ namespace signalr
     public:
         typedef std::function<void __cdecl (const web::json::value&)> method_invoked_handler;
         typedef std::function<void __cdecl (const web::json::value&)> on_progress_handler;
+        typedef std::function<void __cdecl (const web::json::value&, std::exception_ptr)> invocation_completed_handler;
 
         explicit hub_proxy(const std::shared_ptr<internal_hub_proxy>& proxy);
 
@@ -53,6 +54,12 @@ namespace signalr
             return invoke_json(method_name, arguments, on_progress);
         }
 
+        // Callback based alternative to `invoke<T>` that does not create a task. `on_completed` is invoked exactly
+        // once with either the result or the exception (in which case the result is null) on the thread that completed
+        // the invocation - typically the thread that received the response from the server - so it should not block.
+        SIGNALRCLIENT_API void __cdecl invoke(const utility::string_t& method_name, const web::json::value& arguments,
+            const invocation_completed_handler& on_completed, const on_progress_handler& on_progress = [](const web::json::value&){});
+
     private:
         std::shared_ptr<internal_hub_proxy> m_pImpl;
 
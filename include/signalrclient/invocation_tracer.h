@@ -0,0 +1,36 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <exception>
+#include <memory>
+#include "cpprest/details/basic_types.h"
+
+namespace signalr
+{
+    // Receives the points in the life of hub method invocations and of events invoked by the server that are needed
+    // to follow them in a distributed tracing system. The handle returned when an invocation (or event) starts is
+    // opaque to the client - it is passed back unchanged for the later points of the same invocation (or event) and
+    // is released after the last one, so it can hold e.g. the span of the tracing system. Methods are called on the
+    // threads of the connection (`invocation_started` on the thread invoking the hub method) so they must be thread
+    // safe, should not block and must not throw. When no tracer is set tracing costs a single null check per point.
+    class invocation_tracer
+    {
+    public:
+        virtual ~invocation_tracer() {}
+
+        virtual std::shared_ptr<void> __cdecl invocation_started(const utility::string_t& hub_name, const utility::string_t& method_name) = 0;
+        // `error` is null if the invocation was sent successfully. Can be called after `result_received` if the response
+        // arrives before sending has completed.
+        virtual void __cdecl invocation_sent(const std::shared_ptr<void>& handle, const std::exception_ptr& error) = 0;
+        // not called if the invocation completed without a response from the server (e.g. the connection was stopped)
+        virtual void __cdecl result_received(const std::shared_ptr<void>& handle) = 0;
+        // after the result (or the error) has been passed to the caller
+        virtual void __cdecl invocation_completed(const std::shared_ptr<void>& handle) = 0;
+
+        virtual std::shared_ptr<void> __cdecl event_received(const utility::string_t& hub_name, const utility::string_t& event_name) = 0;
+        // after the handler registered for the event has returned
+        virtual void __cdecl event_handled(const std::shared_ptr<void>& handle) = 0;
+    };
+}
@@ -0,0 +1,65 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "cpprest/details/basic_types.h"
+
+namespace signalr
+{
+    class latency_recorder;
+
+    // A histogram of latencies with HDR style (log-linear) buckets - values below 64 microseconds are counted
+    // exactly and every power of 2 above is split into 32 buckets so percentiles are within ~3% of the recorded
+    // values. Values above 2^36 microseconds (~19 hours) are counted in the last bucket.
+    class latency_histogram
+    {
+    public:
+        SIGNALRCLIENT_API latency_histogram();
+
+        SIGNALRCLIENT_API void __cdecl record(std::chrono::microseconds value);
+
+        // adds the values recorded in `other` to this histogram
+        SIGNALRCLIENT_API void __cdecl merge(const latency_histogram& other);
+
+        SIGNALRCLIENT_API uint64_t __cdecl get_count() const;
+        SIGNALRCLIENT_API std::chrono::microseconds __cdecl get_min() const;
+        SIGNALRCLIENT_API std::chrono::microseconds __cdecl get_max() const;
+        SIGNALRCLIENT_API std::chrono::microseconds __cdecl get_mean() const;
+        SIGNALRCLIENT_API std::chrono::microseconds __cdecl get_sum() const;
+
+        // the highest value (within the precision of the histogram) that `percentile` percent of the recorded values
+        // do not exceed, e.g. get_value_at_percentile(99.9). 0 if nothing has been recorded.
+        SIGNALRCLIENT_API std::chrono::microseconds __cdecl get_value_at_percentile(double percentile) const;
+
+    private:
+        friend class latency_recorder;
+
+        std::vector<uint64_t> m_counts;
+        uint64_t m_count;
+        uint64_t m_min;
+        uint64_t m_max;
+        uint64_t m_sum;
+
+        static size_t get_bucket_index(uint64_t value);
+        static uint64_t get_bucket_upper_bound(size_t index);
+        static const size_t bucket_count;
+    };
+
+    // the latencies of invocations of a hub method
+    struct invocation_latency
+    {
+        utility::string_t hub_name;
+        utility::string_t method_name;
+        // from invoking the method until its result (or error) returned by the server was passed to the caller
+        latency_histogram round_trip;
+        // from invoking the method until the invocation was sent
+        latency_histogram send;
+        // from receiving the response until its result was passed to the caller
+        latency_histogram response_dispatch;
+    };
+}
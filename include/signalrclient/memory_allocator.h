@@ -0,0 +1,23 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <cstddef>
+
+namespace signalr
+{
+    // Provides the memory for the buffers and containers owned by a connection - the messages buffered while
+    // reconnecting and the callbacks of pending hub method invocations (e.g. to allocate them from a per connection
+    // arena). Memory is always returned to the allocator it was allocated from, even if the allocator in the config
+    // of the connection has been replaced in the meantime. Must be thread safe.
+    class memory_allocator
+    {
+    public:
+        virtual ~memory_allocator() {}
+
+        // throws std::bad_alloc if the memory cannot be allocated
+        virtual void* __cdecl allocate(size_t size, size_t alignment) = 0;
+        virtual void __cdecl deallocate(void* pointer, size_t size, size_t alignment) = 0;
+    };
+}
@@ -0,0 +1,51 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "cpprest/details/basic_types.h"
+#include "connection_state.h"
+#include "connection_statistics.h"
+#include "latency_histogram.h"
+#include "reconnect_policy.h"
+
+namespace signalr
+{
+    struct connection_metrics
+    {
+        utility::string_t url;
+        utility::string_t connection_id;
+        connection_state state;
+        connection_statistics statistics;
+        reconnect_statistics reconnects;
+        // empty for a `connection`
+        std::vector<invocation_latency> invocation_latencies;
+    };
+
+    // The metrics of a single connection. Collecting them reads the counters the connection keeps anyway so
+    // sources can be collected as often as needed without affecting the connection.
+    class metrics_source
+    {
+    public:
+        virtual ~metrics_source() {}
+
+        // returns false if the connection no longer exists
+        virtual bool __cdecl collect(connection_metrics& metrics) const = 0;
+    };
+
+    // Receives the metrics sources of the connections it is set for (in the `signalr_client_config`). A connection
+    // adds its source when the config is set and removes it when the connection is destroyed or the config is
+    // replaced so a sink shared by all the connections in the process always sees all the live connections.
+    // Nothing is done on behalf of the sink while messages are processed - the counters behind a source are
+    // updated the same way whether a sink is set or not.
+    class metrics_sink
+    {
+    public:
+        virtual ~metrics_sink() {}
+
+        virtual void __cdecl add_source(const std::shared_ptr<metrics_source>& source) = 0;
+        virtual void __cdecl remove_source(const std::shared_ptr<metrics_source>& source) = 0;
+    };
+}
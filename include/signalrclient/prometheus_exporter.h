@@ -0,0 +1,39 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include "metrics_sink.h"
+
+namespace signalr
+{
+    // A metrics sink that renders the metrics of all the connections it has been set for in the Prometheus text
+    // exposition format (version 0.0.4), e.g. to be returned from a /metrics endpoint. Connections are labelled with
+    // the id the exporter assigned to their source when it was added and their url, invocation latencies (as summaries)
+    // with the hub and method name.
+    class prometheus_exporter : public metrics_sink
+    {
+    public:
+        SIGNALRCLIENT_API prometheus_exporter();
+
+        prometheus_exporter(const prometheus_exporter&) = delete;
+
+        prometheus_exporter& operator=(const prometheus_exporter&) = delete;
+
+        SIGNALRCLIENT_API void __cdecl add_source(const std::shared_ptr<metrics_source>& source) override;
+        SIGNALRCLIENT_API void __cdecl remove_source(const std::shared_ptr<metrics_source>& source) override;
+
+        // thread safe - returns UTF-8 text
+        SIGNALRCLIENT_API std::string __cdecl render() const;
+
+    private:
+        // the id assigned to each source
+        std::map<std::shared_ptr<metrics_source>, uint64_t> m_sources;
+        uint64_t m_next_source_id;
+        mutable std::mutex m_sources_lock;
+    };
+}
@@ -0,0 +1,103 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include "cpprest/details/basic_types.h"
+
+namespace signalr
+{
+    struct reconnect_context
+    {
+        // number of reconnect attempts that have failed so far in the current reconnect - 0 when asked for the delay
+        // before the first attempt
+        unsigned int failed_attempts;
+        // time since the connection started reconnecting
+        std::chrono::milliseconds elapsed_time;
+        // the delay returned for the previous failed attempt (zero after the first failed attempt)
+        std::chrono::milliseconds previous_delay;
+    };
+
+    // Decides whether and when the connection should retry after a failed reconnect attempt. It is also asked for the
+    // delay before the first attempt (with no failed attempts) which should be short and is mostly meant to be
+    // jittered so that the clients that lost the connection at the same time do not reconnect at once. Regardless of the
+    // policy the connection stops reconnecting when the next attempt would start after the server has already
+    // dropped the connection (i.e. after the disconnect timeout the server returned when negotiating).
+    // A single policy instance can be shared by multiple connections so implementations must be thread safe.
+    class reconnect_policy
+    {
+    public:
+        virtual ~reconnect_policy() {}
+
+        // returns `false` to stop reconnecting, otherwise sets `delay` to the time to wait before the next attempt
+        virtual bool __cdecl next_delay(const reconnect_context& context, std::chrono::milliseconds& delay) = 0;
+    };
+
+    // Retries at a fixed interval. This is the default policy (with a 2 second delay). The first attempt is not delayed.
+    class fixed_delay_reconnect_policy : public reconnect_policy
+    {
+    public:
+        SIGNALRCLIENT_API explicit fixed_delay_reconnect_policy(std::chrono::milliseconds delay);
+
+        SIGNALRCLIENT_API bool __cdecl next_delay(const reconnect_context& context, std::chrono::milliseconds& delay) override;
+
+    private:
+        std::chrono::milliseconds m_delay;
+    };
+
+    enum class reconnect_jitter
+    {
+        // `min(max_delay, base_delay * 2^(failed_attempts - 1))`
+        none,
+        // a random delay between 0 and the delay without jitter
+        full,
+        // a random delay between `base_delay` and three times the previous delay, capped at `max_delay`
+        decorrelated
+    };
+
+    // Exponential backoff with optional jitter. Jitter spreads the reconnect attempts of many clients that lost
+    // the connection to the same server at the same time so that they don't reconnect in lockstep - with jitter the
+    // first attempt is delayed by a random delay between 0 and `base_delay`, otherwise it is not delayed. `max_attempts`
+    // caps the number of attempts per reconnect (0 means no cap).
+    class exponential_backoff_reconnect_policy : public reconnect_policy
+    {
+    public:
+        SIGNALRCLIENT_API exponential_backoff_reconnect_policy(std::chrono::milliseconds base_delay, std::chrono::milliseconds max_delay,
+            reconnect_jitter jitter = reconnect_jitter::full, unsigned int max_attempts = 0);
+
+        SIGNALRCLIENT_API bool __cdecl next_delay(const reconnect_context& context, std::chrono::milliseconds& delay) override;
+
+    private:
+        std::chrono::milliseconds m_base_delay;
+        std::chrono::milliseconds m_max_delay;
+        reconnect_jitter m_jitter;
+        unsigned int m_max_attempts;
+        std::mutex m_random_lock;
+        std::mt19937 m_random;
+
+        int64_t random_between(int64_t min, int64_t max);
+    };
+
+    struct reconnect_statistics
+    {
+        // number of times the connection started reconnecting
+        uint64_t reconnects;
+        uint64_t successful_reconnects;
+        uint64_t failed_reconnects;
+        // reconnect attempts across all reconnects
+        uint64_t attempts;
+        // number of attempts and duration of the most recently completed reconnect
+        unsigned int last_reconnect_attempts;
+        std::chrono::milliseconds last_reconnect_duration;
+        // number of times the connection was considered lost because nothing (not even a keep-alive) was received
+        // from the server within the negotiated keep-alive timeout
+        uint64_t keep_alive_timeouts;
+        // time between the last message received and detecting the most recent keep-alive timeout
+        std::chrono::milliseconds last_keep_alive_detection_time;
+    };
+}
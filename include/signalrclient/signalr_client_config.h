@@ -6,12 +6,21 @@
 #include "cpprest/http_client.h"
 #include "cpprest/ws_client.h"
 #include "_exports.h"
+#include "admission_controller.h"
+#include "event_loop.h"
+#include "http_client_cache.h"
+#include "invocation_tracer.h"
+#include "memory_allocator.h"
+#include "metrics_sink.h"
+#include "timer_queue.h"
 
 namespace signalr
 {
     class signalr_client_config
     {
     public:
+        SIGNALRCLIENT_API signalr_client_config();
+
         SIGNALRCLIENT_API void __cdecl set_proxy(const web::web_proxy &proxy);
         // Please note that setting credentials does not work in all cases.
         // For example, Basic Authentication fails under Win32.
@@ -28,9 +37,64 @@ namespace signalr
         SIGNALRCLIENT_API web::http::http_headers __cdecl get_http_headers() const;
         SIGNALRCLIENT_API void __cdecl set_http_headers(const web::http::http_headers& http_headers);
 
+        // When set, incoming messages are processed and callbacks are invoked on the given loop. The same loop can
+        // be set for multiple connections.
+        SIGNALRCLIENT_API std::shared_ptr<event_loop> __cdecl get_event_loop() const;
+        SIGNALRCLIENT_API void __cdecl set_event_loop(const std::shared_ptr<event_loop>& event_loop);
+
+        // When set, timeouts and delays are scheduled on the given timer queue instead of blocking a thread pool
+        // thread. The same timer queue can be set for multiple connections.
+        SIGNALRCLIENT_API std::shared_ptr<timer_queue> __cdecl get_timer_queue() const;
+        SIGNALRCLIENT_API void __cdecl set_timer_queue(const std::shared_ptr<timer_queue>& timer_queue);
+
+        // When set, http requests are sent using the http clients cached per host instead of a new http client (and
+        // therefore a new TCP connection and TLS handshake) per request. The same cache can be set for multiple
+        // connections.
+        SIGNALRCLIENT_API std::shared_ptr<http_client_cache> __cdecl get_http_client_cache() const;
+        SIGNALRCLIENT_API void __cdecl set_http_client_cache(const std::shared_ptr<http_client_cache>& http_client_cache);
+
+        // When set, every negotiate, connect and reconnect attempt has to be admitted by the given admission
+        // controller before it starts. The same admission controller can be set for multiple connections. The
+        // priority decides which of the waiting attempts of the connections sharing the controller goes first.
+        SIGNALRCLIENT_API std::shared_ptr<admission_controller> __cdecl get_admission_controller() const;
+        SIGNALRCLIENT_API void __cdecl set_admission_controller(const std::shared_ptr<admission_controller>& admission_controller);
+
+        SIGNALRCLIENT_API admission_priority __cdecl get_admission_priority() const;
+        SIGNALRCLIENT_API void __cdecl set_admission_priority(admission_priority priority);
+
+        // When set, the connection adds the source of its metrics to the given sink. The same sink can be set for
+        // multiple connections.
+        SIGNALRCLIENT_API std::shared_ptr<metrics_sink> __cdecl get_metrics_sink() const;
+        SIGNALRCLIENT_API void __cdecl set_metrics_sink(const std::shared_ptr<metrics_sink>& metrics_sink);
+
+        // When set, the buffers and containers owned by the connection are allocated from the given allocator
+        // instead of the global operator new.
+        SIGNALRCLIENT_API std::shared_ptr<memory_allocator> __cdecl get_memory_allocator() const;
+        SIGNALRCLIENT_API void __cdecl set_memory_allocator(const std::shared_ptr<memory_allocator>& memory_allocator);
+
+        // When set, a hub connection reports the invocations of hub methods and the events invoked by the server to
+        // the given tracer. Ignored by a `connection`.
+        SIGNALRCLIENT_API std::shared_ptr<invocation_tracer> __cdecl get_invocation_tracer() const;
+        SIGNALRCLIENT_API void __cdecl set_invocation_tracer(const std::shared_ptr<invocation_tracer>& invocation_tracer);
+
+        // When true, a hub connection records the latencies of the invocations of each hub method (see
+        // `hub_connection::get_invocation_latencies`). Off by default because the histograms take about 24 KB per
+        // hub method per connection. Ignored by a `connection`.
+        SIGNALRCLIENT_API bool __cdecl get_record_invocation_latencies() const;
+        SIGNALRCLIENT_API void __cdecl set_record_invocation_latencies(bool record_invocation_latencies);
+
     private:
         web::http::client::http_client_config m_http_client_config;
         web::websockets::client::websocket_client_config m_websocket_client_config;
         web::http::http_headers m_http_headers;
+        std::shared_ptr<event_loop> m_event_loop;
+        std::shared_ptr<timer_queue> m_timer_queue;
+        std::shared_ptr<http_client_cache> m_http_client_cache;
+        std::shared_ptr<admission_controller> m_admission_controller;
+        admission_priority m_admission_priority;
+        std::shared_ptr<metrics_sink> m_metrics_sink;
+        std::shared_ptr<memory_allocator> m_memory_allocator;
+        std::shared_ptr<invocation_tracer> m_invocation_tracer;
+        bool m_record_invocation_latencies;
     };
 }
\ No newline at end of file
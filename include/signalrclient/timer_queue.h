@@ -0,0 +1,48 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include "_exports.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include "cpprest/details/basic_types.h"
+
+namespace signalr
+{
+    // A single thread that runs callbacks after a delay. When a timer queue is set in the `signalr_client_config`
+    // the connection uses it for the transport connect timeout and for the delays between reconnect attempts
+    // instead of blocking a thread pool thread for the duration of each delay, which matters when there are many
+    // connections in the process. A single timer queue is meant to be shared by many connections.
+    // Callbacks run on the timer thread and therefore must not block.
+    class timer_queue
+    {
+    public:
+        SIGNALRCLIENT_API timer_queue();
+
+        timer_queue(const timer_queue&) = delete;
+
+        timer_queue& operator=(const timer_queue&) = delete;
+
+        // callbacks that have not run yet are not invoked - their `on_cancelled` callbacks (if any) are invoked instead
+        // on the thread destroying the queue
+        SIGNALRCLIENT_API ~timer_queue();
+
+        // thread safe - can be called from any thread including the timer thread
+        SIGNALRCLIENT_API void __cdecl schedule(std::chrono::milliseconds delay, const std::function<void __cdecl()>& callback);
+
+        // as above but `on_cancelled` is invoked instead of `callback` if the queue is destroyed before the callback runs
+        SIGNALRCLIENT_API void __cdecl schedule(std::chrono::milliseconds delay, const std::function<void __cdecl()>& callback,
+            const std::function<void __cdecl()>& on_cancelled);
+
+        SIGNALRCLIENT_API size_t __cdecl get_pending_timer_count() const;
+
+    private:
+        // shared with the timer thread so that the thread can safely finish after being detached
+        struct state;
+        std::shared_ptr<state> m_state;
+        std::thread m_thread;
+    };
+}
@@ -0,0 +1,43 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+// Converts a log recorded with signalr::binary_log_writer to text.
+// usage: binlogdecode <binary log file>
+
+#include <iostream>
+#include "cpprest/asyncrt_utils.h"
+#include "signalrclient/binary_log_writer.h"
+
+namespace
+{
+    class console_log_writer : public signalr::log_writer
+    {
+    public:
+        void __cdecl write(const utility::string_t &entry) override
+        {
+            ucout << entry;
+        }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: binlogdecode <binary log file>" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        console_log_writer writer;
+        signalr::binary_log_writer::decode(utility::conversions::to_string_t(argv[1]), writer);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
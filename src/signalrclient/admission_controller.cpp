@@ -0,0 +1,268 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "signalrclient/admission_controller.h"
+#include "signalrclient/timer_queue.h"
+
+namespace signalr
+{
+    struct admission_controller::state : public std::enable_shared_from_this<admission_controller::state>
+    {
+        struct waiter
+        {
+            pplx::task_completion_event<void> admitted;
+            pplx::cancellation_token cancellation_token;
+            pplx::cancellation_token_registration registration;
+            bool registered;
+            std::chrono::steady_clock::time_point wait_started;
+        };
+
+        // waiters are ordered by priority (highest first) and then by the order in which they started waiting
+        typedef std::pair<int, uint64_t> waiter_key;
+
+        const size_t max_concurrent_attempts;
+        const double attempts_per_second;
+        const double burst;
+
+        std::mutex lock;
+        std::map<waiter_key, waiter> waiters;
+        uint64_t next_sequence_number;
+        size_t active;
+        double tokens;
+        std::chrono::steady_clock::time_point last_refill;
+        bool refill_scheduled;
+        bool stopped;
+        admission_statistics statistics;
+
+        // only needed (and created) when the rate of attempts is limited
+        std::unique_ptr<timer_queue> timers;
+
+        state(size_t max_concurrent_attempts, double attempts_per_second, size_t burst)
+            : max_concurrent_attempts(max_concurrent_attempts), attempts_per_second(attempts_per_second),
+            burst(static_cast<double>(std::max<size_t>(burst, 1))), next_sequence_number(0), active(0),
+            tokens(static_cast<double>(std::max<size_t>(burst, 1))), last_refill(std::chrono::steady_clock::now()),
+            refill_scheduled(false), stopped(false), statistics()
+        {
+            if (attempts_per_second > 0)
+            {
+                timers.reset(new timer_queue());
+            }
+        }
+
+        // must be called with the lock held - the admitted waiters have to be completed after releasing the lock
+        void admit_waiters(std::vector<waiter>& admitted)
+        {
+            auto now = std::chrono::steady_clock::now();
+            if (attempts_per_second > 0)
+            {
+                tokens = std::min(burst, tokens + std::chrono::duration<double>(now - last_refill).count() * attempts_per_second);
+                last_refill = now;
+            }
+
+            while (!waiters.empty() && has_free_slot() && (attempts_per_second <= 0 || tokens >= 1))
+            {
+                auto iter = waiters.begin();
+
+                if (attempts_per_second > 0)
+                {
+                    tokens -= 1;
+                }
+
+                active++;
+
+                auto wait_time = std::chrono::duration_cast<std::chrono::microseconds>(now - iter->second.wait_started);
+                statistics.admitted++;
+                statistics.total_wait_time += wait_time;
+                statistics.max_wait_time = std::max(statistics.max_wait_time, wait_time);
+
+                admitted.push_back(iter->second);
+                waiters.erase(iter);
+            }
+
+            // the attempts are only waiting for the token bucket to refill
+            if (!waiters.empty() && has_free_slot() && timers && !refill_scheduled)
+            {
+                refill_scheduled = true;
+
+                auto delay = std::chrono::milliseconds(
+                    static_cast<long long>(std::ceil((1 - tokens) / attempts_per_second * 1000)));
+
+                auto weak_state = std::weak_ptr<state>(shared_from_this());
+                timers->schedule(std::max(delay, std::chrono::milliseconds(1)), [weak_state]()
+                {
+                    auto state = weak_state.lock();
+                    if (state)
+                    {
+                        std::vector<waiter> admitted;
+                        {
+                            std::lock_guard<std::mutex> lock(state->lock);
+                            state->refill_scheduled = false;
+                            state->admit_waiters(admitted);
+                        }
+
+                        complete(admitted);
+                    }
+                });
+            }
+        }
+
+        bool has_free_slot() const
+        {
+            return max_concurrent_attempts == 0 || active < max_concurrent_attempts;
+        }
+
+        void cancel(const waiter_key& key)
+        {
+            pplx::task_completion_event<void> admitted;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+
+                auto iter = waiters.find(key);
+                if (iter == waiters.end())
+                {
+                    return;
+                }
+
+                admitted = iter->second.admitted;
+                waiters.erase(iter);
+                statistics.cancelled++;
+            }
+
+            admitted.set_exception(pplx::task_canceled());
+        }
+
+        static void complete(const std::vector<waiter>& admitted)
+        {
+            for (auto& waiter : admitted)
+            {
+                waiter.admitted.set();
+
+                if (waiter.registered)
+                {
+                    waiter.cancellation_token.deregister_callback(waiter.registration);
+                }
+            }
+        }
+    };
+
+    admission_controller::admission_controller(size_t max_concurrent_attempts, double attempts_per_second, size_t burst)
+        : m_state(std::make_shared<state>(max_concurrent_attempts, attempts_per_second, burst))
+    { }
+
+    admission_controller::~admission_controller()
+    {
+        std::map<state::waiter_key, state::waiter> waiters;
+        {
+            std::lock_guard<std::mutex> lock(m_state->lock);
+            m_state->stopped = true;
+            m_state->statistics.cancelled += m_state->waiters.size();
+            waiters.swap(m_state->waiters);
+        }
+
+        for (auto& entry : waiters)
+        {
+            if (entry.second.registered)
+            {
+                entry.second.cancellation_token.deregister_callback(entry.second.registration);
+            }
+
+            entry.second.admitted.set_exception(pplx::task_canceled());
+        }
+    }
+
+    pplx::task<void> admission_controller::acquire(admission_priority priority, const pplx::cancellation_token& cancellation_token)
+    {
+        pplx::task_completion_event<void> admitted_tce;
+        state::waiter_key key;
+        std::vector<state::waiter> admitted;
+        {
+            std::lock_guard<std::mutex> lock(m_state->lock);
+
+            if (m_state->stopped || cancellation_token.is_canceled())
+            {
+                m_state->statistics.cancelled++;
+                return pplx::task_from_exception<void>(pplx::task_canceled());
+            }
+
+            key = std::make_pair(-static_cast<int>(priority), m_state->next_sequence_number++);
+            state::waiter waiter = { admitted_tce, cancellation_token, pplx::cancellation_token_registration(), false,
+                std::chrono::steady_clock::now() };
+            m_state->waiters.insert(std::make_pair(key, waiter));
+            m_state->statistics.max_queue_depth = std::max(m_state->statistics.max_queue_depth, m_state->waiters.size());
+
+            // admits the new waiter right away if there is a free slot and nobody with a higher priority is waiting
+            m_state->admit_waiters(admitted);
+        }
+
+        state::complete(admitted);
+
+        if (cancellation_token.is_cancelable())
+        {
+            // the callback runs synchronously if the token has just been cancelled so it can't be registered while
+            // holding the lock
+            auto weak_state = std::weak_ptr<state>(m_state);
+            auto registration = cancellation_token.register_callback([weak_state, key]()
+            {
+                auto state = weak_state.lock();
+                if (state)
+                {
+                    state->cancel(key);
+                }
+            });
+
+            auto still_waiting = false;
+            {
+                std::lock_guard<std::mutex> lock(m_state->lock);
+
+                auto iter = m_state->waiters.find(key);
+                if (iter != m_state->waiters.end())
+                {
+                    iter->second.registration = registration;
+                    iter->second.registered = true;
+                    still_waiting = true;
+                }
+            }
+
+            if (!still_waiting)
+            {
+                cancellation_token.deregister_callback(registration);
+            }
+        }
+
+        return pplx::create_task(admitted_tce);
+    }
+
+    void admission_controller::release()
+    {
+        std::vector<state::waiter> admitted;
+        {
+            std::lock_guard<std::mutex> lock(m_state->lock);
+
+            _ASSERTE(m_state->active > 0);
+            if (m_state->active > 0)
+            {
+                m_state->active--;
+            }
+
+            m_state->admit_waiters(admitted);
+        }
+
+        state::complete(admitted);
+    }
+
+    admission_statistics admission_controller::get_statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_state->lock);
+
+        auto statistics = m_state->statistics;
+        statistics.active = m_state->active;
+        statistics.queue_depth = m_state->waiters.size();
+        return statistics;
+    }
+}
@@ -0,0 +1,324 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "signalrclient/async_log_writer.h"
+#include "logger.h"
+
+namespace signalr
+{
+    namespace
+    {
+        const size_t max_batch_size = 256;
+        const std::chrono::milliseconds idle_wait_time(50);
+
+        struct log_entry
+        {
+            // entries written directly to the writer are already formatted
+            bool formatted;
+            trace_level level;
+            log_event event;
+            // reading the steady clock is much cheaper than getting the current date and time on the logging thread
+            std::chrono::steady_clock::time_point timestamp;
+            // only kept for a binary log writer
+            utility::string_t connection_id;
+            utility::string_t text;
+        };
+
+        size_t round_up_to_power_of_2(size_t value)
+        {
+            size_t result = 2;
+            while (result < value)
+            {
+                result <<= 1;
+            }
+
+            return result;
+        }
+    }
+
+    // Bounded multi-producer single-consumer queue. Each cell has a sequence number which tells whether the cell is
+    // free for the producer that claimed its position (sequence == position) or holds an entry ready for the consumer
+    // (sequence == position + 1). Producers claim positions with a CAS so they never take a lock.
+    struct async_log_writer::state
+    {
+        struct cell
+        {
+            std::atomic<size_t> sequence;
+            log_entry entry;
+        };
+
+        std::shared_ptr<log_writer> writer;
+        // set if the wrapped writer is a binary log writer
+        std::shared_ptr<binary_log_writer> binary_writer;
+        log_overflow_policy overflow_policy;
+
+        std::unique_ptr<cell[]> cells;
+        size_t mask;
+        std::atomic<size_t> enqueue_position;
+        // only accessed by the background thread
+        size_t dequeue_position;
+
+        std::atomic<uint64_t> dropped_entries;
+        uint64_t reported_dropped_entries;
+
+        // timestamps of the entries are converted to the date and time relative to when the writer was created
+        utility::datetime created_time;
+        std::chrono::steady_clock::time_point created_steady_time;
+
+        std::mutex lock;
+        std::condition_variable entries_available;
+        std::condition_variable entries_written;
+        std::atomic<bool> consumer_waiting;
+        std::atomic<size_t> written_position;
+        bool stop_requested;
+
+        state(const std::shared_ptr<log_writer>& writer, size_t capacity, log_overflow_policy overflow_policy)
+            : writer(writer), binary_writer(std::dynamic_pointer_cast<binary_log_writer>(writer)), overflow_policy(overflow_policy), cells(new cell[round_up_to_power_of_2(capacity)]),
+            mask(round_up_to_power_of_2(capacity) - 1), enqueue_position(0), dequeue_position(0), dropped_entries(0),
+            reported_dropped_entries(0), created_time(utility::datetime::utc_now()), created_steady_time(std::chrono::steady_clock::now()),
+            consumer_waiting(false), written_position(0), stop_requested(false)
+        {
+            for (size_t i = 0; i <= mask; i++)
+            {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool try_enqueue(log_entry& entry)
+        {
+            auto position = enqueue_position.load(std::memory_order_relaxed);
+            cell* target;
+            for (;;)
+            {
+                target = &cells[position & mask];
+                auto sequence = target->sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (difference == 0)
+                {
+                    if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // the consumer has not freed the cell yet - the queue is full
+                    return false;
+                }
+                else
+                {
+                    position = enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+
+            target->entry = std::move(entry);
+            target->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_dequeue(log_entry& entry)
+        {
+            auto& source = cells[dequeue_position & mask];
+            if (source.sequence.load(std::memory_order_acquire) != dequeue_position + 1)
+            {
+                return false;
+            }
+
+            entry = std::move(source.entry);
+            source.sequence.store(dequeue_position + mask + 1, std::memory_order_release);
+            dequeue_position++;
+            return true;
+        }
+
+        void enqueue(log_entry& entry)
+        {
+            while (!try_enqueue(entry))
+            {
+                if (overflow_policy == log_overflow_policy::drop)
+                {
+                    dropped_entries++;
+                    return;
+                }
+
+                wake_consumer();
+                std::this_thread::yield();
+            }
+
+            // pairs with the fence in `run` - either the consumer sees the entry or the producer sees it waiting
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (consumer_waiting.load(std::memory_order_relaxed))
+            {
+                wake_consumer();
+            }
+        }
+
+        void wake_consumer()
+        {
+            // taking the lock makes sure the consumer is either waiting (and gets notified) or has not yet checked
+            // the queue (and will see the new entry)
+            std::lock_guard<std::mutex> guard(lock);
+            entries_available.notify_one();
+        }
+
+        utility::datetime to_datetime(std::chrono::steady_clock::time_point timestamp) const
+        {
+            // datetime intervals are in 100ns units
+            return created_time + static_cast<utility::datetime::interval_type>(
+                std::chrono::duration_cast<std::chrono::microseconds>(timestamp - created_steady_time).count() * 10);
+        }
+
+        utility::string_t format(const log_entry& entry) const
+        {
+            return logger::format_entry(entry.level, to_datetime(entry.timestamp),
+                entry.event == log_event::text ? entry.text : logger::format_event(entry.event, entry.text));
+        }
+
+        // the binary log writer records entries one by one instead of in batches
+        void record(const log_entry& entry)
+        {
+            if (entry.formatted)
+            {
+                binary_writer->write(entry.text);
+            }
+            else
+            {
+                binary_writer->write_event(entry.level, entry.event, entry.connection_id, to_datetime(entry.timestamp), entry.text);
+            }
+        }
+
+        void run()
+        {
+            utility::string_t batch;
+            log_entry entry;
+
+            for (;;)
+            {
+                batch.clear();
+                size_t batch_size = 0;
+                while (batch_size < max_batch_size && try_dequeue(entry))
+                {
+                    if (binary_writer)
+                    {
+                        try
+                        {
+                            record(entry);
+                        }
+                        catch (...)
+                        {
+                            // there is no one to report the error to
+                        }
+                    }
+                    else
+                    {
+                        batch.append(entry.formatted ? entry.text : format(entry));
+                    }
+
+                    batch_size++;
+                }
+
+                auto dropped = dropped_entries.load();
+                if (dropped != reported_dropped_entries)
+                {
+                    batch.append(logger::format_entry(trace_level::errors, utility::datetime::utc_now(),
+                        utility::conversions::to_string_t(std::to_string(dropped - reported_dropped_entries))
+                        .append(_XPLATSTR(" log entries dropped because the log buffer was full"))));
+                    reported_dropped_entries = dropped;
+                }
+
+                if (!batch.empty())
+                {
+                    try
+                    {
+                        writer->write(batch);
+                    }
+                    catch (...)
+                    {
+                        // there is no one to report the error to
+                    }
+                }
+
+                std::unique_lock<std::mutex> guard(lock);
+                if (batch_size > 0)
+                {
+                    written_position.store(dequeue_position);
+                    entries_written.notify_all();
+                    continue;
+                }
+
+                if (stop_requested)
+                {
+                    return;
+                }
+
+                consumer_waiting.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                // an entry may have been queued before the flag was set in which case its producer did not notify
+                auto& next = cells[dequeue_position & mask];
+                if (next.sequence.load(std::memory_order_acquire) != dequeue_position + 1)
+                {
+                    entries_available.wait_for(guard, idle_wait_time);
+                }
+                consumer_waiting.store(false);
+            }
+        }
+    };
+
+    async_log_writer::async_log_writer(const std::shared_ptr<log_writer>& log_writer, size_t capacity, log_overflow_policy overflow_policy)
+        : m_state(std::make_shared<state>(log_writer, capacity, overflow_policy))
+    {
+        auto state = m_state;
+        m_thread = std::thread([state]() { state->run(); });
+    }
+
+    async_log_writer::~async_log_writer()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->lock);
+            m_state->stop_requested = true;
+            m_state->entries_available.notify_one();
+        }
+
+        // the background thread writes all the queued entries before it exits
+        m_thread.join();
+    }
+
+    void async_log_writer::write(const utility::string_t &entry)
+    {
+        log_entry queued_entry = { true, trace_level::none, log_event::text, std::chrono::steady_clock::time_point(),
+            utility::string_t(), entry };
+        m_state->enqueue(queued_entry);
+    }
+
+    void async_log_writer::enqueue(trace_level level, log_event event, const utility::string_t& connection_id,
+        std::chrono::steady_clock::time_point timestamp, const utility::string_t& payload)
+    {
+        log_entry queued_entry = { false, level, event, timestamp,
+            m_state->binary_writer ? connection_id : utility::string_t(), payload };
+        m_state->enqueue(queued_entry);
+    }
+
+    void async_log_writer::flush()
+    {
+        auto position = m_state->enqueue_position.load();
+
+        m_state->wake_consumer();
+
+        std::unique_lock<std::mutex> lock(m_state->lock);
+        while (m_state->written_position.load() < position)
+        {
+            m_state->entries_written.wait_for(lock, idle_wait_time);
+        }
+    }
+
+    uint64_t async_log_writer::get_dropped_entry_count() const
+    {
+        return m_state->dropped_entries.load();
+    }
+}
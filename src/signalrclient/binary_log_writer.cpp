@@ -0,0 +1,431 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "signalrclient/binary_log_writer.h"
+#include "signalrclient/signalr_exception.h"
+#include "logger.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File format (all integers are unsigned LEB128 varints unless noted otherwise):
+//   header: "SRBL" followed by the format version (1 byte) and 3 reserved bytes
+//   connection id record: type (1 byte, 1), connection index, length, UTF-8 connection id
+//   event record: type (1 byte, 2), trace level (1 byte, 0 for entries written as is), event code, connection index
+//     (0 if none), zigzag encoded delta of the timestamp (100ns ticks) from the previous event record, length,
+//     UTF-8 payload
+// The unused part of the file is zeroed so a record type of 0 marks the end of the log.
+namespace signalr
+{
+    namespace
+    {
+        const char file_magic[] = { 'S', 'R', 'B', 'L' };
+        const uint8_t format_version = 1;
+        const size_t file_header_size = 8;
+
+        const uint8_t connection_id_record = 1;
+        const uint8_t event_record = 2;
+
+        void append_varint(std::vector<uint8_t>& buffer, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                buffer.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+
+            buffer.push_back(static_cast<uint8_t>(value));
+        }
+
+        void append_string(std::vector<uint8_t>& buffer, const std::string& value)
+        {
+            append_varint(buffer, value.size());
+            buffer.insert(buffer.end(), value.begin(), value.end());
+        }
+
+#if defined(_UTF16_STRINGS)
+        std::string to_utf8(const utility::string_t& value)
+        {
+            return utility::conversions::to_utf8string(value);
+        }
+#else
+        // strings are already UTF-8 so payloads are copied to the file as they are
+        const std::string& to_utf8(const utility::string_t& value)
+        {
+            return value;
+        }
+#endif
+
+        bool read_varint(const uint8_t*& position, const uint8_t* end, uint64_t& value)
+        {
+            value = 0;
+            for (auto shift = 0; shift < 64 && position < end; shift += 7)
+            {
+                auto byte = *position++;
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        bool read_string(const uint8_t*& position, const uint8_t* end, std::string& value)
+        {
+            uint64_t length;
+            if (!read_varint(position, end, length) || length > static_cast<uint64_t>(end - position))
+            {
+                return false;
+            }
+
+            value.assign(reinterpret_cast<const char*>(position), static_cast<size_t>(length));
+            position += length;
+            return true;
+        }
+
+        bool is_valid_trace_level(uint64_t level)
+        {
+            return level == 0 || (level <= static_cast<uint64_t>(trace_level::all) && (level & (level - 1)) == 0);
+        }
+
+        // the file mapping - the only platform specific part
+        class mapped_file
+        {
+        public:
+            mapped_file(const utility::string_t& file_path, size_t size)
+                : m_view(nullptr), m_size(size), m_used_size(0)
+            {
+#ifdef _WIN32
+                m_file = CreateFileW(file_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                    CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (m_file == INVALID_HANDLE_VALUE)
+                {
+                    throw signalr_exception(_XPLATSTR("could not create the log file: ") + file_path);
+                }
+
+                ULARGE_INTEGER file_size;
+                file_size.QuadPart = size;
+                m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE, file_size.HighPart, file_size.LowPart, nullptr);
+                if (m_mapping != nullptr)
+                {
+                    m_view = MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, size);
+                }
+
+                if (m_view == nullptr)
+                {
+                    if (m_mapping != nullptr)
+                    {
+                        CloseHandle(m_mapping);
+                    }
+
+                    CloseHandle(m_file);
+                    throw signalr_exception(_XPLATSTR("could not map the log file: ") + file_path);
+                }
+#else
+                m_file = open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+                if (m_file == -1)
+                {
+                    throw signalr_exception(_XPLATSTR("could not create the log file: ") + file_path);
+                }
+
+                if (ftruncate(m_file, static_cast<off_t>(size)) == 0)
+                {
+                    m_view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+                    if (m_view == MAP_FAILED)
+                    {
+                        m_view = nullptr;
+                    }
+                }
+
+                if (m_view == nullptr)
+                {
+                    close(m_file);
+                    throw signalr_exception(_XPLATSTR("could not map the log file: ") + file_path);
+                }
+#endif
+            }
+
+            mapped_file(const mapped_file&) = delete;
+
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            uint8_t* data() const
+            {
+                return static_cast<uint8_t*>(m_view);
+            }
+
+            size_t size() const
+            {
+                return m_size;
+            }
+
+            // unmaps the file and trims it to `used_size` bytes
+            ~mapped_file()
+            {
+#ifdef _WIN32
+                UnmapViewOfFile(m_view);
+                CloseHandle(m_mapping);
+
+                LARGE_INTEGER file_size;
+                file_size.QuadPart = m_used_size;
+                if (SetFilePointerEx(m_file, file_size, nullptr, FILE_BEGIN))
+                {
+                    SetEndOfFile(m_file);
+                }
+
+                CloseHandle(m_file);
+#else
+                munmap(m_view, m_size);
+                if (ftruncate(m_file, static_cast<off_t>(m_used_size)) != 0)
+                {
+                    // the file keeps the zeroed tail which the decoder skips
+                }
+
+                close(m_file);
+#endif
+            }
+
+            void set_used_size(size_t used_size)
+            {
+                m_used_size = used_size;
+            }
+
+        private:
+#ifdef _WIN32
+            HANDLE m_file;
+            HANDLE m_mapping;
+#else
+            int m_file;
+#endif
+            void* m_view;
+            size_t m_size;
+            size_t m_used_size;
+        };
+    }
+
+    struct binary_log_writer::state
+    {
+        mapped_file file;
+
+        std::mutex lock;
+        size_t write_position;
+        bool full;
+        uint64_t dropped_entries;
+        std::unordered_map<utility::string_t, uint64_t> connection_indexes;
+        uint64_t previous_timestamp;
+        // reused to encode the records up to the payload which is copied to the file directly
+        std::vector<uint8_t> buffer;
+
+        state(const utility::string_t& file_path, size_t max_file_size)
+            : file(file_path, std::max(max_file_size, file_header_size + 1)), write_position(file_header_size), full(false),
+            dropped_entries(0), previous_timestamp(0)
+        {
+            auto data = file.data();
+            std::memcpy(data, file_magic, sizeof(file_magic));
+            data[sizeof(file_magic)] = format_version;
+            file.set_used_size(write_position);
+
+            buffer.reserve(64);
+        }
+
+        void append(trace_level level, log_event event, const utility::string_t& connection_id,
+            const utility::datetime& timestamp, const utility::string_t& payload)
+        {
+            const auto& utf8_payload = to_utf8(payload);
+
+            std::lock_guard<std::mutex> guard(lock);
+
+            if (full)
+            {
+                dropped_entries++;
+                return;
+            }
+
+            buffer.clear();
+
+            uint64_t connection_index = 0;
+            auto new_connection_id = false;
+            if (!connection_id.empty())
+            {
+                auto iter = connection_indexes.find(connection_id);
+                if (iter == connection_indexes.end())
+                {
+                    connection_index = connection_indexes.size() + 1;
+                    new_connection_id = true;
+
+                    buffer.push_back(connection_id_record);
+                    append_varint(buffer, connection_index);
+                    append_string(buffer, utility::conversions::to_utf8string(connection_id));
+                }
+                else
+                {
+                    connection_index = iter->second;
+                }
+            }
+
+            auto ticks = timestamp.to_interval();
+            auto delta = static_cast<int64_t>(ticks - previous_timestamp);
+
+            buffer.push_back(event_record);
+            buffer.push_back(static_cast<uint8_t>(level));
+            append_varint(buffer, static_cast<uint64_t>(event));
+            append_varint(buffer, connection_index);
+            append_varint(buffer, (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+            append_varint(buffer, utf8_payload.size());
+
+            // the zero after the last record marks the end of the log so the file is never filled completely
+            auto records_size = buffer.size() + utf8_payload.size();
+            if (records_size >= file.size() - write_position)
+            {
+                // later (smaller) entries are dropped as well to keep the log free of gaps
+                full = true;
+                dropped_entries++;
+                return;
+            }
+
+            if (new_connection_id)
+            {
+                connection_indexes.insert(std::make_pair(connection_id, connection_index));
+            }
+
+            previous_timestamp = ticks;
+
+            // the type of the first record is written last so that the decoder never sees half written records if
+            // the process crashes
+            auto target = file.data() + write_position;
+            std::memcpy(target + 1, buffer.data() + 1, buffer.size() - 1);
+            std::memcpy(target + buffer.size(), utf8_payload.data(), utf8_payload.size());
+            std::atomic_signal_fence(std::memory_order_release);
+            target[0] = buffer[0];
+
+            write_position += records_size;
+            file.set_used_size(write_position);
+        }
+    };
+
+    binary_log_writer::binary_log_writer(const utility::string_t& file_path, size_t max_file_size)
+        : m_state(new state(file_path, max_file_size))
+    { }
+
+    binary_log_writer::~binary_log_writer()
+    { }
+
+    void binary_log_writer::write(const utility::string_t &entry)
+    {
+        m_state->append(trace_level::none, log_event::text, utility::string_t(), utility::datetime::utc_now(), entry);
+    }
+
+    void binary_log_writer::write_event(trace_level level, log_event event, const utility::string_t& connection_id,
+        const utility::datetime& timestamp, const utility::string_t& payload)
+    {
+        m_state->append(level, event, connection_id, timestamp, payload);
+    }
+
+    uint64_t binary_log_writer::get_dropped_entry_count() const
+    {
+        std::lock_guard<std::mutex> guard(m_state->lock);
+        return m_state->dropped_entries;
+    }
+
+    void binary_log_writer::decode(const utility::string_t& file_path, log_writer& output)
+    {
+        std::ifstream stream(file_path, std::ios::in | std::ios::binary);
+        if (!stream)
+        {
+            throw signalr_exception(_XPLATSTR("could not open the log file: ") + file_path);
+        }
+
+        std::vector<uint8_t> contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+        if (contents.size() < file_header_size || std::memcmp(contents.data(), file_magic, sizeof(file_magic)) != 0)
+        {
+            throw signalr_exception(_XPLATSTR("not a binary log file: ") + file_path);
+        }
+
+        if (contents[sizeof(file_magic)] != format_version)
+        {
+            throw signalr_exception(_XPLATSTR("unsupported binary log format version: ")
+                + utility::conversions::to_string_t(std::to_string(contents[sizeof(file_magic)])));
+        }
+
+        std::unordered_map<uint64_t, utility::string_t> connection_ids;
+        uint64_t timestamp = 0;
+
+        const uint8_t* position = contents.data() + file_header_size;
+        const uint8_t* end = contents.data() + contents.size();
+        while (position < end)
+        {
+            auto record_type = *position++;
+            if (record_type == connection_id_record)
+            {
+                uint64_t index;
+                std::string connection_id;
+                if (!read_varint(position, end, index) || !read_string(position, end, connection_id))
+                {
+                    return;
+                }
+
+                connection_ids[index] = utility::conversions::to_string_t(connection_id);
+            }
+            else if (record_type == event_record)
+            {
+                if (position == end || !is_valid_trace_level(*position))
+                {
+                    return;
+                }
+
+                auto level = *position++;
+                uint64_t event, connection_index, delta;
+                std::string payload;
+                if (!read_varint(position, end, event) || !read_varint(position, end, connection_index)
+                    || !read_varint(position, end, delta) || !read_string(position, end, payload))
+                {
+                    return;
+                }
+
+                timestamp += static_cast<uint64_t>(static_cast<int64_t>(delta >> 1) ^ -static_cast<int64_t>(delta & 1));
+
+                auto entry = utility::conversions::to_string_t(payload);
+                if (level == 0)
+                {
+                    // written as is
+                    output.write(entry);
+                    continue;
+                }
+
+                if (event != static_cast<uint64_t>(log_event::text))
+                {
+                    entry = logger::format_event(static_cast<log_event>(event), entry);
+                }
+
+                auto connection_id = connection_ids.find(connection_index);
+                if (connection_id != connection_ids.end())
+                {
+                    entry = utility::string_t(_XPLATSTR("[")).append(connection_id->second).append(_XPLATSTR("] ")).append(entry);
+                }
+
+                output.write(logger::format_entry(static_cast<trace_level>(level), utility::datetime() + timestamp, entry));
+            }
+            else
+            {
+                // the end of the log (or a record written by a newer version)
+                return;
+            }
+        }
+    }
+}
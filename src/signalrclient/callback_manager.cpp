@@ -9,7 +9,7 @@ namespace signalr
     // dtor_clear_arguments will be passed when closing any pending callbacks when the `callback_manager` is
     // destroyed (i.e. in the dtor)
     callback_manager::callback_manager(const web::json::value& dtor_clear_arguments)
-        : m_dtor_clear_arguments(dtor_clear_arguments)
+        : m_callbacks(tracking_allocator<callback_entry>(nullptr, &m_allocation_counters)), m_dtor_clear_arguments(dtor_clear_arguments)
     { }
 
     callback_manager::~callback_manager()
@@ -81,6 +81,42 @@ namespace signalr
         }
     }
 
+    size_t callback_manager::get_callback_count() const
+    {
+        std::lock_guard<std::mutex> lock(m_map_lock);
+        return m_callbacks.size();
+    }
+
+    void callback_manager::set_memory_allocator(const std::shared_ptr<memory_allocator>& allocator)
+    {
+        std::lock_guard<std::mutex> lock(m_map_lock);
+
+        if (m_memory_allocator == allocator)
+        {
+            return;
+        }
+
+        // the memory of the existing entries has to be returned to the allocator it was taken from so the previous
+        // allocator is kept alive until the previous map has been destroyed
+        auto previous_allocator = m_memory_allocator;
+        m_memory_allocator = allocator;
+
+        {
+            callback_map callbacks(tracking_allocator<callback_entry>(allocator.get(), &m_allocation_counters));
+            for (auto& kvp : m_callbacks)
+            {
+                callbacks.insert(std::make_pair(kvp.first, std::move(kvp.second)));
+            }
+
+            m_callbacks.swap(callbacks);
+        }
+    }
+
+    const allocation_counters& callback_manager::get_allocation_counters() const
+    {
+        return m_allocation_counters;
+    }
+
     utility::string_t callback_manager::get_callback_id()
     {
         auto callback_id = m_id++;
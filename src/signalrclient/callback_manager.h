@@ -8,6 +8,7 @@
 #include <functional>
 #include <mutex>
 #include "cpprest/json.h"
+#include "tracking_allocator.h"
 
 namespace signalr
 {
@@ -24,11 +25,22 @@ namespace signalr
         bool invoke_callback(const utility::string_t& callback_id, const web::json::value& arguments, bool remove_callback);
         bool remove_callback(const utility::string_t& callback_id);
         void clear(const web::json::value& arguments);
+        size_t get_callback_count() const;
+        // must not be called while callbacks are being registered
+        void set_memory_allocator(const std::shared_ptr<memory_allocator>& allocator);
+        const allocation_counters& get_allocation_counters() const;
 
     private:
+        typedef std::pair<const utility::string_t, std::function<void(const web::json::value&)>> callback_entry;
+        typedef std::unordered_map<utility::string_t, std::function<void(const web::json::value&)>, std::hash<utility::string_t>,
+            std::equal_to<utility::string_t>, tracking_allocator<callback_entry>> callback_map;
+
         std::atomic<int> m_id { 0 };
-        std::unordered_map<utility::string_t, std::function<void(const web::json::value&)>> m_callbacks;
-        std::mutex m_map_lock;
+        // both must outlive the callbacks which refer to them through their allocator
+        allocation_counters m_allocation_counters;
+        std::shared_ptr<memory_allocator> m_memory_allocator;
+        callback_map m_callbacks;
+        mutable std::mutex m_map_lock;
         const web::json::value m_dtor_clear_arguments;
 
         utility::string_t get_callback_id();
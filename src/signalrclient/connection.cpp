@@ -16,6 +16,11 @@ namespace signalr
     // undefinded behavior since we are using an incomplete type. More details here:  http://herbsutter.com/gotw/_100/
     connection::~connection() = default;
 
+    pplx::task<void> connection::prepare()
+    {
+        return m_pImpl->prepare();
+    }
+
     pplx::task<void> connection::start()
     {
         return m_pImpl->start();
@@ -51,6 +56,46 @@ namespace signalr
         m_pImpl->set_client_config(config);
     }
 
+    void connection::set_reconnect_policy(const std::shared_ptr<reconnect_policy>& reconnect_policy)
+    {
+        m_pImpl->set_reconnect_policy(reconnect_policy);
+    }
+
+    reconnect_statistics connection::get_reconnect_statistics() const
+    {
+        return m_pImpl->get_reconnect_statistics();
+    }
+
+    connection_statistics connection::get_statistics() const
+    {
+        return m_pImpl->get_statistics();
+    }
+
+    void connection::set_failover_urls(const std::vector<utility::string_t>& failover_urls)
+    {
+        m_pImpl->set_failover_urls(failover_urls);
+    }
+
+    void connection::set_hot_standby(bool hot_standby)
+    {
+        m_pImpl->set_hot_standby(hot_standby);
+    }
+
+    void connection::set_fast_restart(int max_negotiation_age)
+    {
+        m_pImpl->set_fast_restart(max_negotiation_age);
+    }
+
+    void connection::set_speculative_connect(bool speculative_connect)
+    {
+        m_pImpl->set_speculative_connect(speculative_connect);
+    }
+
+    void connection::set_reconnect_outbox(size_t max_messages, size_t max_bytes)
+    {
+        m_pImpl->set_reconnect_outbox(max_messages, max_bytes);
+    }
+
     pplx::task<void> connection::stop()
     {
         return m_pImpl->stop();
@@ -11,6 +11,7 @@
 #include "url_builder.h"
 #include "trace_log_writer.h"
 #include "make_unique.h"
+#include "trace_probes.h"
 #include "signalrclient/signalr_exception.h"
 
 namespace signalr
@@ -20,6 +21,58 @@ namespace signalr
     {
         // this is a workaround for a compiler bug where mutable lambdas won't sometimes compile
         static void log(const logger& logger, trace_level level, const utility::string_t& entry);
+
+        // runs the work on the event loop if one was configured or on the current thread otherwise
+        static void dispatch(const std::shared_ptr<event_loop>& event_loop, const std::function<void()>& work);
+
+        // the maximum number of responses a standby connection keeps for the primary connection - the oldest responses are
+        // dropped if the standby connection receives messages the primary connection does not acknowledge
+        static const size_t max_pending_standby_responses = 1000;
+
+        // asks the reconnect policy for the delay before the next reconnect attempt. Returns `false` (and logs why) if the
+        // connection should stop reconnecting.
+        static bool next_reconnect_delay(const std::shared_ptr<reconnect_policy>& reconnect_policy, const reconnect_context& context,
+            const logger& logger, std::chrono::milliseconds& delay);
+
+        // completes after the delay using the timer queue if one was configured or a sleeping thread pool thread otherwise
+        static pplx::task<void> delay(const std::shared_ptr<timer_queue>& timer_queue, std::chrono::milliseconds delay);
+
+        // an attempt that has to be admitted by the admission controller set in the config before it starts. Attempts
+        // are admitted right away if there is no admission controller. `release` is a no-op if the attempt has not
+        // been admitted (e.g. because waiting was cancelled) or has already been released.
+        class admission
+        {
+        public:
+            admission(const signalr_client_config& config, admission_priority priority)
+                : m_admission_controller(config.get_admission_controller()), m_priority(priority),
+                m_admitted(std::make_shared<std::atomic<bool>>(false))
+            { }
+
+            pplx::task<void> acquire(const pplx::cancellation_token& cancellation_token) const
+            {
+                if (!m_admission_controller)
+                {
+                    return pplx::task_from_result();
+                }
+
+                auto admitted = m_admitted;
+                return m_admission_controller->acquire(m_priority, cancellation_token)
+                    .then([admitted]() { *admitted = true; });
+            }
+
+            void release() const
+            {
+                if (m_admitted->exchange(false))
+                {
+                    m_admission_controller->release();
+                }
+            }
+
+        private:
+            std::shared_ptr<admission_controller> m_admission_controller;
+            admission_priority m_priority;
+            std::shared_ptr<std::atomic<bool>> m_admitted;
+        };
     }
 
     std::shared_ptr<connection_impl> connection_impl::create(const utility::string_t& url, const utility::string_t& query_string,
@@ -37,11 +90,24 @@ namespace signalr
 
     connection_impl::connection_impl(const utility::string_t& url, const utility::string_t& query_string, trace_level trace_level, const std::shared_ptr<log_writer>& log_writer,
         std::unique_ptr<web_request_factory> web_request_factory, std::unique_ptr<transport_factory> transport_factory)
-        : m_base_url(url), m_query_string(query_string), m_connection_state(connection_state::disconnected), m_reconnect_delay(2000),
+        : m_base_url(url), m_endpoint_selector(std::make_shared<endpoint_selector>(url)), m_dns_cache(dns_cache::get_default()), m_query_string(query_string), m_connection_state(connection_state::disconnected),
+        m_reconnect_policy(std::make_shared<fixed_delay_reconnect_policy>(std::chrono::milliseconds(2000))), m_reconnects(0),
+        m_successful_reconnects(0), m_failed_reconnects(0), m_reconnect_attempts(0), m_current_reconnect_attempts(0),
+        m_last_reconnect_attempts(0), m_last_reconnect_duration(0), m_keep_alive_watchdog(keep_alive_watchdog::get_default()),
+        m_reconnect_window(0), m_keep_alive_timeout(-1), m_keep_alive_watch_id(0), m_keep_alive_timeouts(0), m_last_keep_alive_detection_time(0),
         m_logger(log_writer, trace_level), m_transport(nullptr), m_web_request_factory(std::move(web_request_factory)),
         m_transport_factory(std::move(transport_factory)), m_message_received([](const web::json::value&){}),
-        m_reconnecting([](){}), m_reconnected([](){}), m_disconnected([](){})
-    { }
+        m_reconnecting([](){}), m_reconnected([](){}), m_disconnected([](){}), m_hot_standby(false), m_standby_starting(false),
+        m_stray_message_log_limiter(std::make_shared<log_limiter>()), m_outbox(tracking_allocator<outbox_entry>(nullptr, &m_outbox_allocation_counters)), m_outbox_bytes(0), m_outbox_max_messages(0), m_outbox_max_bytes(0), m_outbox_flushing(false),
+        m_fast_restart_max_negotiation_age(0), m_speculative_connect(false), m_first_message_pending(false),
+        m_frames_received(0), m_bytes_received(0), m_frames_parsed(0), m_parse_errors(0), m_messages_received(0),
+        m_messages_sent(0), m_bytes_sent(0), m_state_changed_time(std::chrono::steady_clock::now().time_since_epoch().count())
+    {
+        for (auto& time_in_state : m_time_in_state)
+        {
+            time_in_state.store(0, std::memory_order_relaxed);
+        }
+    }
 
     connection_impl::~connection_impl()
     {
@@ -69,8 +135,19 @@ namespace signalr
         catch (...) // must not throw from destructors
         { }
 
-        m_transport = nullptr;
+        set_transport(nullptr);
         change_state(connection_state::disconnected);
+
+        auto metrics_sink = m_signalr_client_config.get_metrics_sink();
+        if (metrics_sink && m_metrics_source)
+        {
+            try
+            {
+                metrics_sink->remove_source(m_metrics_source);
+            }
+            catch (...) // must not throw from destructors
+            { }
+        }
     }
 
     pplx::task<void> connection_impl::start()
@@ -84,52 +161,78 @@ namespace signalr
             }
 
             // there should not be any active transport at this point
-            _ASSERTE(!m_transport);
+            _ASSERTE(!get_transport());
 
             m_disconnect_cts = pplx::cancellation_token_source();
             m_start_completed_event.reset();
-            m_message_id = m_groups_token = m_connection_id = m_connection_token = _XPLATSTR("");
+            m_start_time = std::chrono::steady_clock::now();
+            m_first_message_pending = true;
+            m_message_id = m_groups_token = _XPLATSTR("");
+
+            std::lock_guard<std::mutex> connection_info_lock(m_connection_info_lock);
+            m_connection_id = m_connection_token = _XPLATSTR("");
         }
 
         pplx::task_completion_event<void> start_tce;
 
         auto connection = shared_from_this();
+        auto start_admission = admission(m_signalr_client_config, m_signalr_client_config.get_admission_priority());
+        auto disconnect_token = m_disconnect_cts.get_token();
 
         pplx::task_from_result()
-            .then([connection]()
+            .then([start_admission, disconnect_token]()
             {
-                return request_sender::negotiate(*connection->m_web_request_factory, connection->m_base_url,
-                    connection->m_connection_data, connection->m_query_string,
-                    connection->m_signalr_client_config);
+                return start_admission.acquire(disconnect_token);
             }, m_disconnect_cts.get_token())
-            .then([connection](negotiation_response negotiation_response)
+            .then([connection]()
             {
-                if (negotiation_response.protocol_version != PROTOCOL)
+                auto previous_negotiation = connection->get_previous_negotiation();
+                if (!previous_negotiation)
                 {
-                    return pplx::task_from_exception<void>(
-                        signalr_exception(_XPLATSTR("incompatible protocol version. client protocol version: ") \
-                            PROTOCOL _XPLATSTR(", server protocol version: ") + negotiation_response.protocol_version));
+                    return connection->negotiate_and_start();
                 }
 
-                connection->m_connection_id = negotiation_response.connection_id;
-                connection->m_connection_token = negotiation_response.connection_token;
-                connection->m_reconnect_window =
-                    negotiation_response.disconnect_timeout + std::max(negotiation_response.keep_alive_timeout, 0);
-
-                return connection->start_transport(negotiation_response)
-                    .then([connection, negotiation_response](std::shared_ptr<transport> transport)
+                return connection->fast_restart(*previous_negotiation)
+                    .then([connection](pplx::task<void> fast_restart_task)
                     {
-                        connection->m_transport = transport;
+                        try
+                        {
+                            fast_restart_task.get();
+                            return pplx::task_from_result();
+                        }
+                        catch (const std::exception& e)
+                        {
+                            if (connection->m_disconnect_cts.get_token().is_canceled())
+                            {
+                                throw;
+                            }
+
+                            connection->m_logger.log(trace_level::info,
+                                utility::string_t(_XPLATSTR("restarting using the previous negotiation failed due to: "))
+                                .append(utility::conversions::to_string_t(e.what()))
+                                .append(_XPLATSTR(". negotiating a new connection")));
+                        }
+
+                        // the server rejected the previous connection token - the transport (if it connected) is no longer needed
+                        connection->m_previous_negotiation = nullptr;
+                        auto transport = connection->get_transport();
+                        if (transport)
+                        {
+                            transport->disconnect().then([](pplx::task<void> disconnect_task)
+                            {
+                                try { disconnect_task.get(); } catch (...) {}
+                            });
+
+                            connection->set_transport(nullptr);
+                        }
+
+                        return connection->negotiate_and_start();
                     });
             }, m_disconnect_cts.get_token())
-            .then([connection]()
-            {
-                return request_sender::start(*connection->m_web_request_factory, connection->m_base_url,
-                    connection->m_transport->get_transport_type(), connection->m_connection_token,
-                    connection->m_connection_data, connection->m_query_string, connection->m_signalr_client_config);
-            }, m_disconnect_cts.get_token())
-            .then([start_tce, connection](pplx::task<void> previous_task)
+            .then([start_tce, connection, start_admission](pplx::task<void> previous_task)
             {
+                start_admission.release();
+
                 try
                 {
                     previous_task.get();
@@ -144,6 +247,9 @@ namespace signalr
 
                     connection->m_start_completed_event.set();
                     start_tce.set();
+
+                    connection->start_keep_alive_watch();
+                    connection->start_standby();
                 }
                 catch (const std::exception &e)
                 {
@@ -160,7 +266,7 @@ namespace signalr
                             .append(utility::conversions::to_string_t(e.what())));
                     }
 
-                    connection->m_transport = nullptr;
+                    connection->set_transport(nullptr);
                     connection->change_state(connection_state::disconnected);
                     connection->m_start_completed_event.set();
                     start_tce.set_exception(std::current_exception());
@@ -170,7 +276,158 @@ namespace signalr
         return pplx::create_task(start_tce);
     }
 
-    pplx::task<std::shared_ptr<transport>> connection_impl::start_transport(negotiation_response negotiation_response)
+    pplx::task<void> connection_impl::negotiate_and_start()
+    {
+        auto connection = shared_from_this();
+
+        return pplx::task_from_result()
+            .then([connection]()
+            {
+                return connection->probe_endpoints();
+            }, m_disconnect_cts.get_token())
+            .then([connection]()
+            {
+                connection->quarantine_unresolvable_endpoints();
+
+                auto base_url = connection->m_endpoint_selector->select();
+                connection->set_base_url(base_url);
+
+                // the websocket client is created while the negotiate request is in flight instead of afterwards
+                if (connection->m_speculative_connect)
+                {
+                    connection->m_transport_factory->prepare_transport(transport_type::websockets, connection->m_signalr_client_config);
+                }
+
+                auto endpoint_selector = connection->m_endpoint_selector;
+                auto negotiate_started = std::chrono::steady_clock::now();
+
+                return request_sender::negotiate(*connection->m_web_request_factory, base_url,
+                    connection->m_connection_data, connection->m_query_string,
+                    connection->m_signalr_client_config)
+                    .then([endpoint_selector, base_url, negotiate_started](pplx::task<negotiation_response> negotiate_task)
+                    {
+                        try
+                        {
+                            auto negotiation_response = negotiate_task.get();
+                            endpoint_selector->record_success(base_url,
+                                std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - negotiate_started));
+                            return negotiation_response;
+                        }
+                        catch (...)
+                        {
+                            endpoint_selector->record_failure(base_url);
+                            throw;
+                        }
+                    });
+            }, m_disconnect_cts.get_token())
+            .then([connection](negotiation_response negotiation_response)
+            {
+                if (negotiation_response.protocol_version != PROTOCOL)
+                {
+                    return pplx::task_from_exception<void>(
+                        signalr_exception(_XPLATSTR("incompatible protocol version. client protocol version: ") \
+                            PROTOCOL _XPLATSTR(", server protocol version: ") + negotiation_response.protocol_version));
+                }
+
+                connection->set_negotiation_response(negotiation_response);
+
+                auto previous_negotiation = std::make_shared<connection_impl::previous_negotiation>();
+                previous_negotiation->response = negotiation_response;
+                previous_negotiation->base_url = connection->get_base_url();
+                previous_negotiation->connection_data = connection->m_connection_data;
+                previous_negotiation->negotiated = std::chrono::steady_clock::now();
+                connection->m_previous_negotiation = previous_negotiation;
+
+                return connection->start_transport(negotiation_response, connection->get_base_url())
+                    .then([connection, negotiation_response](std::shared_ptr<transport> transport)
+                    {
+                        connection->set_transport(transport);
+                    });
+            }, m_disconnect_cts.get_token())
+            .then([connection]()
+            {
+                return request_sender::start(*connection->m_web_request_factory, connection->get_base_url(),
+                    connection->get_transport()->get_transport_type(), connection->m_connection_token,
+                    connection->m_connection_data, connection->m_query_string, connection->m_signalr_client_config);
+            }, m_disconnect_cts.get_token());
+    }
+
+    // connects using the connection token of the previous negotiation which saves the negotiate round trip. The start
+    // request is sent as soon as the transport has connected instead of after the init message has been received.
+    pplx::task<void> connection_impl::fast_restart(const previous_negotiation& previous_negotiation)
+    {
+        m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("restarting using the previous negotiation. connection id: "))
+            .append(previous_negotiation.response.connection_id));
+
+        set_base_url(previous_negotiation.base_url);
+        set_negotiation_response(previous_negotiation.response);
+
+        auto connection = shared_from_this();
+        auto base_url = previous_negotiation.base_url;
+        pplx::task_completion_event<void> transport_connected;
+
+        auto start_request = pplx::create_task(transport_connected)
+            .then([connection, base_url]()
+            {
+                return request_sender::start(*connection->m_web_request_factory, base_url, transport_type::websockets,
+                    connection->m_connection_token, connection->m_connection_data, connection->m_query_string,
+                    connection->m_signalr_client_config);
+            });
+
+        return start_transport(previous_negotiation.response, base_url, nullptr, transport_connected)
+            .then([connection, start_request](pplx::task<std::shared_ptr<transport>> transport_task)
+            {
+                try
+                {
+                    connection->set_transport(transport_task.get());
+                }
+                catch (...)
+                {
+                    // the start request may have been sent if the transport connected but failed afterwards
+                    start_request.then([](pplx::task<void> start_task)
+                    {
+                        try { start_task.get(); } catch (...) {}
+                    });
+
+                    throw;
+                }
+
+                return start_request;
+            });
+    }
+
+    // returns the previous negotiation if it can be used to restart the connection or nullptr otherwise
+    std::shared_ptr<connection_impl::previous_negotiation> connection_impl::get_previous_negotiation() const
+    {
+        if (m_fast_restart_max_negotiation_age <= 0 || !m_previous_negotiation)
+        {
+            return nullptr;
+        }
+
+        auto negotiation_age = std::chrono::steady_clock::now() - m_previous_negotiation->negotiated;
+        if (negotiation_age > std::chrono::milliseconds(m_fast_restart_max_negotiation_age) ||
+            m_previous_negotiation->connection_data != m_connection_data ||
+            m_endpoint_selector->is_quarantined(m_previous_negotiation->base_url))
+        {
+            return nullptr;
+        }
+
+        return m_previous_negotiation;
+    }
+
+    void connection_impl::set_negotiation_response(const negotiation_response& negotiation_response)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_connection_info_lock);
+            m_connection_id = negotiation_response.connection_id;
+            m_connection_token = negotiation_response.connection_token;
+        }
+        m_reconnect_window = negotiation_response.disconnect_timeout + std::max(negotiation_response.keep_alive_timeout, 0);
+        m_keep_alive_timeout = negotiation_response.keep_alive_timeout;
+    }
+
+    pplx::task<std::shared_ptr<transport>> connection_impl::start_transport(negotiation_response negotiation_response, const web::uri& base_url,
+        const std::shared_ptr<standby_state>& standby_state, const pplx::task_completion_event<void>& transport_connected)
     {
         if (!negotiation_response.try_websockets)
         {
@@ -185,32 +442,38 @@ namespace signalr
         auto weak_connection = std::weak_ptr<connection_impl>(connection);
         auto& disconnect_cts = m_disconnect_cts;
         auto& logger = m_logger;
+        auto event_loop = m_signalr_client_config.get_event_loop();
+        auto stray_message_log_limiter = m_stray_message_log_limiter;
+
+        auto context = std::make_shared<response_context>(weak_connection, connect_request_tce, disconnect_cts, logger,
+            stray_message_log_limiter);
 
-        auto process_response_callback =
-            [weak_connection, connect_request_tce, disconnect_cts, logger](const utility::string_t& response) mutable
+        auto process_response_callback = [context, event_loop, standby_state](utility::string_t response)
             {
-                // When a connection is stopped we don't wait for its transport to stop. As a result if the same connection
-                // is immediately re-started the old transport can still invoke this callback. To prevent this we capture
-                // the disconnect_cts by value which allows distinguishing if the message is for the running connection
-                // or for the one that was already stopped. If this is the latter we just ignore it.
-                if (disconnect_cts.get_token().is_canceled())
+                if (standby_state && process_standby_response(*standby_state, response, context->connect_request_tce))
                 {
-                    logger.log(trace_level::info,
-                        utility::string_t(_XPLATSTR("ignoring stray message received after connection was restarted. message: "))
-                        .append(response));
                     return;
                 }
 
-                auto connection = weak_connection.lock();
-                if (connection)
+                auto received = std::chrono::steady_clock::now();
+                if (!event_loop)
                 {
-                    connection->process_response(response, connect_request_tce);
+                    process_response(*context, response, received);
+                    return;
                 }
+
+                // the response is moved (and not copied) to the event loop
+                auto posted_response = std::make_shared<utility::string_t>(std::move(response));
+                event_loop->post([context, posted_response, received]()
+                {
+                    process_response(*context, *posted_response, received);
+                });
             };
 
 
         auto error_callback =
-            [weak_connection, connect_request_tce, disconnect_cts, logger](const std::exception &e) mutable
+            [weak_connection, connect_request_tce, disconnect_cts, logger, event_loop, standby_state, stray_message_log_limiter]
+            (const std::exception &e) mutable
             {
                 // When a connection is stopped we don't wait for its transport to stop. As a result if the same connection
                 // is immediately re-started the old transport can still invoke this callback. To prevent this we capture
@@ -218,30 +481,76 @@ namespace signalr
                 // or for the one that was already stopped. If this is the latter we just ignore it.
                 if (disconnect_cts.get_token().is_canceled())
                 {
-                    logger.log(trace_level::info,
-                        utility::string_t(_XPLATSTR("ignoring stray error received after connection was restarted. error: "))
-                        .append(utility::conversions::to_string_t(e.what())));
+                    uint64_t suppressed;
+                    if (logger.is_enabled(trace_level::info) && stray_message_log_limiter->try_acquire(suppressed))
+                    {
+                        logger.log(trace_level::info, log_limiter::append_suppressed(
+                            utility::string_t(_XPLATSTR("ignoring stray error received after connection was restarted. error: "))
+                            .append(utility::conversions::to_string_t(e.what())), suppressed));
+                    }
 
                     return;
                 }
 
-                // no op after connection started successfully
+                if (standby_state)
+                {
+                    bool active;
+                    {
+                        std::lock_guard<std::mutex> lock(standby_state->lock);
+                        active = standby_state->active;
+                    }
+
+                    if (!active)
+                    {
+                        logger.log(trace_level::info,
+                            utility::string_t(_XPLATSTR("standby connection lost due to: "))
+                            .append(utility::conversions::to_string_t(e.what())));
+
+                        connect_request_tce.set_exception(e);
+
+                        auto connection = weak_connection.lock();
+                        if (connection)
+                        {
+                            connection->discard_standby(standby_state);
+                        }
+
+                        return;
+                    }
+                }
+
+                // no op after connection started successfully. This is not dispatched to the event loop so that a pending
+                // start fails even if the loop is not being driven.
                 connect_request_tce.set_exception(e);
 
-                auto connection = weak_connection.lock();
-                if (connection)
+                // reconnecting is dispatched to the event loop (if any) after the messages that have already been
+                // received so that it does not run while a message is being processed
+                dispatch(event_loop, [weak_connection]()
                 {
-                    connection->reconnect();
-                }
+                    auto connection = weak_connection.lock();
+                    if (connection)
+                    {
+                        connection->reconnect();
+                    }
+                });
             };
 
         auto transport = connection->m_transport_factory->create_transport(
             transport_type::websockets, connection->m_logger, connection->m_signalr_client_config,
             process_response_callback, error_callback);
 
-        pplx::create_task([negotiation_response, connect_request_tce, disconnect_cts, weak_connection]()
+        delay(m_signalr_client_config.get_timer_queue(), std::chrono::milliseconds(negotiation_response.transport_connect_timeout))
+            .then([connect_request_tce, disconnect_cts](pplx::task<void> delay_task)
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(negotiation_response.transport_connect_timeout));
+            try
+            {
+                delay_task.get();
+            }
+            catch (const pplx::task_canceled&)
+            {
+                // the timer queue went away - the connect request can no longer time out
+                connect_request_tce.set_exception(signalr_exception(_XPLATSTR("transport connect timeout was cancelled")));
+                return;
+            }
 
             // if the disconnect_cts is cancelled it means that the connection has been stopped or went out of scope in
             // which case we should not throw due to timeout. Instead we need to set the tce prevent the task that is
@@ -257,23 +566,26 @@ namespace signalr
             }
         });
 
-        return connection->send_connect_request(transport, negotiation_response.connection_token, connect_request_tce)
+        return connection->send_connect_request(transport, base_url, negotiation_response.connection_token, connect_request_tce,
+            transport_connected)
             .then([transport](){ return pplx::task_from_result(transport); });
     }
 
-    pplx::task<void> connection_impl::send_connect_request(const std::shared_ptr<transport>& transport,
-        const utility::string_t& connection_token, const pplx::task_completion_event<void>& connect_request_tce)
+    pplx::task<void> connection_impl::send_connect_request(const std::shared_ptr<transport>& transport, const web::uri& base_url,
+        const utility::string_t& connection_token, const pplx::task_completion_event<void>& connect_request_tce,
+        const pplx::task_completion_event<void>& transport_connected)
     {
         auto logger = m_logger;
-        auto connect_url = url_builder::build_connect(m_base_url, transport->get_transport_type(),
+        auto connect_url = url_builder::build_connect(base_url, transport->get_transport_type(),
             connection_token, m_connection_data, m_query_string);
 
         transport->connect(connect_url)
-            .then([connect_request_tce, logger](pplx::task<void> connect_task)
+            .then([connect_request_tce, transport_connected, logger](pplx::task<void> connect_task)
             mutable {
                 try
                 {
                     connect_task.get();
+                    transport_connected.set();
                 }
                 catch (const std::exception& e)
                 {
@@ -282,6 +594,7 @@ namespace signalr
                         utility::string_t(_XPLATSTR("transport could not connect due to: "))
                             .append(utility::conversions::to_string_t(e.what())));
 
+                    transport_connected.set_exception(std::current_exception());
                     connect_request_tce.set_exception(std::current_exception());
                 }
             });
@@ -289,23 +602,73 @@ namespace signalr
         return pplx::create_task(connect_request_tce);
     }
 
-    void connection_impl::process_response(const utility::string_t& response, const pplx::task_completion_event<void>& connect_request_tce)
+    void connection_impl::process_response(const response_context& context, const utility::string_t& response,
+        std::chrono::steady_clock::time_point received)
+    {
+        // When a connection is stopped we don't wait for its transport to stop. As a result if the same connection
+        // is immediately re-started the old transport can still invoke this callback. To prevent this we capture
+        // the disconnect_cts by value which allows distinguishing if the message is for the running connection
+        // or for the one that was already stopped. If this is the latter we just ignore it.
+        if (context.disconnect_cts.get_token().is_canceled())
+        {
+            uint64_t suppressed;
+            if (context.connection_logger.is_enabled(trace_level::info) && context.stray_message_log_limiter->try_acquire(suppressed))
+            {
+                log(context.connection_logger, trace_level::info, log_limiter::append_suppressed(
+                    utility::string_t(_XPLATSTR("ignoring stray message received after connection was restarted. message: "))
+                    .append(response), suppressed));
+            }
+            return;
+        }
+
+        auto connection = context.connection.lock();
+        if (connection)
+        {
+            connection->process_response(response, context.connect_request_tce, received);
+        }
+    }
+
+    void connection_impl::process_response(const utility::string_t& response, const pplx::task_completion_event<void>& connect_request_tce,
+        std::chrono::steady_clock::time_point received)
     {
-        m_logger.log(trace_level::messages,
-            utility::string_t(_XPLATSTR("processing message: ")).append(response));
+        m_response_received_time = received;
+
+        if (m_logger.is_enabled(trace_level::messages))
+        {
+            std::lock_guard<std::mutex> lock(m_connection_info_lock);
+            m_logger.log(trace_level::messages, log_event::message_received, m_connection_id, response);
+        }
+
+        m_frames_received.fetch_add(1, std::memory_order_relaxed);
+        m_bytes_received.fetch_add(response.size() * sizeof(utility::char_t), std::memory_order_relaxed);
+
+        // the flag is only set until the first message so a relaxed read keeps every later message off the exchange
+        if (m_first_message_pending.load(std::memory_order_relaxed) && m_first_message_pending.exchange(false))
+        {
+            auto time_to_first_message = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start_time);
+            m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("first message received "))
+                .append(utility::conversions::to_string_t(std::to_string(time_to_first_message.count())))
+                .append(_XPLATSTR(" ms after starting the connection. speculative connect: "))
+                .append(m_speculative_connect ? _XPLATSTR("on") : _XPLATSTR("off")));
+        }
 
         try
         {
+            SIGNALRCLIENT_PROBE1(parse_start, response.size());
             const auto result = web::json::value::parse(response);
+            SIGNALRCLIENT_PROBE1(parse_end, result.is_object() ? 1 : 0);
 
             if (!result.is_object())
             {
+                m_parse_errors.fetch_add(1, std::memory_order_relaxed);
                 m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("unexpected response received from the server: "))
                     .append(response));
 
                 return;
             }
 
+            m_frames_parsed.fetch_add(1, std::memory_order_relaxed);
+
             if (result.has_field(_XPLATSTR("I")))
             {
                 invoke_message_received(result);
@@ -329,6 +692,11 @@ namespace signalr
 
                 m_message_id = result.at(_XPLATSTR("C")).as_string();
 
+                if (m_hot_standby)
+                {
+                    acknowledge_standby_responses(m_message_id);
+                }
+
                 if (result.has_field(_XPLATSTR("S")) && result.at(_XPLATSTR("S")).is_integer() && result.at(_XPLATSTR("S")).as_integer() == 1)
                 {
                     connect_request_tce.set();
@@ -342,6 +710,8 @@ namespace signalr
         }
         catch (const std::exception &e)
         {
+            SIGNALRCLIENT_PROBE1(parse_end, 0);
+            m_parse_errors.fetch_add(1, std::memory_order_relaxed);
             m_logger.log(trace_level::errors, utility::string_t(_XPLATSTR("error occured when parsing response: "))
                 .append(utility::conversions::to_string_t(e.what()))
                 .append(_XPLATSTR(". response: "))
@@ -349,8 +719,68 @@ namespace signalr
         }
     }
 
+    // returns `false` if the standby connection has been promoted in which case the response has to be processed as usual
+    bool connection_impl::process_standby_response(standby_state& standby_state, const utility::string_t& response,
+        const pplx::task_completion_event<void>& connect_request_tce)
+    {
+        std::lock_guard<std::mutex> lock(standby_state.lock);
+        if (standby_state.active)
+        {
+            return false;
+        }
+
+        try
+        {
+            const auto result = web::json::value::parse(response);
+            if (!result.is_object())
+            {
+                return true;
+            }
+
+            if (result.has_field(_XPLATSTR("G")) && result.at(_XPLATSTR("G")).is_string())
+            {
+                standby_state.groups_token = result.at(_XPLATSTR("G")).as_string();
+            }
+
+            if (result.has_field(_XPLATSTR("M")) && result.at(_XPLATSTR("M")).is_array() &&
+                result.has_field(_XPLATSTR("C")) && result.at(_XPLATSTR("C")).is_string())
+            {
+                standby_state.message_id = result.at(_XPLATSTR("C")).as_string();
+
+                if (result.has_field(_XPLATSTR("S")) && result.at(_XPLATSTR("S")).is_integer() && result.at(_XPLATSTR("S")).as_integer() == 1)
+                {
+                    connect_request_tce.set();
+                }
+
+                if (standby_state.message_id == standby_state.primary_message_id)
+                {
+                    // the primary connection has already processed everything up to this message
+                    standby_state.pending_responses.clear();
+                }
+                else if (result.at(_XPLATSTR("M")).size() > 0)
+                {
+                    if (standby_state.pending_responses.size() == max_pending_standby_responses)
+                    {
+                        standby_state.pending_responses.pop_front();
+                        standby_state.dropped_responses++;
+                    }
+
+                    standby_state.pending_responses.emplace_back(standby_state.message_id, response);
+                }
+            }
+        }
+        catch (const std::exception&)
+        {
+            // invalid responses are logged when the connection is promoted and starts processing them
+        }
+
+        return true;
+    }
+
     void connection_impl::invoke_message_received(const web::json::value& message)
     {
+        m_messages_received.fetch_add(1, std::memory_order_relaxed);
+
         try
         {
             m_message_received(message);
@@ -370,10 +800,16 @@ namespace signalr
 
     pplx::task<void> connection_impl::send(const utility::string_t& data)
     {
+        pplx::task<void> sent_task;
+        if (try_enqueue_outbox(data, sent_task))
+        {
+            return sent_task;
+        }
+
         // To prevent an (unlikely) condition where the transport is nulled out after we checked the connection_state
         // and before sending data we store the pointer in the local variable. In this case `send()` will throw but
         // we won't crash.
-        auto transport = m_transport;
+        auto transport = get_transport();
 
         auto connection_state = get_connection_state();
         if (connection_state != signalr::connection_state::connected || !transport)
@@ -385,7 +821,14 @@ namespace signalr
 
         auto logger = m_logger;
 
-        logger.log(trace_level::info, utility::string_t(_XPLATSTR("sending data: ")).append(data));
+        if (logger.is_enabled(trace_level::info))
+        {
+            std::lock_guard<std::mutex> lock(m_connection_info_lock);
+            logger.log(trace_level::info, log_event::message_sent, m_connection_id, data);
+        }
+
+        m_messages_sent.fetch_add(1, std::memory_order_relaxed);
+        m_bytes_sent.fetch_add(data.size() * sizeof(utility::char_t), std::memory_order_relaxed);
 
         return transport->send(data)
             .then([logger](pplx::task<void> send_task)
@@ -406,43 +849,204 @@ namespace signalr
             });
         }
 
-    pplx::task<void> connection_impl::stop()
+    // Messages sent while reconnecting are buffered if the outbox is enabled. To preserve ordering messages sent after the
+    // connection has been re-established are buffered as well until all the previously buffered messages were flushed.
+    // Returns `false` if the message should be sent directly.
+    bool connection_impl::try_enqueue_outbox(const utility::string_t& data, pplx::task<void>& sent_task)
     {
-        m_logger.log(trace_level::info, _XPLATSTR("stopping connection"));
+        if (m_outbox_max_messages == 0)
+        {
+            return false;
+        }
 
-        auto connection = shared_from_this();
-        return shutdown()
-            .then([connection]()
-            {
-                {
-                    // the lock prevents a race where the user calls `stop` on a disconnected connection and calls `start`
-                    // on a different thread at the same time. In this case we must not null out the transport if we are
-                    // not in the `disconnecting` state to not affect the 'start' invocation.
-                    std::lock_guard<std::mutex> lock(connection->m_stop_lock);
-                    if (connection->change_state(connection_state::disconnecting, connection_state::disconnected))
-                    {
-                        // we do let the exception through (especially the task_canceled exception)
-                        connection->m_transport = nullptr;
-                    }
-                }
+        std::lock_guard<std::mutex> lock(m_outbox_lock);
 
-                try
-                {
-                    connection->m_disconnected();
-                }
-                catch (const std::exception &e)
-                {
-                    connection->m_logger.log(
-                        trace_level::errors,
-                        utility::string_t(_XPLATSTR("disconnected callback threw an exception: "))
-                        .append(utility::conversions::to_string_t(e.what())));
-                }
-                catch (...)
-                {
-                    connection->m_logger.log(
-                        trace_level::errors,
-                        utility::string_t(_XPLATSTR("disconnected callback threw an unknown exception")));
+        auto state = get_connection_state();
+        if (state != connection_state::reconnecting &&
+            !(state == connection_state::connected && (m_outbox_flushing || !m_outbox.empty())))
+        {
+            return false;
+        }
+
+        auto size = data.size() * sizeof(utility::char_t);
+        if (m_outbox.size() >= m_outbox_max_messages || m_outbox_bytes + size > m_outbox_max_bytes)
+        {
+            m_logger.log(trace_level::errors, _XPLATSTR("outbox full - message could not be buffered"));
+
+            sent_task = pplx::task_from_exception<void>(signalr_exception(
+                utility::string_t(_XPLATSTR("cannot send data because the outbox is full. current connection state: "))
+                .append(translate_connection_state(state))));
+            return true;
+        }
+
+        outbox_entry entry = { outbox_string(data.begin(), data.end(), m_outbox.get_allocator()), pplx::task_completion_event<void>() };
+        sent_task = pplx::create_task(entry.sent);
+        m_outbox.push_back(std::move(entry));
+        m_outbox_bytes += size;
+        return true;
+    }
+
+    // sends the buffered messages in order in batches. Messages in a batch are handed to the transport without waiting
+    // for the previous ones to complete. Stops if the connection is lost again, in which case the remaining messages
+    // stay buffered until the connection is re-established or stopped.
+    void connection_impl::flush_outbox()
+    {
+        static const size_t max_batch_size = 64;
+
+        std::vector<outbox_entry> batch;
+        auto transport = get_transport();
+
+        {
+            std::lock_guard<std::mutex> lock(m_outbox_lock);
+            if (m_outbox.empty() || get_connection_state() != connection_state::connected || !transport)
+            {
+                m_outbox_flushing = false;
+                return;
+            }
+
+            m_outbox_flushing = true;
+            while (!m_outbox.empty() && batch.size() < max_batch_size)
+            {
+                m_outbox_bytes -= m_outbox.front().data.size() * sizeof(utility::char_t);
+                batch.push_back(std::move(m_outbox.front()));
+                m_outbox.pop_front();
+            }
+        }
+
+        m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("flushing "))
+            .append(utility::conversions::to_string_t(std::to_string(batch.size())))
+            .append(_XPLATSTR(" buffered message(s)")));
+
+        std::vector<pplx::task<void>> sends;
+        for (const auto& entry : batch)
+        {
+            m_messages_sent.fetch_add(1, std::memory_order_relaxed);
+            m_bytes_sent.fetch_add(entry.data.size() * sizeof(utility::char_t), std::memory_order_relaxed);
+
+            auto sent = entry.sent;
+            // the transport takes a utility::string_t - the copy is only made for messages that had to be buffered
+            sends.push_back(transport->send(utility::string_t(entry.data.begin(), entry.data.end()))
+                .then([sent](pplx::task<void> send_task)
+                {
+                    try
+                    {
+                        send_task.get();
+                        sent.set();
+                    }
+                    catch (...)
+                    {
+                        sent.set_exception(std::current_exception());
+                        throw;
+                    }
+                }));
+        }
+
+        auto weak_connection = std::weak_ptr<connection_impl>(shared_from_this());
+        pplx::when_all(sends.begin(), sends.end())
+            .then([weak_connection](pplx::task<void> batch_task)
+            {
+                auto connection = weak_connection.lock();
+
+                try
+                {
+                    batch_task.get();
+                }
+                catch (const std::exception& e)
+                {
+                    if (!connection)
+                    {
+                        return;
+                    }
+
+                    connection->m_logger.log(trace_level::errors,
+                        utility::string_t(_XPLATSTR("error flushing buffered messages: "))
+                        .append(utility::conversions::to_string_t(e.what())));
+
+                    // the transport failed without the connection being lost - fail the remaining messages instead of
+                    // keeping them buffered indefinitely
+                    if (connection->get_connection_state() == connection_state::connected)
+                    {
+                        connection->fail_outbox(std::current_exception());
+                    }
+
+                    std::lock_guard<std::mutex> lock(connection->m_outbox_lock);
+                    connection->m_outbox_flushing = false;
+                    return;
+                }
+
+                if (connection)
+                {
+                    connection->flush_outbox();
+                }
+            });
+    }
+
+    void connection_impl::fail_outbox(const std::exception_ptr& error)
+    {
+        std::deque<outbox_entry, tracking_allocator<outbox_entry>> outbox(m_outbox.get_allocator());
+        {
+            std::lock_guard<std::mutex> lock(m_outbox_lock);
+            outbox.swap(m_outbox);
+            m_outbox_bytes = 0;
+        }
+
+        if (!outbox.empty())
+        {
+            m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("failing "))
+                .append(utility::conversions::to_string_t(std::to_string(outbox.size())))
+                .append(_XPLATSTR(" buffered message(s)")));
+        }
+
+        for (auto& entry : outbox)
+        {
+            entry.sent.set_exception(error);
+        }
+    }
+
+    pplx::task<void> connection_impl::stop()
+    {
+        m_logger.log(trace_level::info, _XPLATSTR("stopping connection"));
+
+        auto connection = shared_from_this();
+        return shutdown()
+            .then([connection]()
+            {
+                {
+                    // the lock prevents a race where the user calls `stop` on a disconnected connection and calls `start`
+                    // on a different thread at the same time. In this case we must not null out the transport if we are
+                    // not in the `disconnecting` state to not affect the 'start' invocation.
+                    std::lock_guard<std::mutex> lock(connection->m_stop_lock);
+                    if (connection->change_state(connection_state::disconnecting, connection_state::disconnected))
+                    {
+                        // we do let the exception through (especially the task_canceled exception)
+                        connection->set_transport(nullptr);
+                    }
                 }
+
+                // the callback is captured instead of the connection so that it is invoked even if the connection went
+                // out of scope before the event loop executed it
+                auto disconnected = connection->m_disconnected;
+                auto logger = connection->m_logger;
+                dispatch(connection->m_signalr_client_config.get_event_loop(), [disconnected, logger]()
+                {
+                    try
+                    {
+                        disconnected();
+                    }
+                    catch (const std::exception &e)
+                    {
+                        log(logger,
+                            trace_level::errors,
+                            utility::string_t(_XPLATSTR("disconnected callback threw an exception: "))
+                            .append(utility::conversions::to_string_t(e.what())));
+                    }
+                    catch (...)
+                    {
+                        log(logger,
+                            trace_level::errors,
+                            utility::string_t(_XPLATSTR("disconnected callback threw an unknown exception")));
+                    }
+                });
             });
     }
 
@@ -471,6 +1075,8 @@ namespace signalr
 
             // we request a cancellation of the ongoing start or reconnect request (if any) and wait until it is cancelled
             m_disconnect_cts.cancel();
+            stop_standby();
+            stop_keep_alive_watch();
 
             while (m_start_completed_event.wait(60000) != 0)
             {
@@ -490,8 +1096,18 @@ namespace signalr
             change_state(connection_state::disconnecting);
         }
 
+        fail_outbox(std::make_exception_ptr(signalr_exception(
+            _XPLATSTR("the connection was stopped before the buffered message could be sent"))));
+
+        auto transport = get_transport();
+        utility::string_t connection_token;
+        {
+            std::lock_guard<std::mutex> lock(m_connection_info_lock);
+            connection_token = m_connection_token;
+        }
+
         // This is fire and forget because we don't really care about the result
-        request_sender::abort(*m_web_request_factory, m_base_url, m_transport->get_transport_type(), m_connection_token,
+        request_sender::abort(*m_web_request_factory, get_base_url(), transport->get_transport_type(), connection_token,
             m_connection_data, m_query_string, m_signalr_client_config)
             .then([](pplx::task<utility::string_t> abort_task)
             {
@@ -506,7 +1122,7 @@ namespace signalr
                 }
             });
 
-        return m_transport->disconnect();
+        return transport->disconnect();
     }
 
     void connection_impl::reconnect()
@@ -539,6 +1155,8 @@ namespace signalr
             disconnect_cts = m_disconnect_cts;
         }
 
+        stop_keep_alive_watch();
+
         try
         {
             m_logger.log(trace_level::info, _XPLATSTR("invoking reconnecting callback"));
@@ -593,14 +1211,49 @@ namespace signalr
             m_start_completed_event.reset();
         }
 
-        auto reconnect_url = url_builder::build_reconnect(m_base_url, m_transport->get_transport_type(),
-            m_connection_token, m_connection_data, m_message_id, m_groups_token, m_query_string);
-
         auto weak_connection = std::weak_ptr<connection_impl>(shared_from_this());
 
+        m_reconnects++;
+        m_current_reconnect_attempts = 0;
+        auto reconnect_started = std::chrono::steady_clock::now();
+
+        reconnect_context context;
+        context.failed_attempts = 0;
+        context.elapsed_time = std::chrono::milliseconds::zero();
+        context.previous_delay = std::chrono::milliseconds::zero();
+
+        auto reconnect_start_time = utility::datetime::utc_now().to_interval();
+        auto reconnect_window = m_reconnect_window.load();
+        auto reconnect_policy = m_reconnect_policy;
+
+        // switching to the standby connection (if any) is instantaneous and does not need a reconnect attempt
+        auto reconnect_task = promote_standby()
+            ? pplx::task_from_result<bool>(true)
+            : delay_first_reconnect_attempt(reconnect_policy, context, reconnect_window, disconnect_cts)
+                .then([weak_connection](bool delayed)
+                {
+                    auto connection = weak_connection.lock();
+                    if (!delayed || !connection)
+                    {
+                        return pplx::task_from_result<bool>(false);
+                    }
+
+                    return connection->probe_endpoints().then([]() { return true; });
+                })
+                .then([weak_connection, reconnect_start_time, reconnect_window, reconnect_policy, context, disconnect_cts](bool probed)
+                {
+                    auto connection = weak_connection.lock();
+                    if (!probed || !connection)
+                    {
+                        return pplx::task_from_result<bool>(false);
+                    }
+
+                    return connection->try_reconnect(reconnect_start_time, reconnect_window, reconnect_policy, context, disconnect_cts);
+                });
+
         // this is non-blocking
-        try_reconnect(reconnect_url, utility::datetime::utc_now().to_interval(), m_reconnect_window, m_reconnect_delay, disconnect_cts)
-            .then([weak_connection](pplx::task<bool> reconnect_task)
+        reconnect_task
+            .then([weak_connection, reconnect_started](pplx::task<bool> reconnect_task)
             {
                 // try reconnect does not throw
                 auto reconnected = reconnect_task.get();
@@ -612,6 +1265,11 @@ namespace signalr
                     return pplx::task_from_result();
                 }
 
+                (reconnected ? connection->m_successful_reconnects : connection->m_failed_reconnects)++;
+                connection->m_last_reconnect_attempts = connection->m_current_reconnect_attempts.load();
+                connection->m_last_reconnect_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - reconnect_started).count();
+
                 if (reconnected)
                 {
                     if (!connection->change_state(connection_state::reconnecting, connection_state::connected))
@@ -627,24 +1285,38 @@ namespace signalr
                     // if the user called stop() from the handler
                     connection->m_start_completed_event.set();
 
-                    try
-                    {
-                        connection->m_logger.log(trace_level::info, _XPLATSTR("invoking reconnected callback"));
-                        connection->m_reconnected();
-                        connection->m_logger.log(trace_level::info, _XPLATSTR("reconnected callback returned without error"));
-                    }
-                    catch (const std::exception &e)
-                    {
-                        connection->m_logger.log(
-                            trace_level::errors,
-                            utility::string_t(_XPLATSTR("reconnected callback threw an exception: "))
-                            .append(utility::conversions::to_string_t(e.what())));
-                    }
-                    catch (...)
+                    connection->flush_outbox();
+                    connection->start_keep_alive_watch();
+
+                    dispatch(connection->m_signalr_client_config.get_event_loop(), [weak_connection]()
                     {
-                        connection->m_logger.log(
-                            trace_level::errors, _XPLATSTR("reconnected callback threw an unknown exception"));
-                    }
+                        auto connection = weak_connection.lock();
+                        if (!connection)
+                        {
+                            return;
+                        }
+
+                        try
+                        {
+                            connection->m_logger.log(trace_level::info, _XPLATSTR("invoking reconnected callback"));
+                            connection->m_reconnected();
+                            connection->m_logger.log(trace_level::info, _XPLATSTR("reconnected callback returned without error"));
+                        }
+                        catch (const std::exception &e)
+                        {
+                            connection->m_logger.log(
+                                trace_level::errors,
+                                utility::string_t(_XPLATSTR("reconnected callback threw an exception: "))
+                                .append(utility::conversions::to_string_t(e.what())));
+                        }
+                        catch (...)
+                        {
+                            connection->m_logger.log(
+                                trace_level::errors, _XPLATSTR("reconnected callback threw an unknown exception"));
+                        }
+                    });
+
+                    connection->start_standby();
 
                     return pplx::task_from_result();
                 }
@@ -656,8 +1328,8 @@ namespace signalr
     }
 
     // the assumption is that this function won't throw
-    pplx::task<bool> connection_impl::try_reconnect(const web::uri& reconnect_url, const utility::datetime::interval_type reconnect_start_time,
-        int reconnect_window /*milliseconds*/, int reconnect_delay /*milliseconds*/, pplx::cancellation_token_source disconnect_cts)
+    pplx::task<bool> connection_impl::try_reconnect(const utility::datetime::interval_type reconnect_start_time, int reconnect_window /*milliseconds*/, const std::shared_ptr<reconnect_policy>& reconnect_policy, const reconnect_context& context,
+        pplx::cancellation_token_source disconnect_cts)
     {
         if (disconnect_cts.get_token().is_canceled())
         {
@@ -668,23 +1340,60 @@ namespace signalr
 
         auto weak_connection = std::weak_ptr<connection_impl>(shared_from_this());
         auto& logger = m_logger;
+        auto timer_queue = m_signalr_client_config.get_timer_queue();
+
+        m_current_reconnect_attempts++;
+        auto attempt = ++m_reconnect_attempts;
+        SIGNALRCLIENT_PROBE2(reconnect_attempt, attempt, context.failed_attempts);
+
+        // each attempt goes to the best endpoint at the time - endpoints that failed are quarantined
+        quarantine_unresolvable_endpoints();
+        auto base_url = m_endpoint_selector->select();
+        auto endpoint_selector = m_endpoint_selector;
+        auto transport = get_transport();
+        auto reconnect_url = url_builder::build_reconnect(base_url, transport->get_transport_type(),
+            m_connection_token, m_connection_data, m_message_id, m_groups_token, m_query_string);
+        auto attempt_started = std::chrono::steady_clock::now();
+        auto reconnect_admission = admission(m_signalr_client_config, m_signalr_client_config.get_admission_priority());
 
-        return m_transport->connect(reconnect_url)
-            .then([weak_connection, reconnect_url, reconnect_start_time, reconnect_window, reconnect_delay, logger, disconnect_cts]
-            (pplx::task<void> reconnect_task)
+        return reconnect_admission.acquire(disconnect_cts.get_token())
+            .then([transport, reconnect_url]()
+            {
+                return transport->connect(reconnect_url);
+            })
+            .then([weak_connection, base_url, endpoint_selector, attempt_started, reconnect_start_time, reconnect_window, reconnect_policy,
+                context, logger, disconnect_cts, timer_queue, reconnect_admission](pplx::task<void> reconnect_task)
         {
+            reconnect_admission.release();
+
             try
             {
                 log(logger, trace_level::info, _XPLATSTR("reconnect attempt starting"));
                 reconnect_task.get();
                 log(logger, trace_level::info, _XPLATSTR("reconnect attempt completed successfully"));
 
+                endpoint_selector->record_success(base_url,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - attempt_started));
+
+                auto connection = weak_connection.lock();
+                if (connection)
+                {
+                    connection->set_base_url(base_url);
+                }
+
                 return pplx::task_from_result<bool>(true);
             }
+            catch (const pplx::task_canceled&)
+            {
+                // waiting to be admitted was cancelled - the endpoint was not contacted so it must not be quarantined
+                log(logger, trace_level::info, _XPLATSTR("reconnect attempt cancelled before it was admitted"));
+            }
             catch (const std::exception& e)
             {
                 log(logger, trace_level::info, utility::string_t(_XPLATSTR("reconnect attempt failed due to: "))
                     .append(utility::conversions::to_string_t(e.what())));
+
+                endpoint_selector->record_failure(base_url);
             }
 
             if (disconnect_cts.get_token().is_canceled())
@@ -694,8 +1403,24 @@ namespace signalr
                 return pplx::task_from_result<bool>(false);
             }
 
+            auto now = utility::datetime::utc_now().to_interval();
+
+            reconnect_context next_context;
+            next_context.failed_attempts = context.failed_attempts + 1;
+            // datetime intervals are in 100ns units
+            next_context.elapsed_time = std::chrono::milliseconds((now - reconnect_start_time) / 10000);
+            next_context.previous_delay = context.previous_delay;
+
+            std::chrono::milliseconds reconnect_delay;
+            if (!next_reconnect_delay(reconnect_policy, next_context, logger, reconnect_delay))
+            {
+                return pplx::task_from_result<bool>(false);
+            }
+
+            next_context.previous_delay = reconnect_delay;
+
             auto reconnect_window_end = reconnect_start_time + utility::datetime::from_milliseconds(reconnect_window);
-            if (utility::datetime::utc_now().to_interval() + utility::datetime::from_milliseconds(reconnect_delay) > reconnect_window_end)
+            if (now + utility::datetime::from_milliseconds(static_cast<unsigned int>(reconnect_delay.count())) > reconnect_window_end)
             {
                 utility::ostringstream_t oss;
                 oss << _XPLATSTR("connection could not be re-established within the configured timeout of ")
@@ -705,80 +1430,728 @@ namespace signalr
                 return pplx::task_from_result<bool>(false);
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(reconnect_delay));
-
-            if (disconnect_cts.get_token().is_canceled())
+            return delay(timer_queue, reconnect_delay)
+                .then([weak_connection, reconnect_start_time, reconnect_window, reconnect_policy, next_context, logger, disconnect_cts](pplx::task<void> delay_task)
             {
-                log(logger, trace_level::info, utility::string_t(_XPLATSTR("reconnecting cancelled - connection is being stopped. line: "))
-                    .append(utility::conversions::to_string_t(std::to_string(__LINE__))));
+                try
+                {
+                    delay_task.get();
+                }
+                catch (const pplx::task_canceled&)
+                {
+                    log(logger, trace_level::info, _XPLATSTR("reconnecting cancelled - the timer queue was destroyed."));
+                    return pplx::task_from_result<bool>(false);
+                }
 
-                return pplx::task_from_result<bool>(false);
-            }
+                if (disconnect_cts.get_token().is_canceled())
+                {
+                    log(logger, trace_level::info, utility::string_t(_XPLATSTR("reconnecting cancelled - connection is being stopped. line: "))
+                        .append(utility::conversions::to_string_t(std::to_string(__LINE__))));
 
-            auto connection = weak_connection.lock();
-            if (connection)
-            {
-                return connection->try_reconnect(reconnect_url, reconnect_start_time, reconnect_window, reconnect_delay, disconnect_cts);
-            }
+                    return pplx::task_from_result<bool>(false);
+                }
 
-            log(logger, trace_level::info, _XPLATSTR("reconnecting cancelled - connection no longer valid."));
-            return pplx::task_from_result<bool>(false);
+                auto connection = weak_connection.lock();
+                if (connection)
+                {
+                    return connection->try_reconnect(reconnect_start_time, reconnect_window, reconnect_policy, next_context, disconnect_cts);
+                }
+
+                log(logger, trace_level::info, _XPLATSTR("reconnecting cancelled - connection no longer valid."));
+                return pplx::task_from_result<bool>(false);
+            });
         });
     }
 
-    connection_state connection_impl::get_connection_state() const
+    // the policy is asked for a delay before the first attempt too (with no failed attempts) so that the clients that lost
+    // the connection to the same server at the same time do not all reconnect at once. Returns `false` if the connection
+    // should stop reconnecting.
+    pplx::task<bool> connection_impl::delay_first_reconnect_attempt(const std::shared_ptr<reconnect_policy>& reconnect_policy,
+        const reconnect_context& context, int reconnect_window /*milliseconds*/, pplx::cancellation_token_source disconnect_cts)
     {
-        return m_connection_state.load();
-    }
+        auto logger = m_logger;
 
-    utility::string_t connection_impl::get_connection_id() const
-    {
-        if (m_connection_state.load() == connection_state::connecting)
+        std::chrono::milliseconds reconnect_delay;
+        if (!next_reconnect_delay(reconnect_policy, context, logger, reconnect_delay))
         {
-            return _XPLATSTR("");
+            return pplx::task_from_result<bool>(false);
         }
 
-        return m_connection_id;
-    }
+        if (reconnect_delay.count() > reconnect_window)
+        {
+            utility::ostringstream_t oss;
+            oss << _XPLATSTR("connection could not be re-established within the configured timeout of ")
+                << reconnect_window << _XPLATSTR(" milliseconds");
+            log(logger, trace_level::info, oss.str());
 
-    utility::string_t connection_impl::get_connection_token() const
-    {
-        if (m_connection_state.load() == connection_state::connecting)
+            return pplx::task_from_result<bool>(false);
+        }
+
+        if (reconnect_delay == std::chrono::milliseconds::zero())
         {
-            return _XPLATSTR("");
+            return pplx::task_from_result<bool>(true);
         }
 
-        return m_connection_token;
+        return delay(m_signalr_client_config.get_timer_queue(), reconnect_delay)
+            .then([logger, disconnect_cts](pplx::task<void> delay_task)
+            {
+                try
+                {
+                    delay_task.get();
+                }
+                catch (const pplx::task_canceled&)
+                {
+                    log(logger, trace_level::info, _XPLATSTR("reconnecting cancelled - the timer queue was destroyed."));
+                    return false;
+                }
+
+                if (disconnect_cts.get_token().is_canceled())
+                {
+                    log(logger, trace_level::info, utility::string_t(_XPLATSTR("reconnecting cancelled - connection is being stopped. line: "))
+                        .append(utility::conversions::to_string_t(std::to_string(__LINE__))));
+                    return false;
+                }
+
+                return true;
+            });
     }
 
-    void connection_impl::set_message_received_string(const std::function<void(const utility::string_t&)>& message_received)
+    // measures the round trip time to all the endpoints that are not quarantined. No-op if there is only one endpoint.
+    pplx::task<void> connection_impl::probe_endpoints()
     {
-        set_message_received_json([message_received](const web::json::value& payload)
+        auto endpoints = m_endpoint_selector->get_endpoints();
+        if (endpoints.size() < 2)
         {
-            message_received(payload.is_string() ? payload.as_string() : payload.serialize());
-        });
-    }
+            return pplx::task_from_result();
+        }
 
-    void connection_impl::set_message_received_json(const std::function<void(const web::json::value&)>& message_received)
-    {
-        ensure_disconnected(_XPLATSTR("cannot set the callback when the connection is not in the disconnected state. "));
-        m_message_received = message_received;
-    }
+        auto weak_connection = std::weak_ptr<connection_impl>(shared_from_this());
+        auto endpoint_selector = m_endpoint_selector;
+        auto logger = m_logger;
 
-    void connection_impl::set_connection_data(const utility::string_t& connection_data)
-    {
-        _ASSERTE(get_connection_state() == connection_state::disconnected);
+        std::vector<pplx::task<void>> pings;
+        for (const auto& url : endpoints)
+        {
+            if (endpoint_selector->is_quarantined(url))
+            {
+                continue;
+            }
 
-        m_connection_data = connection_data;
-    }
+            // pings are admitted like the attempt they are made for
+            auto ping_admission = admission(m_signalr_client_config, m_signalr_client_config.get_admission_priority());
+            pings.push_back(ping_admission.acquire(m_disconnect_cts.get_token())
+                .then([weak_connection, url]()
+                {
+                    auto connection = weak_connection.lock();
+                    if (!connection)
+                    {
+                        return pplx::task_from_exception<std::chrono::milliseconds>(signalr_exception(_XPLATSTR("connection no longer exists")));
+                    }
 
-    void connection_impl::set_client_config(const signalr_client_config& config)
-    {
-        ensure_disconnected(_XPLATSTR("cannot set client config when the connection is not in the disconnected state. "));
-        m_signalr_client_config = config;
+                    auto ping_started = std::chrono::steady_clock::now();
+                    return request_sender::ping(*connection->m_web_request_factory, url, connection->m_query_string,
+                        connection->m_signalr_client_config)
+                        .then([ping_started]()
+                        {
+                            return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - ping_started);
+                        });
+                })
+                .then([endpoint_selector, url, logger, ping_admission](pplx::task<std::chrono::milliseconds> ping_task)
+                {
+                    ping_admission.release();
+
+                    try
+                    {
+                        endpoint_selector->record_success(url, ping_task.get());
+                    }
+                    catch (const pplx::task_canceled&)
+                    {
+                        // waiting to be admitted was cancelled - the endpoint was not contacted
+                    }
+                    catch (const std::exception& e)
+                    {
+                        log(logger, trace_level::info, utility::string_t(_XPLATSTR("ping to "))
+                            .append(url.to_string())
+                            .append(_XPLATSTR(" failed due to: "))
+                            .append(utility::conversions::to_string_t(e.what())));
+
+                        endpoint_selector->record_failure(url);
+                    }
+                }));
+        }
+
+        if (pings.empty())
+        {
+            return pplx::task_from_result();
+        }
+
+        return pplx::when_all(pings.begin(), pings.end());
     }
 
-    void connection_impl::set_reconnecting(const std::function<void()>& reconnecting)
+    // Resolves the hosts of all the endpoints ahead of time so that the connection can skip endpoints that cannot be
+    // resolved. The addresses are only used to tell whether the hosts resolve - the transports resolve the hosts
+    // again when connecting. Fails only if none of the endpoints could be resolved.
+    pplx::task<void> connection_impl::prepare()
+    {
+        auto endpoint_selector = m_endpoint_selector;
+        auto logger = m_logger;
+
+        std::vector<pplx::task<bool>> lookups;
+        for (const auto& url : endpoint_selector->get_endpoints())
+        {
+            lookups.push_back(m_dns_cache->resolve(url.host())
+                .then([endpoint_selector, url, logger](pplx::task<std::vector<utility::string_t>> lookup_task)
+                {
+                    try
+                    {
+                        lookup_task.get();
+                        return true;
+                    }
+                    catch (const std::exception& e)
+                    {
+                        log(logger, trace_level::errors, utility::string_t(_XPLATSTR("endpoint could not be resolved: "))
+                            .append(url.to_string())
+                            .append(_XPLATSTR(", error: "))
+                            .append(utility::conversions::to_string_t(e.what())));
+
+                        endpoint_selector->record_failure(url);
+                        return false;
+                    }
+                }));
+        }
+
+        return pplx::when_all(lookups.begin(), lookups.end())
+            .then([](std::vector<bool> results)
+            {
+                if (std::find(results.begin(), results.end(), true) == results.end())
+                {
+                    throw signalr_exception(_XPLATSTR("none of the endpoints could be resolved"));
+                }
+            });
+    }
+
+    // Never blocks on the resolver. Hosts whose status is not known yet are not skipped. Expired entries are refreshed
+    // in the background.
+    void connection_impl::quarantine_unresolvable_endpoints()
+    {
+        for (const auto& url : m_endpoint_selector->get_endpoints())
+        {
+            if (m_dns_cache->get_status(url.host()) == dns_cache::host_status::unresolvable &&
+                !m_endpoint_selector->is_quarantined(url))
+            {
+                m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("skipping endpoint that could not be resolved: "))
+                    .append(url.to_string()));
+
+                m_endpoint_selector->record_failure(url);
+            }
+        }
+    }
+
+    // builds a second, fully negotiated connection that stays connected but whose messages are not processed until it
+    // is promoted. The standby is started on an endpoint other than the current one if there is one. Non-blocking.
+    void connection_impl::start_standby()
+    {
+        if (!m_hot_standby)
+        {
+            return;
+        }
+
+        auto state = std::make_shared<standby_state>();
+        state->active = false;
+        state->dropped_responses = 0;
+
+        {
+            std::lock_guard<std::mutex> lock(m_standby_lock);
+            if (m_standby || m_standby_starting)
+            {
+                return;
+            }
+
+            m_standby_starting = true;
+            m_standby_state = state;
+        }
+
+        auto base_url = m_endpoint_selector->select();
+        for (const auto& url : m_endpoint_selector->get_endpoints())
+        {
+            if (url != get_base_url() && !m_endpoint_selector->is_quarantined(url))
+            {
+                base_url = url;
+                break;
+            }
+        }
+
+        auto standby = std::make_shared<standby_connection>();
+        standby->state = state;
+        standby->base_url = base_url;
+
+        auto weak_connection = std::weak_ptr<connection_impl>(shared_from_this());
+        auto disconnect_cts = m_disconnect_cts;
+        auto logger = m_logger;
+
+        m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("starting standby connection to: "))
+            .append(base_url.to_string()));
+
+        // the standby is not needed to keep the connection running so it yields to all the other attempts
+        auto standby_admission = admission(m_signalr_client_config, admission_priority::low);
+
+        standby_admission.acquire(disconnect_cts.get_token())
+            .then([weak_connection, base_url]()
+            {
+                auto connection = weak_connection.lock();
+                if (!connection)
+                {
+                    return pplx::task_from_exception<negotiation_response>(signalr_exception(_XPLATSTR("connection no longer exists")));
+                }
+
+                return request_sender::negotiate(*connection->m_web_request_factory, base_url, connection->m_connection_data,
+                    connection->m_query_string, connection->m_signalr_client_config);
+            }, disconnect_cts.get_token())
+            .then([weak_connection, standby](negotiation_response negotiation_response)
+            {
+                auto connection = weak_connection.lock();
+                if (!connection)
+                {
+                    return pplx::task_from_exception<void>(signalr_exception(_XPLATSTR("connection no longer exists")));
+                }
+
+                if (negotiation_response.protocol_version != PROTOCOL)
+                {
+                    return pplx::task_from_exception<void>(
+                        signalr_exception(_XPLATSTR("incompatible protocol version. client protocol version: ") \
+                            PROTOCOL _XPLATSTR(", server protocol version: ") + negotiation_response.protocol_version));
+                }
+
+                standby->connection_id = negotiation_response.connection_id;
+                standby->connection_token = negotiation_response.connection_token;
+                standby->reconnect_window =
+                    negotiation_response.disconnect_timeout + std::max(negotiation_response.keep_alive_timeout, 0);
+                standby->keep_alive_timeout = negotiation_response.keep_alive_timeout;
+
+                return connection->start_transport(negotiation_response, standby->base_url, standby->state)
+                    .then([weak_connection, standby](std::shared_ptr<transport> transport)
+                    {
+                        standby->connected_transport = transport;
+
+                        auto connection = weak_connection.lock();
+                        if (!connection)
+                        {
+                            return pplx::task_from_exception<void>(signalr_exception(_XPLATSTR("connection no longer exists")));
+                        }
+
+                        return request_sender::start(*connection->m_web_request_factory, standby->base_url,
+                            transport->get_transport_type(), standby->connection_token, connection->m_connection_data,
+                            connection->m_query_string, connection->m_signalr_client_config);
+                    });
+            }, disconnect_cts.get_token())
+            .then([weak_connection, standby, disconnect_cts, logger, standby_admission](pplx::task<void> previous_task)
+            {
+                standby_admission.release();
+
+                bool started = false;
+                try
+                {
+                    previous_task.get();
+                    started = true;
+                }
+                catch (const std::exception& e)
+                {
+                    log(logger, trace_level::info, utility::string_t(_XPLATSTR("standby connection could not be started due to: "))
+                        .append(utility::conversions::to_string_t(e.what())));
+                }
+
+                auto connection = weak_connection.lock();
+                if (connection)
+                {
+                    std::lock_guard<std::mutex> lock(connection->m_standby_lock);
+                    connection->m_standby_starting = false;
+
+                    // the connection could have been stopped (or restarted) while the standby was being started
+                    if (started && !disconnect_cts.get_token().is_canceled())
+                    {
+                        connection->m_standby = standby;
+                        log(logger, trace_level::info, _XPLATSTR("standby connection ready"));
+                        return;
+                    }
+
+                    if (connection->m_standby_state == standby->state)
+                    {
+                        connection->m_standby_state = nullptr;
+                    }
+                }
+
+                if (standby->connected_transport)
+                {
+                    standby->connected_transport->disconnect().then([](pplx::task<void> stop_task)
+                    {
+                        try { stop_task.get(); } catch (...) {}
+                    });
+                }
+            });
+    }
+
+    // makes the standby connection (if any) the current connection. Returns `false` if there is no standby connection.
+    bool connection_impl::promote_standby()
+    {
+        std::shared_ptr<standby_connection> standby;
+        {
+            std::lock_guard<std::mutex> lock(m_standby_lock);
+            standby.swap(m_standby);
+            m_standby_state = nullptr;
+        }
+
+        if (!standby)
+        {
+            return false;
+        }
+
+        // the transport is published atomically because it is read by threads sending messages and by the keep-alive
+        // watchdog. Promoting does not take the stop lock because stopping holds it while waiting for the reconnect
+        // (and therefore the promotion) to complete.
+        auto previous_transport = get_transport();
+        set_transport(standby->connected_transport);
+        set_base_url(standby->base_url);
+        {
+            std::lock_guard<std::mutex> lock(m_connection_info_lock);
+            m_connection_id = standby->connection_id;
+            m_connection_token = standby->connection_token;
+        }
+        m_reconnect_window = standby->reconnect_window;
+        m_keep_alive_timeout = standby->keep_alive_timeout;
+
+        std::deque<std::pair<utility::string_t, utility::string_t>> pending_responses;
+        uint64_t dropped_responses;
+        {
+            std::lock_guard<std::mutex> lock(standby->state->lock);
+            m_message_id = standby->state->message_id;
+            m_groups_token = standby->state->groups_token;
+            pending_responses.swap(standby->state->pending_responses);
+            dropped_responses = standby->state->dropped_responses;
+        }
+
+        if (dropped_responses > 0)
+        {
+            m_logger.log(trace_level::errors, utility::string_t(_XPLATSTR("the standby connection dropped "))
+                .append(utility::conversions::to_string_t(std::to_string(dropped_responses)))
+                .append(_XPLATSTR(" response(s) the connection had not received - some messages may have been lost")));
+        }
+
+        // replays the messages the standby connection received but the connection had not. Messages received in the
+        // meantime are queued until there are no pending responses so that they are processed in order.
+        pplx::task_completion_event<void> connect_request_tce;
+        while (true)
+        {
+            for (const auto& pending_response : pending_responses)
+            {
+                process_response(pending_response.second, connect_request_tce, std::chrono::steady_clock::now());
+            }
+
+            pending_responses.clear();
+
+            std::lock_guard<std::mutex> lock(standby->state->lock);
+            if (standby->state->pending_responses.empty())
+            {
+                // from now on the messages received by the standby are processed by the connection
+                standby->state->active = true;
+                break;
+            }
+
+            pending_responses.swap(standby->state->pending_responses);
+        }
+
+        if (previous_transport)
+        {
+            previous_transport->disconnect().then([](pplx::task<void> stop_task)
+            {
+                try { stop_task.get(); } catch (...) {}
+            });
+        }
+
+        m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("failed over to standby connection: "))
+            .append(standby->base_url.to_string()));
+
+        return true;
+    }
+
+    void connection_impl::discard_standby(const std::shared_ptr<standby_state>& state)
+    {
+        std::lock_guard<std::mutex> lock(m_standby_lock);
+        if (m_standby && m_standby->state == state)
+        {
+            m_standby = nullptr;
+        }
+
+        if (m_standby_state == state)
+        {
+            m_standby_state = nullptr;
+        }
+    }
+
+    // the primary connection processed the messages up to the given message id - the standby connection no longer needs
+    // to keep them
+    void connection_impl::acknowledge_standby_responses(const utility::string_t& message_id)
+    {
+        // the standby connection can receive messages before it is ready
+        std::shared_ptr<standby_state> state;
+        {
+            std::lock_guard<std::mutex> lock(m_standby_lock);
+            state = m_standby_state;
+        }
+
+        if (!state)
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(state->lock);
+        state->primary_message_id = message_id;
+
+        auto& pending_responses = state->pending_responses;
+        auto acknowledged = std::find_if(pending_responses.begin(), pending_responses.end(),
+            [&message_id](const std::pair<utility::string_t, utility::string_t>& pending_response)
+            {
+                return pending_response.first == message_id;
+            });
+
+        if (acknowledged != pending_responses.end())
+        {
+            pending_responses.erase(pending_responses.begin(), acknowledged + 1);
+        }
+    }
+
+    void connection_impl::stop_standby()
+    {
+        std::shared_ptr<standby_connection> standby;
+        {
+            std::lock_guard<std::mutex> lock(m_standby_lock);
+            standby.swap(m_standby);
+            m_standby_state = nullptr;
+        }
+
+        if (standby)
+        {
+            m_logger.log(trace_level::info, _XPLATSTR("stopping standby connection"));
+
+            standby->connected_transport->disconnect().then([](pplx::task<void> stop_task)
+            {
+                try { stop_task.get(); } catch (...) {}
+            });
+        }
+    }
+
+    void connection_impl::start_keep_alive_watch()
+    {
+        auto transport = get_transport();
+        auto keep_alive_timeout = m_keep_alive_timeout.load();
+        if (keep_alive_timeout <= 0 || !transport)
+        {
+            return;
+        }
+
+        auto weak_connection = std::weak_ptr<connection_impl>(shared_from_this());
+        auto watch_id = m_keep_alive_watchdog->watch(transport, std::chrono::milliseconds(keep_alive_timeout),
+            [weak_connection, transport](std::chrono::milliseconds time_since_last_activity)
+            {
+                auto connection = weak_connection.lock();
+                if (connection)
+                {
+                    connection->handle_keep_alive_timeout(transport, time_since_last_activity);
+                }
+            });
+
+        auto previous_watch_id = m_keep_alive_watch_id.exchange(watch_id);
+        if (previous_watch_id != 0)
+        {
+            m_keep_alive_watchdog->unwatch(previous_watch_id);
+        }
+    }
+
+    void connection_impl::stop_keep_alive_watch()
+    {
+        auto watch_id = m_keep_alive_watch_id.exchange(0);
+        if (watch_id != 0)
+        {
+            m_keep_alive_watchdog->unwatch(watch_id);
+        }
+    }
+
+    // invoked on the timer thread so it must not block
+    void connection_impl::handle_keep_alive_timeout(const std::shared_ptr<transport>& transport, std::chrono::milliseconds time_since_last_activity)
+    {
+        // the transport is read atomically since it is replaced when failing over to the standby connection
+        if (get_connection_state() != connection_state::connected || get_transport() != transport)
+        {
+            return;
+        }
+
+        m_keep_alive_timeouts++;
+        m_last_keep_alive_detection_time = time_since_last_activity.count();
+
+        m_logger.log(trace_level::errors,
+            utility::string_t(_XPLATSTR("nothing received from the server within the keep-alive timeout - connection considered lost. time since last message: "))
+            .append(utility::conversions::to_string_t(std::to_string(time_since_last_activity.count())))
+            .append(_XPLATSTR("ms")));
+
+        // the transport has to be closed before it can be reconnected. Disconnecting stops the receive loop so the
+        // transport won't report an error for the half-open connection.
+        transport->disconnect().then([](pplx::task<void> disconnect_task)
+        {
+            try { disconnect_task.get(); } catch (...) {}
+        });
+
+        auto weak_connection = std::weak_ptr<connection_impl>(shared_from_this());
+        auto event_loop = m_signalr_client_config.get_event_loop();
+        pplx::create_task([weak_connection, event_loop]()
+        {
+            dispatch(event_loop, [weak_connection]()
+            {
+                auto connection = weak_connection.lock();
+                if (connection)
+                {
+                    connection->reconnect();
+                }
+            });
+        });
+    }
+
+    web::uri connection_impl::get_base_url() const
+    {
+        std::lock_guard<std::mutex> lock(m_base_url_lock);
+        return m_base_url;
+    }
+
+    void connection_impl::set_base_url(const web::uri& base_url)
+    {
+        std::lock_guard<std::mutex> lock(m_base_url_lock);
+        m_base_url = base_url;
+    }
+
+    void connection_impl::set_metrics_collector(const std::function<void(connection_metrics&)>& collect_metrics)
+    {
+        m_collect_metrics = collect_metrics;
+    }
+
+    connection_impl::connection_metrics_source::connection_metrics_source(const std::weak_ptr<connection_impl>& connection)
+        : m_connection(connection)
+    { }
+
+    bool connection_impl::connection_metrics_source::collect(connection_metrics& metrics) const
+    {
+        auto connection = m_connection.lock();
+        if (!connection)
+        {
+            return false;
+        }
+
+        metrics.url = connection->get_base_url().to_string();
+        metrics.connection_id = connection->get_connection_id();
+        metrics.state = connection->get_connection_state();
+        metrics.statistics = connection->get_statistics();
+        metrics.reconnects = connection->get_reconnect_statistics();
+        metrics.invocation_latencies.clear();
+
+        if (connection->m_collect_metrics)
+        {
+            connection->m_collect_metrics(metrics);
+        }
+
+        return true;
+    }
+
+    // only meaningful when called from the message received callback
+    std::chrono::steady_clock::time_point connection_impl::get_response_received_time() const
+    {
+        return m_response_received_time;
+    }
+
+    connection_state connection_impl::get_connection_state() const
+    {
+        return m_connection_state.load();
+    }
+
+    utility::string_t connection_impl::get_connection_id() const
+    {
+        if (m_connection_state.load() == connection_state::connecting)
+        {
+            return _XPLATSTR("");
+        }
+
+        std::lock_guard<std::mutex> lock(m_connection_info_lock);
+        return m_connection_id;
+    }
+
+    utility::string_t connection_impl::get_connection_token() const
+    {
+        if (m_connection_state.load() == connection_state::connecting)
+        {
+            return _XPLATSTR("");
+        }
+
+        std::lock_guard<std::mutex> lock(m_connection_info_lock);
+        return m_connection_token;
+    }
+
+    void connection_impl::set_message_received_string(const std::function<void(const utility::string_t&)>& message_received)
+    {
+        set_message_received_json([message_received](const web::json::value& payload)
+        {
+            message_received(payload.is_string() ? payload.as_string() : payload.serialize());
+        });
+    }
+
+    void connection_impl::set_message_received_json(const std::function<void(const web::json::value&)>& message_received)
+    {
+        ensure_disconnected(_XPLATSTR("cannot set the callback when the connection is not in the disconnected state. "));
+        m_message_received = message_received;
+    }
+
+    void connection_impl::set_connection_data(const utility::string_t& connection_data)
+    {
+        _ASSERTE(get_connection_state() == connection_state::disconnected);
+
+        m_connection_data = connection_data;
+    }
+
+    void connection_impl::set_client_config(const signalr_client_config& config)
+    {
+        ensure_disconnected(_XPLATSTR("cannot set client config when the connection is not in the disconnected state. "));
+
+        auto previous_metrics_sink = m_signalr_client_config.get_metrics_sink();
+        auto metrics_sink = config.get_metrics_sink();
+        if (metrics_sink != previous_metrics_sink)
+        {
+            if (previous_metrics_sink && m_metrics_source)
+            {
+                previous_metrics_sink->remove_source(m_metrics_source);
+            }
+
+            if (metrics_sink)
+            {
+                if (!m_metrics_source)
+                {
+                    m_metrics_source = std::make_shared<connection_metrics_source>(shared_from_this());
+                }
+
+                metrics_sink->add_source(m_metrics_source);
+            }
+        }
+
+        auto memory_allocator = config.get_memory_allocator();
+        if (memory_allocator != m_signalr_client_config.get_memory_allocator())
+        {
+            // the outbox is empty when the connection is disconnected - swapping returns the memory of the previous
+            // outbox to the allocator it was taken from
+            std::lock_guard<std::mutex> lock(m_outbox_lock);
+            decltype(m_outbox)(tracking_allocator<outbox_entry>(memory_allocator.get(), &m_outbox_allocation_counters)).swap(m_outbox);
+        }
+
+        m_signalr_client_config = config;
+
+        // the new config may change the credentials the previous connection token was issued for
+        m_previous_negotiation = nullptr;
+    }
+
+    void connection_impl::set_reconnecting(const std::function<void()>& reconnecting)
     {
         ensure_disconnected(_XPLATSTR("cannot set the reconnecting callback when the connection is not in the disconnected state. "));
         m_reconnecting = reconnecting;
@@ -799,7 +2172,113 @@ namespace signalr
     void connection_impl::set_reconnect_delay(const int reconnect_delay)
     {
         ensure_disconnected(_XPLATSTR("cannot set reconnect delay when the connection is not in the disconnected state. "));
-        m_reconnect_delay = reconnect_delay;
+        m_reconnect_policy = std::make_shared<fixed_delay_reconnect_policy>(std::chrono::milliseconds(reconnect_delay));
+    }
+
+    void connection_impl::set_reconnect_policy(const std::shared_ptr<reconnect_policy>& reconnect_policy)
+    {
+        if (!reconnect_policy)
+        {
+            throw std::invalid_argument("reconnect_policy cannot be null");
+        }
+
+        ensure_disconnected(_XPLATSTR("cannot set reconnect policy when the connection is not in the disconnected state. "));
+        m_reconnect_policy = reconnect_policy;
+    }
+
+    void connection_impl::set_failover_urls(const std::vector<utility::string_t>& failover_urls)
+    {
+        ensure_disconnected(_XPLATSTR("cannot set failover urls when the connection is not in the disconnected state. "));
+
+        std::vector<web::uri> urls{ m_endpoint_selector->get_endpoints().front() };
+        for (const auto& url : failover_urls)
+        {
+            urls.push_back(web::uri(url));
+        }
+
+        m_endpoint_selector->set_endpoints(urls);
+    }
+
+    void connection_impl::set_hot_standby(bool hot_standby)
+    {
+        ensure_disconnected(_XPLATSTR("cannot set hot standby when the connection is not in the disconnected state. "));
+        m_hot_standby = hot_standby;
+    }
+
+    void connection_impl::set_fast_restart(int max_negotiation_age /*milliseconds*/)
+    {
+        ensure_disconnected(_XPLATSTR("cannot set fast restart when the connection is not in the disconnected state. "));
+        m_fast_restart_max_negotiation_age = max_negotiation_age;
+    }
+
+    void connection_impl::set_speculative_connect(bool speculative_connect)
+    {
+        ensure_disconnected(_XPLATSTR("cannot set speculative connect when the connection is not in the disconnected state. "));
+        m_speculative_connect = speculative_connect;
+    }
+
+    void connection_impl::set_reconnect_outbox(size_t max_messages, size_t max_bytes)
+    {
+        ensure_disconnected(_XPLATSTR("cannot set reconnect outbox when the connection is not in the disconnected state. "));
+        m_outbox_max_messages = max_messages;
+        m_outbox_max_bytes = max_bytes;
+    }
+
+    reconnect_statistics connection_impl::get_reconnect_statistics() const
+    {
+        reconnect_statistics statistics;
+        statistics.reconnects = m_reconnects.load();
+        statistics.successful_reconnects = m_successful_reconnects.load();
+        statistics.failed_reconnects = m_failed_reconnects.load();
+        statistics.attempts = m_reconnect_attempts.load();
+        statistics.last_reconnect_attempts = m_last_reconnect_attempts.load();
+        statistics.last_reconnect_duration = std::chrono::milliseconds(m_last_reconnect_duration.load());
+        statistics.keep_alive_timeouts = m_keep_alive_timeouts.load();
+        statistics.last_keep_alive_detection_time = std::chrono::milliseconds(m_last_keep_alive_detection_time.load());
+        return statistics;
+    }
+
+    connection_statistics connection_impl::get_statistics() const
+    {
+        connection_statistics statistics;
+        statistics.frames_received = m_frames_received.load(std::memory_order_relaxed);
+        statistics.bytes_received = m_bytes_received.load(std::memory_order_relaxed);
+        statistics.frames_parsed = m_frames_parsed.load(std::memory_order_relaxed);
+        statistics.parse_errors = m_parse_errors.load(std::memory_order_relaxed);
+        statistics.messages_received = m_messages_received.load(std::memory_order_relaxed);
+        statistics.messages_sent = m_messages_sent.load(std::memory_order_relaxed);
+        statistics.bytes_sent = m_bytes_sent.load(std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(m_outbox_lock);
+            statistics.outbound_queue_depth = m_outbox.size();
+        }
+        statistics.pending_invocations = 0;
+        statistics.outbox_allocations = m_outbox_allocation_counters.allocations.load(std::memory_order_relaxed);
+        statistics.outbox_allocated_bytes = m_outbox_allocation_counters.allocated_bytes.load(std::memory_order_relaxed);
+        statistics.outbox_bytes_in_use = m_outbox_allocation_counters.get_bytes_in_use();
+        statistics.invocation_allocations = 0;
+        statistics.invocation_allocated_bytes = 0;
+        statistics.invocation_bytes_in_use = 0;
+        statistics.reconnect_attempts = m_reconnect_attempts.load();
+        statistics.last_reconnect_duration = std::chrono::milliseconds(m_last_reconnect_duration.load());
+
+        std::chrono::steady_clock::duration time_in_state[5];
+        for (auto i = 0; i < 5; i++)
+        {
+            time_in_state[i] = std::chrono::steady_clock::duration(m_time_in_state[i].load(std::memory_order_relaxed));
+        }
+
+        // the state may change while the snapshot is taken in which case the time is attributed to the new state
+        auto current_state = m_connection_state.load();
+        time_in_state[static_cast<int>(current_state)] += std::chrono::steady_clock::now().time_since_epoch()
+            - std::chrono::steady_clock::duration(m_state_changed_time.load());
+
+        statistics.time_connecting = std::chrono::duration_cast<std::chrono::milliseconds>(time_in_state[static_cast<int>(connection_state::connecting)]);
+        statistics.time_connected = std::chrono::duration_cast<std::chrono::milliseconds>(time_in_state[static_cast<int>(connection_state::connected)]);
+        statistics.time_reconnecting = std::chrono::duration_cast<std::chrono::milliseconds>(time_in_state[static_cast<int>(connection_state::reconnecting)]);
+        statistics.time_disconnecting = std::chrono::duration_cast<std::chrono::milliseconds>(time_in_state[static_cast<int>(connection_state::disconnecting)]);
+        statistics.time_disconnected = std::chrono::duration_cast<std::chrono::milliseconds>(time_in_state[static_cast<int>(connection_state::disconnected)]);
+        return statistics;
     }
 
     void connection_impl::ensure_disconnected(const utility::string_t& error_message)
@@ -836,6 +2315,11 @@ namespace signalr
 
     void connection_impl::handle_connection_state_change(connection_state old_state, connection_state new_state)
     {
+        SIGNALRCLIENT_PROBE2(state_change, static_cast<int>(old_state), static_cast<int>(new_state));
+
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        m_time_in_state[static_cast<int>(old_state)].fetch_add(now - m_state_changed_time.exchange(now), std::memory_order_relaxed);
+
         m_logger.log(
             trace_level::state_changes,
             translate_connection_state(old_state)
@@ -875,5 +2359,62 @@ namespace signalr
         {
             const_cast<signalr::logger &>(logger).log(level, entry);
         }
+
+        static bool next_reconnect_delay(const std::shared_ptr<reconnect_policy>& reconnect_policy, const reconnect_context& context,
+            const logger& logger, std::chrono::milliseconds& delay)
+        {
+            try
+            {
+                if (!reconnect_policy->next_delay(context, delay))
+                {
+                    utility::ostringstream_t oss;
+                    oss << _XPLATSTR("reconnect policy stopped reconnecting after ") << context.failed_attempts
+                        << _XPLATSTR(" failed attempt(s)");
+                    log(logger, trace_level::info, oss.str());
+
+                    return false;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                log(logger, trace_level::errors, utility::string_t(_XPLATSTR("reconnect policy threw an exception: "))
+                    .append(utility::conversions::to_string_t(e.what())));
+                return false;
+            }
+            catch (...)
+            {
+                log(logger, trace_level::errors, _XPLATSTR("reconnect policy threw an unknown exception"));
+                return false;
+            }
+
+            delay = std::max(delay, std::chrono::milliseconds::zero());
+            return true;
+        }
+
+        static void dispatch(const std::shared_ptr<event_loop>& event_loop, const std::function<void()>& work)
+        {
+            if (event_loop)
+            {
+                event_loop->post(work);
+            }
+            else
+            {
+                work();
+            }
+        }
+
+        static pplx::task<void> delay(const std::shared_ptr<timer_queue>& timer_queue, std::chrono::milliseconds delay)
+        {
+            if (!timer_queue)
+            {
+                return pplx::create_task([delay]() { std::this_thread::sleep_for(delay); });
+            }
+
+            // the delay is cancelled if the timer queue is destroyed before it elapses
+            pplx::task_completion_event<void> delay_tce;
+            timer_queue->schedule(delay, [delay_tce]() { delay_tce.set(); },
+                [delay_tce]() { delay_tce.set_exception(pplx::task_canceled()); });
+            return pplx::create_task(delay_tce);
+        }
     }
 }
@@ -4,16 +4,24 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <mutex>
 #include "cpprest/http_client.h"
 #include "signalrclient/trace_level.h"
 #include "signalrclient/connection_state.h"
+#include "signalrclient/connection_statistics.h"
 #include "signalrclient/signalr_client_config.h"
+#include "signalrclient/reconnect_policy.h"
 #include "web_request_factory.h"
 #include "transport_factory.h"
 #include "logger.h"
+#include "log_limiter.h"
 #include "negotiation_response.h"
 #include "event.h"
+#include "endpoint_selector.h"
+#include "keep_alive_watchdog.h"
+#include "dns_cache.h"
+#include "tracking_allocator.h"
 
 namespace signalr
 {
@@ -37,6 +45,7 @@ namespace signalr
 
         ~connection_impl();
 
+        pplx::task<void> prepare();
         pplx::task<void> start();
         pplx::task<void> send(const utility::string_t &data);
         pplx::task<void> stop();
@@ -52,11 +61,101 @@ namespace signalr
         void set_disconnected(const std::function<void()>& disconnected);
         void set_client_config(const signalr_client_config& config);
         void set_reconnect_delay(const int reconnect_delay /*milliseconds*/);
+        void set_reconnect_policy(const std::shared_ptr<reconnect_policy>& reconnect_policy);
+        void set_failover_urls(const std::vector<utility::string_t>& failover_urls);
+        void set_hot_standby(bool hot_standby);
+        void set_reconnect_outbox(size_t max_messages, size_t max_bytes);
+        void set_fast_restart(int max_negotiation_age /*milliseconds*/);
+        void set_speculative_connect(bool speculative_connect);
+
+        reconnect_statistics get_reconnect_statistics() const;
+        connection_statistics get_statistics() const;
+        // adds what only the owner of the connection (i.e. the hub connection) knows to the metrics collected for
+        // the metrics sink - must be set before the client config
+        void set_metrics_collector(const std::function<void(connection_metrics&)>& collect_metrics);
+        // the time the transport received the response that is being processed
+        std::chrono::steady_clock::time_point get_response_received_time() const;
 
         void set_connection_data(const utility::string_t& connection_data);
 
     private:
+        // state shared with the transport callbacks of a standby connection - until the standby connection is promoted
+        // its messages are not processed but the message cursor is tracked so that it can be reconnected later. The
+        // responses the primary connection has not processed yet are kept so that they can be replayed on promotion.
+        struct standby_state
+        {
+            std::mutex lock;
+            bool active;
+            utility::string_t message_id;
+            utility::string_t groups_token;
+            utility::string_t primary_message_id;
+            std::deque<std::pair<utility::string_t, utility::string_t>> pending_responses; // message id, response
+            uint64_t dropped_responses;
+        };
+
+        // what is needed to process the responses received by a transport - shared by the transport callbacks so that it
+        // is not copied for each response
+        struct response_context
+        {
+            response_context(const std::weak_ptr<connection_impl>& connection, const pplx::task_completion_event<void>& connect_request_tce,
+                const pplx::cancellation_token_source& disconnect_cts, const logger& logger,
+                const std::shared_ptr<log_limiter>& stray_message_log_limiter)
+                : connection(connection), connect_request_tce(connect_request_tce), disconnect_cts(disconnect_cts),
+                connection_logger(logger), stray_message_log_limiter(stray_message_log_limiter)
+            { }
+
+            std::weak_ptr<connection_impl> connection;
+            pplx::task_completion_event<void> connect_request_tce;
+            pplx::cancellation_token_source disconnect_cts;
+            logger connection_logger;
+            std::shared_ptr<log_limiter> stray_message_log_limiter;
+        };
+
+        struct standby_connection
+        {
+            std::shared_ptr<signalr::transport> connected_transport;
+            std::shared_ptr<standby_state> state;
+            web::uri base_url;
+            utility::string_t connection_id;
+            utility::string_t connection_token;
+            int reconnect_window;
+            int keep_alive_timeout;
+        };
+
+        // the negotiation of the last started connection - it is reused to restart the connection if fast restart is enabled
+        struct previous_negotiation
+        {
+            negotiation_response response;
+            web::uri base_url;
+            utility::string_t connection_data;
+            std::chrono::steady_clock::time_point negotiated;
+        };
+
+        // added to the metrics sink of the client config
+        class connection_metrics_source : public metrics_source
+        {
+        public:
+            explicit connection_metrics_source(const std::weak_ptr<connection_impl>& connection);
+
+            bool __cdecl collect(connection_metrics& metrics) const override;
+
+        private:
+            std::weak_ptr<connection_impl> m_connection;
+        };
+
+        typedef std::basic_string<utility::char_t, std::char_traits<utility::char_t>, tracking_allocator<utility::char_t>> outbox_string;
+
+        // a message sent while the connection was reconnecting
+        struct outbox_entry
+        {
+            outbox_string data;
+            pplx::task_completion_event<void> sent;
+        };
+
         web::uri m_base_url;
+        mutable std::mutex m_base_url_lock;
+        std::shared_ptr<endpoint_selector> m_endpoint_selector;
+        std::shared_ptr<dns_cache> m_dns_cache;
         utility::string_t m_query_string;
         std::atomic<connection_state> m_connection_state;
         logger m_logger;
@@ -73,27 +172,114 @@ namespace signalr
         pplx::cancellation_token_source m_disconnect_cts;
         std::mutex m_stop_lock;
         event m_start_completed_event;
+        // guards the connection id and token which change when failing over to the standby connection
+        mutable std::mutex m_connection_info_lock;
         utility::string_t m_connection_id;
         utility::string_t m_connection_token;
         utility::string_t m_connection_data;
-        int m_reconnect_window; // in milliseconds
-        int m_reconnect_delay; // in milliseconds
+        std::atomic<int> m_reconnect_window; // in milliseconds
+        std::shared_ptr<reconnect_policy> m_reconnect_policy;
+        std::atomic<uint64_t> m_reconnects;
+        std::atomic<uint64_t> m_successful_reconnects;
+        std::atomic<uint64_t> m_failed_reconnects;
+        std::atomic<uint64_t> m_reconnect_attempts;
+        std::atomic<unsigned int> m_current_reconnect_attempts;
+        std::atomic<unsigned int> m_last_reconnect_attempts;
+        std::atomic<int64_t> m_last_reconnect_duration; // in milliseconds
+        std::shared_ptr<keep_alive_watchdog> m_keep_alive_watchdog;
+        std::atomic<int> m_keep_alive_timeout; // in milliseconds, not positive if the server does not send keep-alives
+        std::atomic<uint64_t> m_keep_alive_watch_id;
+        std::atomic<uint64_t> m_keep_alive_timeouts;
+        std::atomic<int64_t> m_last_keep_alive_detection_time; // in milliseconds
         utility::string_t m_message_id;
         utility::string_t m_groups_token;
+        bool m_hot_standby;
+        std::mutex m_standby_lock;
+        std::shared_ptr<standby_connection> m_standby;
+        bool m_standby_starting;
+        std::shared_ptr<standby_state> m_standby_state; // of the standby connection being started or ready
+        // shared with the transport callbacks which can outlive the connection
+        std::shared_ptr<log_limiter> m_stray_message_log_limiter;
+        mutable std::mutex m_outbox_lock;
+        // the outbox refers to the counters (and to the memory allocator of the client config) through its allocator
+        allocation_counters m_outbox_allocation_counters;
+        std::deque<outbox_entry, tracking_allocator<outbox_entry>> m_outbox;
+        size_t m_outbox_bytes;
+        size_t m_outbox_max_messages;
+        size_t m_outbox_max_bytes;
+        bool m_outbox_flushing;
+        std::shared_ptr<previous_negotiation> m_previous_negotiation;
+        int m_fast_restart_max_negotiation_age; // in milliseconds, fast restart is disabled if not positive
+        bool m_speculative_connect;
+        std::chrono::steady_clock::time_point m_start_time;
+        std::atomic<bool> m_first_message_pending;
+        // statistics counters - updated with relaxed atomics since they are only read to take a snapshot
+        std::atomic<uint64_t> m_frames_received;
+        std::atomic<uint64_t> m_bytes_received;
+        std::atomic<uint64_t> m_frames_parsed;
+        std::atomic<uint64_t> m_parse_errors;
+        std::atomic<uint64_t> m_messages_received;
+        std::atomic<uint64_t> m_messages_sent;
+        std::atomic<uint64_t> m_bytes_sent;
+        // time spent in each state (indexed by `connection_state`) before the last state change, in steady_clock ticks
+        std::atomic<int64_t> m_time_in_state[5];
+        std::atomic<int64_t> m_state_changed_time;
+        // responses are processed one at a time so this does not need to be synchronized
+        std::chrono::steady_clock::time_point m_response_received_time;
+        std::shared_ptr<connection_metrics_source> m_metrics_source;
+        std::function<void(connection_metrics&)> m_collect_metrics;
 
         connection_impl(const utility::string_t& url, const utility::string_t& query_string, trace_level trace_level, const std::shared_ptr<log_writer>& log_writer,
             std::unique_ptr<web_request_factory> web_request_factory, std::unique_ptr<transport_factory> transport_factory);
 
-        pplx::task<std::shared_ptr<transport>> start_transport(negotiation_response negotiation_response);
-        pplx::task<void> send_connect_request(const std::shared_ptr<transport>& transport, const utility::string_t& connection_token,
+        pplx::task<void> negotiate_and_start();
+        pplx::task<void> fast_restart(const previous_negotiation& previous_negotiation);
+        std::shared_ptr<previous_negotiation> get_previous_negotiation() const;
+        void set_negotiation_response(const negotiation_response& negotiation_response);
+
+        // `transport_connected` is set when the transport has connected which happens before the init message is received
+        pplx::task<std::shared_ptr<transport>> start_transport(negotiation_response negotiation_response, const web::uri& base_url,
+            const std::shared_ptr<standby_state>& standby_state = nullptr,
+            const pplx::task_completion_event<void>& transport_connected = pplx::task_completion_event<void>());
+        pplx::task<void> send_connect_request(const std::shared_ptr<transport>& transport, const web::uri& base_url,
+            const utility::string_t& connection_token, const pplx::task_completion_event<void>& connect_request_tce,
+            const pplx::task_completion_event<void>& transport_connected);
+
+        void start_standby();
+        bool promote_standby();
+        void discard_standby(const std::shared_ptr<standby_state>& standby_state);
+        void acknowledge_standby_responses(const utility::string_t& message_id);
+        void stop_standby();
+
+        void process_response(const utility::string_t& response, const pplx::task_completion_event<void>& connect_request_tce,
+            std::chrono::steady_clock::time_point received);
+        static void process_response(const response_context& context, const utility::string_t& response,
+            std::chrono::steady_clock::time_point received);
+        static bool process_standby_response(standby_state& standby_state, const utility::string_t& response,
             const pplx::task_completion_event<void>& connect_request_tce);
 
-        void process_response(const utility::string_t& response, const pplx::task_completion_event<void>& connect_request_tce);
+        bool try_enqueue_outbox(const utility::string_t& data, pplx::task<void>& sent_task);
+        void flush_outbox();
+        void fail_outbox(const std::exception_ptr& error);
 
         pplx::task<void> shutdown();
         void reconnect();
-        pplx::task<bool> try_reconnect(const web::uri& reconnect_url, const utility::datetime::interval_type reconnect_start_time,
-            int reconnect_window, int reconnect_delay, pplx::cancellation_token_source disconnect_cts);
+        pplx::task<bool> try_reconnect(const utility::datetime::interval_type reconnect_start_time, int reconnect_window, const std::shared_ptr<reconnect_policy>& reconnect_policy, const reconnect_context& context,
+            pplx::cancellation_token_source disconnect_cts);
+
+        pplx::task<bool> delay_first_reconnect_attempt(const std::shared_ptr<reconnect_policy>& reconnect_policy,
+            const reconnect_context& context, int reconnect_window, pplx::cancellation_token_source disconnect_cts);
+        pplx::task<void> probe_endpoints();
+        void quarantine_unresolvable_endpoints();
+
+        void start_keep_alive_watch();
+        void stop_keep_alive_watch();
+        void handle_keep_alive_timeout(const std::shared_ptr<transport>& transport, std::chrono::milliseconds time_since_last_activity);
+        web::uri get_base_url() const;
+        void set_base_url(const web::uri& base_url);
+        // the transport is replaced when failing over to the standby connection while other threads use it
+        std::shared_ptr<transport> get_transport() const { return std::atomic_load(&m_transport); }
+        void set_transport(const std::shared_ptr<transport>& transport) { std::atomic_store(&m_transport, transport); }
 
         bool change_state(connection_state old_state, connection_state new_state);
         connection_state change_state(connection_state new_state);
@@ -0,0 +1,173 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include "signalrclient/connection_pool.h"
+
+namespace signalr
+{
+    namespace
+    {
+        template<typename T>
+        void add_state(connection_pool_health& health, const T& connection)
+        {
+            health.connections++;
+            switch (connection->get_connection_state())
+            {
+            case connection_state::connecting:
+                health.connecting++;
+                break;
+            case connection_state::connected:
+                health.connected++;
+                break;
+            case connection_state::reconnecting:
+                health.reconnecting++;
+                break;
+            case connection_state::disconnecting:
+                health.disconnecting++;
+                break;
+            case connection_state::disconnected:
+                health.disconnected++;
+                break;
+            }
+
+            auto reconnect_statistics = connection->get_reconnect_statistics();
+            health.reconnects += reconnect_statistics.reconnects;
+            health.failed_reconnects += reconnect_statistics.failed_reconnects;
+        }
+
+        pplx::task<void> when_all(std::vector<pplx::task<void>>& tasks)
+        {
+            if (tasks.empty())
+            {
+                return pplx::task_from_result();
+            }
+
+            return pplx::when_all(tasks.begin(), tasks.end());
+        }
+    }
+
+    connection_pool::connection_pool(size_t dispatch_thread_count, const signalr_client_config& config)
+        : m_config(config), m_dispatch_pool(dispatch_thread_count), m_timer_queue(std::make_shared<timer_queue>())
+    {
+        if (!m_config.get_http_client_cache())
+        {
+            m_config.set_http_client_cache(std::make_shared<http_client_cache>());
+        }
+    }
+
+    connection_pool::~connection_pool()
+    {
+        // connections can outlive the pool (they are ref counted) but once the pool is gone no one processes their
+        // messages so they have to be stopped
+        try
+        {
+            stop_all().get();
+        }
+        catch (...) // must not throw from destructors
+        { }
+    }
+
+    std::shared_ptr<connection> connection_pool::create_connection(const utility::string_t& url, const utility::string_t& query_string,
+        trace_level trace_level, std::shared_ptr<log_writer> log_writer)
+    {
+        auto connection = std::make_shared<signalr::connection>(url, query_string, trace_level, std::move(log_writer));
+        connection->set_client_config(create_client_config());
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_connections.push_back(connection);
+        return connection;
+    }
+
+    std::shared_ptr<hub_connection> connection_pool::create_hub_connection(const utility::string_t& url, const utility::string_t& query_string,
+        trace_level trace_level, std::shared_ptr<log_writer> log_writer, bool use_default_url)
+    {
+        auto hub_connection = std::make_shared<signalr::hub_connection>(url, query_string, trace_level, std::move(log_writer), use_default_url);
+        hub_connection->set_client_config(create_client_config());
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_hub_connections.push_back(hub_connection);
+        return hub_connection;
+    }
+
+    void connection_pool::remove(const std::shared_ptr<connection>& connection)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_connections.erase(std::remove(m_connections.begin(), m_connections.end(), connection), m_connections.end());
+    }
+
+    void connection_pool::remove(const std::shared_ptr<hub_connection>& hub_connection)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_hub_connections.erase(std::remove(m_hub_connections.begin(), m_hub_connections.end(), hub_connection), m_hub_connections.end());
+    }
+
+    pplx::task<void> connection_pool::start_all()
+    {
+        std::vector<pplx::task<void>> tasks;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& connection : m_connections)
+        {
+            if (connection->get_connection_state() == connection_state::disconnected)
+            {
+                tasks.push_back(connection->start());
+            }
+        }
+
+        for (auto& hub_connection : m_hub_connections)
+        {
+            if (hub_connection->get_connection_state() == connection_state::disconnected)
+            {
+                tasks.push_back(hub_connection->start());
+            }
+        }
+
+        return when_all(tasks);
+    }
+
+    pplx::task<void> connection_pool::stop_all()
+    {
+        std::vector<pplx::task<void>> tasks;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (auto& connection : m_connections)
+        {
+            tasks.push_back(connection->stop());
+        }
+
+        for (auto& hub_connection : m_hub_connections)
+        {
+            tasks.push_back(hub_connection->stop());
+        }
+
+        return when_all(tasks);
+    }
+
+    connection_pool_health connection_pool::get_health() const
+    {
+        connection_pool_health health = {};
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (const auto& connection : m_connections)
+        {
+            add_state(health, connection);
+        }
+
+        for (const auto& hub_connection : m_hub_connections)
+        {
+            add_state(health, hub_connection);
+        }
+
+        return health;
+    }
+
+    signalr_client_config connection_pool::create_client_config()
+    {
+        auto config = m_config;
+        config.set_event_loop(m_dispatch_pool.get_event_loop());
+        config.set_timer_queue(m_timer_queue);
+        return config;
+    }
+}
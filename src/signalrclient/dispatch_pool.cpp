@@ -0,0 +1,161 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/dispatch_pool.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace signalr
+{
+    namespace
+    {
+        void set_current_thread_name(const utility::string_t& name);
+        void set_current_thread_affinity(const std::vector<unsigned int>& cpus);
+    }
+
+    dispatch_pool::dispatch_pool(size_t thread_count, const utility::string_t& thread_name_prefix, const std::vector<unsigned int>& cpu_affinity,
+        std::chrono::microseconds spin_duration)
+        : m_next_event_loop(0), m_start_time(std::chrono::steady_clock::now())
+    {
+        if (thread_count == 0)
+        {
+            throw std::invalid_argument("thread_count must be greater than 0");
+        }
+
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            m_event_loops.push_back(std::make_shared<event_loop>());
+            m_thread_names.push_back(thread_name_prefix + _XPLATSTR("-") + utility::conversions::to_string_t(std::to_string(i)));
+        }
+
+        for (size_t i = 0; i < thread_count; ++i)
+        {
+            auto loop = m_event_loops[i];
+            auto thread_name = m_thread_names[i];
+
+            m_threads.push_back(std::thread([loop, thread_name, cpu_affinity, spin_duration]()
+            {
+                set_current_thread_name(thread_name);
+                set_current_thread_affinity(cpu_affinity);
+
+                while (true)
+                {
+                    try
+                    {
+                        loop->run(spin_duration);
+                        return;
+                    }
+                    catch (...)
+                    {
+                        // work items are not supposed to throw (the connection catches exceptions from the user's
+                        // callbacks) - there is no one to report the exception to so keep the thread running
+                    }
+                }
+            }));
+        }
+    }
+
+    dispatch_pool::~dispatch_pool()
+    {
+        for (auto& loop : m_event_loops)
+        {
+            loop->stop();
+        }
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    std::shared_ptr<event_loop> dispatch_pool::get_event_loop()
+    {
+        return m_event_loops[m_next_event_loop.fetch_add(1, std::memory_order_relaxed) % m_event_loops.size()];
+    }
+
+    size_t dispatch_pool::get_thread_count() const
+    {
+        return m_threads.size();
+    }
+
+    std::vector<dispatch_thread_statistics> dispatch_pool::get_statistics() const
+    {
+        auto uptime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start_time);
+
+        std::vector<dispatch_thread_statistics> statistics;
+        for (size_t i = 0; i < m_event_loops.size(); ++i)
+        {
+            auto loop_statistics = m_event_loops[i]->get_statistics();
+
+            dispatch_thread_statistics thread_statistics;
+            thread_statistics.thread_name = m_thread_names[i];
+            thread_statistics.executed_work_items = loop_statistics.executed_work_items;
+            thread_statistics.busy_time = loop_statistics.busy_time;
+            thread_statistics.uptime = uptime;
+            thread_statistics.pending_work_items = loop_statistics.pending_work_items;
+            statistics.push_back(thread_statistics);
+        }
+
+        return statistics;
+    }
+
+    namespace
+    {
+        void set_current_thread_name(const utility::string_t& name)
+        {
+#if defined(__linux__)
+            // thread names on Linux are limited to 15 characters
+            auto utf8_name = utility::conversions::to_utf8string(name).substr(0, 15);
+            pthread_setname_np(pthread_self(), utf8_name.c_str());
+#elif defined(_WIN32)
+            // SetThreadDescription is available since Windows 10 1607 only so it is looked up at runtime
+            typedef HRESULT (WINAPI *set_thread_description_fn)(HANDLE, PCWSTR);
+            auto set_thread_description = reinterpret_cast<set_thread_description_fn>(
+                GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "SetThreadDescription"));
+            if (set_thread_description)
+            {
+                set_thread_description(GetCurrentThread(), name.c_str());
+            }
+#else
+            (void)name;
+#endif
+        }
+
+        void set_current_thread_affinity(const std::vector<unsigned int>& cpus)
+        {
+            if (cpus.empty())
+            {
+                return;
+            }
+
+#if defined(_WIN32)
+            DWORD_PTR mask = 0;
+            for (auto cpu : cpus)
+            {
+                if (cpu < sizeof(DWORD_PTR) * 8)
+                {
+                    mask |= static_cast<DWORD_PTR>(1) << cpu;
+                }
+            }
+
+            SetThreadAffinityMask(GetCurrentThread(), mask);
+#elif defined(__linux__)
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            for (auto cpu : cpus)
+            {
+                if (cpu < CPU_SETSIZE)
+                {
+                    CPU_SET(cpu, &cpu_set);
+                }
+            }
+
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+#endif
+        }
+    }
+}
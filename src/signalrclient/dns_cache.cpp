@@ -0,0 +1,236 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "dns_cache.h"
+#include "signalrclient/signalr_exception.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#endif
+
+namespace signalr
+{
+    namespace
+    {
+        const std::chrono::milliseconds default_time_to_live(60000);
+        const std::chrono::milliseconds default_failure_time_to_live(5000);
+
+        std::once_flag default_dns_cache_created;
+        std::shared_ptr<dns_cache>* default_dns_cache;
+
+#ifdef _WIN32
+        std::once_flag winsock_initialized;
+#endif
+    }
+
+    std::shared_ptr<dns_cache> dns_cache::get_default()
+    {
+        std::call_once(default_dns_cache_created, []()
+        {
+            // intentionally never deleted - lookups running on the thread pool may still be completing when the
+            // process is exiting
+            default_dns_cache = new std::shared_ptr<dns_cache>(
+                dns_cache::create(&dns_cache::resolve_host, default_time_to_live, default_failure_time_to_live));
+        });
+
+        return *default_dns_cache;
+    }
+
+    std::shared_ptr<dns_cache> dns_cache::create(const resolver& resolver, std::chrono::milliseconds time_to_live,
+        std::chrono::milliseconds failure_time_to_live, const clock& clock)
+    {
+        return std::shared_ptr<dns_cache>(new dns_cache(resolver, time_to_live, failure_time_to_live, clock));
+    }
+
+    dns_cache::dns_cache(const resolver& resolver, std::chrono::milliseconds time_to_live,
+        std::chrono::milliseconds failure_time_to_live, const clock& clock)
+        : m_resolver(resolver), m_time_to_live(time_to_live), m_failure_time_to_live(failure_time_to_live), m_clock(clock),
+        m_lookups(0), m_hits(0), m_stale_hits(0)
+    { }
+
+    pplx::task<std::vector<utility::string_t>> dns_cache::resolve(const utility::string_t& host)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto iter = m_entries.find(host);
+        if (iter == m_entries.end())
+        {
+            host_entry new_entry;
+            new_entry.resolved = false;
+            new_entry.lookup_pending = false;
+            iter = m_entries.insert(std::make_pair(host, new_entry)).first;
+        }
+
+        auto& entry = iter->second;
+        if (entry.resolved)
+        {
+            if (m_clock() < entry.expires)
+            {
+                m_hits++;
+                return to_task(entry.result);
+            }
+
+            // a failure is not served once expired - the caller waits for the new lookup instead
+            if (!entry.result.error)
+            {
+                if (!entry.lookup_pending)
+                {
+                    start_lookup(host, entry);
+                }
+
+                m_stale_hits++;
+                return to_task(entry.result);
+            }
+        }
+
+        if (!entry.lookup_pending)
+        {
+            start_lookup(host, entry);
+        }
+
+        return entry.lookup.then(&dns_cache::to_task);
+    }
+
+    dns_cache::host_status dns_cache::get_status(const utility::string_t& host)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto iter = m_entries.find(host);
+        if (iter == m_entries.end() || !iter->second.resolved)
+        {
+            return host_status::unknown;
+        }
+
+        auto& entry = iter->second;
+        if (!(m_clock() < entry.expires) && !entry.lookup_pending)
+        {
+            start_lookup(host, entry);
+        }
+
+        return entry.result.error ? host_status::unresolvable : host_status::resolved;
+    }
+
+    dns_cache_statistics dns_cache::get_statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        dns_cache_statistics statistics;
+        statistics.lookups = m_lookups;
+        statistics.hits = m_hits;
+        statistics.stale_hits = m_stale_hits;
+        return statistics;
+    }
+
+    void dns_cache::start_lookup(const utility::string_t& host, host_entry& entry)
+    {
+        m_lookups++;
+        entry.lookup_pending = true;
+
+        auto resolver = m_resolver;
+        auto weak_cache = std::weak_ptr<dns_cache>(shared_from_this());
+
+        entry.lookup = pplx::create_task([resolver, host]()
+        {
+            lookup_result result;
+            try
+            {
+                result.addresses = resolver(host);
+            }
+            catch (...)
+            {
+                result.error = std::current_exception();
+            }
+
+            return result;
+        })
+        .then([weak_cache, host](lookup_result result)
+        {
+            auto cache = weak_cache.lock();
+            if (cache)
+            {
+                cache->complete_lookup(host, result);
+            }
+
+            return result;
+        });
+    }
+
+    void dns_cache::complete_lookup(const utility::string_t& host, const lookup_result& result)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto& entry = m_entries[host];
+        entry.lookup_pending = false;
+
+        // if refreshing a resolved host failed the stale addresses are kept (and served) for a while instead of the
+        // error - the resolver may just be temporarily unavailable
+        if (result.error && entry.resolved && !entry.result.error)
+        {
+            entry.expires = m_clock() + m_failure_time_to_live;
+            return;
+        }
+
+        entry.resolved = true;
+        entry.result = result;
+        entry.expires = m_clock() + (result.error ? m_failure_time_to_live : m_time_to_live);
+    }
+
+    pplx::task<std::vector<utility::string_t>> dns_cache::to_task(const lookup_result& result)
+    {
+        if (result.error)
+        {
+            return pplx::task_from_exception<std::vector<utility::string_t>>(result.error);
+        }
+
+        return pplx::task_from_result(result.addresses);
+    }
+
+    std::vector<utility::string_t> dns_cache::resolve_host(const utility::string_t& host)
+    {
+#ifdef _WIN32
+        std::call_once(winsock_initialized, []()
+        {
+            WSADATA wsa_data;
+            WSAStartup(MAKEWORD(2, 2), &wsa_data);
+        });
+#endif
+
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* addresses = nullptr;
+        auto error = getaddrinfo(utility::conversions::to_utf8string(host).c_str(), nullptr, &hints, &addresses);
+        if (error != 0)
+        {
+            throw signalr_exception(utility::string_t(_XPLATSTR("could not resolve host: ")).append(host)
+                .append(_XPLATSTR(", error code: ")).append(utility::conversions::to_string_t(std::to_string(error))));
+        }
+
+        std::vector<utility::string_t> result;
+        for (auto address = addresses; address != nullptr; address = address->ai_next)
+        {
+            char buffer[INET6_ADDRSTRLEN] = {};
+            const void* raw_address = address->ai_family == AF_INET
+                ? static_cast<const void*>(&reinterpret_cast<const sockaddr_in*>(address->ai_addr)->sin_addr)
+                : static_cast<const void*>(&reinterpret_cast<const sockaddr_in6*>(address->ai_addr)->sin6_addr);
+
+            if ((address->ai_family == AF_INET || address->ai_family == AF_INET6) &&
+                inet_ntop(address->ai_family, raw_address, buffer, sizeof(buffer)) != nullptr)
+            {
+                result.push_back(utility::conversions::to_string_t(std::string(buffer)));
+            }
+        }
+
+        freeaddrinfo(addresses);
+        return result;
+    }
+}
@@ -0,0 +1,106 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "pplx/pplxtasks.h"
+#include "cpprest/details/basic_types.h"
+
+namespace signalr
+{
+    struct dns_cache_statistics
+    {
+        // number of times the resolver was invoked
+        uint64_t lookups;
+        // number of `resolve` calls served from a fresh entry
+        uint64_t hits;
+        // number of `resolve` calls served from an expired entry that was being refreshed in the background
+        uint64_t stale_hits;
+    };
+
+    // Caches the addresses of host names resolved asynchronously on the thread pool. Concurrent lookups of the same
+    // host share a single resolver call. Expired entries are still served while they are refreshed in the background
+    // so that callers of `resolve` and `get_status` do not wait for a slow resolver once a host has been resolved.
+    // Failed lookups are cached for a short time. Thread safe.
+    // Note: connections use the cache only to find endpoints whose host names cannot be resolved. The cached
+    // addresses are not passed to the http and websocket clients, which resolve the host names on their own.
+    class dns_cache : public std::enable_shared_from_this<dns_cache>
+    {
+    public:
+        // returns the addresses of the host or throws if the host cannot be resolved
+        typedef std::function<std::vector<utility::string_t>(const utility::string_t& host)> resolver;
+        typedef std::function<std::chrono::steady_clock::time_point()> clock;
+
+        enum class host_status
+        {
+            unknown,
+            resolved,
+            unresolvable
+        };
+
+        // the cache shared by all the connections in the process
+        static std::shared_ptr<dns_cache> get_default();
+
+        static std::shared_ptr<dns_cache> create(const resolver& resolver, std::chrono::milliseconds time_to_live,
+            std::chrono::milliseconds failure_time_to_live, const clock& clock = &std::chrono::steady_clock::now);
+
+        dns_cache(const dns_cache&) = delete;
+
+        dns_cache& operator=(const dns_cache&) = delete;
+
+        pplx::task<std::vector<utility::string_t>> resolve(const utility::string_t& host);
+
+        // never blocks - returns what is known about the host and starts refreshing the entry if it expired
+        host_status get_status(const utility::string_t& host);
+
+        dns_cache_statistics get_statistics() const;
+
+        // resolves the host with getaddrinfo
+        static std::vector<utility::string_t> resolve_host(const utility::string_t& host);
+
+    private:
+        dns_cache(const resolver& resolver, std::chrono::milliseconds time_to_live, std::chrono::milliseconds failure_time_to_live,
+            const clock& clock);
+
+        // the lookup task never throws so that a failed background refresh that no one waits for is not an
+        // unobserved exception
+        struct lookup_result
+        {
+            std::vector<utility::string_t> addresses;
+            std::exception_ptr error;
+        };
+
+        struct host_entry
+        {
+            bool resolved;
+            lookup_result result;
+            std::chrono::steady_clock::time_point expires;
+            bool lookup_pending;
+            pplx::task<lookup_result> lookup;
+        };
+
+        resolver m_resolver;
+        std::chrono::milliseconds m_time_to_live;
+        std::chrono::milliseconds m_failure_time_to_live;
+        clock m_clock;
+
+        mutable std::mutex m_lock;
+        std::unordered_map<utility::string_t, host_entry> m_entries;
+        uint64_t m_lookups;
+        uint64_t m_hits;
+        uint64_t m_stale_hits;
+
+        // must be called with the lock held
+        void start_lookup(const utility::string_t& host, host_entry& entry);
+        void complete_lookup(const utility::string_t& host, const lookup_result& result);
+
+        static pplx::task<std::vector<utility::string_t>> to_task(const lookup_result& result);
+    };
+}
@@ -0,0 +1,140 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include "endpoint_selector.h"
+
+namespace signalr
+{
+    namespace
+    {
+        const double round_trip_time_smoothing_factor = 0.2;
+        const std::chrono::milliseconds base_quarantine_time(1000);
+        const std::chrono::milliseconds max_quarantine_time(60000);
+    }
+
+    endpoint_selector::endpoint_selector(const web::uri& url, const clock& clock)
+        : m_clock(clock)
+    {
+        set_endpoints(std::vector<web::uri> { url });
+    }
+
+    void endpoint_selector::set_endpoints(const std::vector<web::uri>& urls)
+    {
+        _ASSERTE(!urls.empty());
+
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        m_endpoints.clear();
+        for (const auto& url : urls)
+        {
+            m_endpoints.push_back(endpoint{ url, -1.0, 0, std::chrono::steady_clock::time_point() });
+        }
+    }
+
+    std::vector<web::uri> endpoint_selector::get_endpoints() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        std::vector<web::uri> urls;
+        for (const auto& endpoint : m_endpoints)
+        {
+            urls.push_back(endpoint.url);
+        }
+
+        return urls;
+    }
+
+    web::uri endpoint_selector::select() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto now = m_clock();
+        const endpoint* best = nullptr;
+        for (const auto& endpoint : m_endpoints)
+        {
+            if (endpoint.quarantined_until > now)
+            {
+                continue;
+            }
+
+            // endpoints without measurements are preferred so that they get measured
+            if (best == nullptr || (best->round_trip_time_ms >= 0 && endpoint.round_trip_time_ms < best->round_trip_time_ms))
+            {
+                best = &endpoint;
+            }
+        }
+
+        if (best == nullptr)
+        {
+            best = &*std::min_element(m_endpoints.begin(), m_endpoints.end(), [](const endpoint& e1, const endpoint& e2)
+            {
+                return e1.quarantined_until < e2.quarantined_until;
+            });
+        }
+
+        return best->url;
+    }
+
+    void endpoint_selector::record_success(const web::uri& url, std::chrono::milliseconds round_trip_time)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto endpoint = find(url);
+        if (endpoint)
+        {
+            endpoint->round_trip_time_ms = endpoint->round_trip_time_ms < 0
+                ? round_trip_time.count()
+                : endpoint->round_trip_time_ms + round_trip_time_smoothing_factor * (round_trip_time.count() - endpoint->round_trip_time_ms);
+            endpoint->consecutive_failures = 0;
+            endpoint->quarantined_until = std::chrono::steady_clock::time_point();
+        }
+    }
+
+    void endpoint_selector::record_failure(const web::uri& url)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto endpoint = find(url);
+        if (endpoint)
+        {
+            auto quarantine_time = base_quarantine_time;
+            for (auto i = 0U; i < endpoint->consecutive_failures && quarantine_time < max_quarantine_time; ++i)
+            {
+                quarantine_time *= 2;
+            }
+
+            endpoint->consecutive_failures++;
+            endpoint->quarantined_until = m_clock() + std::min(quarantine_time, max_quarantine_time);
+        }
+    }
+
+    bool endpoint_selector::is_quarantined(const web::uri& url) const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        for (const auto& endpoint : m_endpoints)
+        {
+            if (endpoint.url == url)
+            {
+                return endpoint.quarantined_until > m_clock();
+            }
+        }
+
+        return false;
+    }
+
+    endpoint_selector::endpoint* endpoint_selector::find(const web::uri& url)
+    {
+        for (auto& endpoint : m_endpoints)
+        {
+            if (endpoint.url == url)
+            {
+                return &endpoint;
+            }
+        }
+
+        return nullptr;
+    }
+}
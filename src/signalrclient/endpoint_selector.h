@@ -0,0 +1,54 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "cpprest/base_uri.h"
+
+namespace signalr
+{
+    // Tracks the health and the round trip time of a set of equivalent endpoints and picks the one the connection
+    // should use. An endpoint that fails is quarantined (circuit breaker) for a period that doubles with each
+    // consecutive failure. Once the quarantine expires the endpoint can be selected again and a single success
+    // closes the breaker. Thread safe.
+    class endpoint_selector
+    {
+    public:
+        typedef std::function<std::chrono::steady_clock::time_point()> clock;
+
+        explicit endpoint_selector(const web::uri& url, const clock& clock = &std::chrono::steady_clock::now);
+
+        // the first url is the preferred one if there are no measurements
+        void set_endpoints(const std::vector<web::uri>& urls);
+        std::vector<web::uri> get_endpoints() const;
+
+        // returns the healthy endpoint with the lowest round trip time. If all the endpoints are quarantined the one
+        // whose quarantine ends first is returned
+        web::uri select() const;
+
+        void record_success(const web::uri& url, std::chrono::milliseconds round_trip_time);
+        void record_failure(const web::uri& url);
+
+        bool is_quarantined(const web::uri& url) const;
+
+    private:
+        struct endpoint
+        {
+            web::uri url;
+            // exponentially weighted moving average, negative if not measured yet
+            double round_trip_time_ms;
+            unsigned int consecutive_failures;
+            std::chrono::steady_clock::time_point quarantined_until;
+        };
+
+        clock m_clock;
+        mutable std::mutex m_lock;
+        std::vector<endpoint> m_endpoints;
+
+        endpoint* find(const web::uri& url);
+    };
+}
@@ -0,0 +1,153 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/event_loop.h"
+
+namespace signalr
+{
+    namespace
+    {
+        // hints the CPU that the thread is busy waiting which saves power and frees resources for the sibling
+        // hyper-thread
+        inline void cpu_relax()
+        {
+#if defined(_WIN32)
+            YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#endif
+        }
+    }
+
+    event_loop::event_loop()
+        : m_stop_requested(false), m_pending_work_items(0), m_executed_work_items(0), m_busy_time_ns(0)
+    { }
+
+    void event_loop::post(const std::function<void()>& work)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_work_items.push_back(work);
+            m_pending_work_items.fetch_add(1, std::memory_order_release);
+        }
+
+        m_work_available.notify_one();
+    }
+
+    bool event_loop::run_once()
+    {
+        std::function<void()> work;
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_work_items.empty())
+            {
+                return false;
+            }
+
+            work = std::move(m_work_items.front());
+            m_work_items.pop_front();
+            m_pending_work_items.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // exceptions thrown by work items posted by the user are propagated to the caller
+        execute(work);
+        return true;
+    }
+
+    void event_loop::run()
+    {
+        run(std::chrono::microseconds::zero());
+    }
+
+    void event_loop::run(std::chrono::microseconds spin_duration)
+    {
+        while (true)
+        {
+            std::function<void()> work;
+
+            if (spin_duration > std::chrono::microseconds::zero())
+            {
+                spin(spin_duration);
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_work_available.wait(lock, [this]() { return m_stop_requested || !m_work_items.empty(); });
+
+                if (m_stop_requested)
+                {
+                    // allows running the loop again after it was stopped
+                    m_stop_requested = false;
+                    return;
+                }
+
+                work = std::move(m_work_items.front());
+                m_work_items.pop_front();
+                m_pending_work_items.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            execute(work);
+        }
+    }
+
+    void event_loop::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_stop_requested = true;
+        }
+
+        m_work_available.notify_all();
+    }
+
+    event_loop_statistics event_loop::get_statistics() const
+    {
+        event_loop_statistics statistics;
+        statistics.executed_work_items = m_executed_work_items.load(std::memory_order_relaxed);
+        statistics.busy_time = std::chrono::nanoseconds(m_busy_time_ns.load(std::memory_order_relaxed));
+        statistics.pending_work_items = m_pending_work_items.load(std::memory_order_relaxed);
+        return statistics;
+    }
+
+    // returns as soon as there is work to execute, the loop is being stopped or `spin_duration` has elapsed in which
+    // case the caller blocks on the condition variable
+    void event_loop::spin(std::chrono::microseconds spin_duration) const
+    {
+        auto deadline = std::chrono::steady_clock::now() + spin_duration;
+
+        while (m_pending_work_items.load(std::memory_order_acquire) == 0 && !m_stop_requested.load(std::memory_order_relaxed))
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return;
+            }
+
+            cpu_relax();
+        }
+    }
+
+    void event_loop::execute(const std::function<void()>& work)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        // the work item counts as executed and its time as busy time even if it throws
+        struct update_statistics
+        {
+            event_loop& loop;
+            std::chrono::steady_clock::time_point start;
+
+            ~update_statistics()
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+                loop.m_busy_time_ns.fetch_add(elapsed.count(), std::memory_order_relaxed);
+                loop.m_executed_work_items.fetch_add(1, std::memory_order_relaxed);
+            }
+        } update{ *this, start };
+
+        work();
+    }
+}
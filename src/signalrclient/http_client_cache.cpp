@@ -0,0 +1,49 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/http_client_cache.h"
+
+namespace signalr
+{
+    http_client_cache::http_client_cache()
+        : m_requests(0), m_hits(0)
+    { }
+
+    std::shared_ptr<web::http::client::http_client> http_client_cache::get_client(const web::uri& url,
+        const web::http::client::http_client_config& http_client_config)
+    {
+        m_requests++;
+
+        auto base_url = web::uri_builder()
+            .set_scheme(url.scheme())
+            .set_host(url.host())
+            .set_port(url.port())
+            .to_uri();
+
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto key = base_url.to_string();
+        auto iter = m_clients.find(key);
+        if (iter != m_clients.end())
+        {
+            m_hits++;
+            return iter->second;
+        }
+
+        auto client = std::make_shared<web::http::client::http_client>(base_url, http_client_config);
+        m_clients.insert(std::make_pair(key, client));
+        return client;
+    }
+
+    http_client_cache_statistics http_client_cache::get_statistics() const
+    {
+        http_client_cache_statistics statistics;
+        statistics.requests = m_requests.load();
+        statistics.hits = m_hits.load();
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        statistics.hosts = m_clients.size();
+        return statistics;
+    }
+}
@@ -16,6 +16,11 @@ namespace signalr
     // undefinded behavior since we are using an incomplete type. More details here:  http://herbsutter.com/gotw/_100/
     hub_connection::~hub_connection() = default;
 
+    pplx::task<void> hub_connection::prepare()
+    {
+        return m_pImpl->prepare();
+    }
+
     pplx::task<void> hub_connection::start()
     {
         return m_pImpl->start();
@@ -66,4 +71,54 @@ namespace signalr
     {
         m_pImpl->set_client_config(config);
     }
+
+    void hub_connection::set_reconnect_policy(const std::shared_ptr<reconnect_policy>& reconnect_policy)
+    {
+        m_pImpl->set_reconnect_policy(reconnect_policy);
+    }
+
+    reconnect_statistics hub_connection::get_reconnect_statistics() const
+    {
+        return m_pImpl->get_reconnect_statistics();
+    }
+
+    connection_statistics hub_connection::get_statistics() const
+    {
+        return m_pImpl->get_statistics();
+    }
+
+    std::vector<invocation_latency> hub_connection::get_invocation_latencies() const
+    {
+        return m_pImpl->get_invocation_latencies(/*reset*/ false);
+    }
+
+    std::vector<invocation_latency> hub_connection::reset_invocation_latencies()
+    {
+        return m_pImpl->get_invocation_latencies(/*reset*/ true);
+    }
+
+    void hub_connection::set_failover_urls(const std::vector<utility::string_t>& failover_urls)
+    {
+        m_pImpl->set_failover_urls(failover_urls);
+    }
+
+    void hub_connection::set_hot_standby(bool hot_standby)
+    {
+        m_pImpl->set_hot_standby(hot_standby);
+    }
+
+    void hub_connection::set_fast_restart(int max_negotiation_age)
+    {
+        m_pImpl->set_fast_restart(max_negotiation_age);
+    }
+
+    void hub_connection::set_speculative_connect(bool speculative_connect)
+    {
+        m_pImpl->set_speculative_connect(speculative_connect);
+    }
+
+    void hub_connection::set_reconnect_outbox(size_t max_messages, size_t max_bytes)
+    {
+        m_pImpl->set_reconnect_outbox(max_messages, max_bytes);
+    }
 }
\ No newline at end of file
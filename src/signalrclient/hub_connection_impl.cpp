@@ -6,6 +6,7 @@
 #include "signalrclient/hub_exception.h"
 #include "trace_log_writer.h"
 #include "make_unique.h"
+#include "trace_probes.h"
 #include "signalrclient/signalr_exception.h"
 
 namespace signalr
@@ -45,8 +46,9 @@ namespace signalr
         const std::shared_ptr<log_writer>& log_writer, bool use_default_url, std::unique_ptr<web_request_factory> web_request_factory,
         std::unique_ptr<transport_factory> transport_factory)
         : m_connection(connection_impl::create(adapt_url(url, use_default_url), query_string, trace_level, log_writer,
-        std::move(web_request_factory), std::move(transport_factory))),m_logger(log_writer, trace_level),
-        m_callback_manager(json::value::parse(_XPLATSTR("{ \"E\" : \"connection went out of scope before invocation result was received\"}")))
+        std::move(web_request_factory), std::move(transport_factory))), m_use_default_url(use_default_url), m_logger(log_writer, trace_level),
+        m_callback_manager(json::value::parse(_XPLATSTR("{ \"E\" : \"connection went out of scope before invocation result was received\"}"))),
+        m_invocation_latencies(nullptr), m_record_invocation_latencies(false)
     { }
 
     void hub_connection_impl::initialize()
@@ -65,6 +67,16 @@ namespace signalr
             }
         });
 
+        m_connection->set_metrics_collector([weak_hub_connection](connection_metrics& metrics)
+        {
+            auto connection = weak_hub_connection.lock();
+            if (connection)
+            {
+                connection->add_invocation_statistics(metrics.statistics);
+                metrics.invocation_latencies = connection->get_invocation_latencies(/*reset*/ false);
+            }
+        });
+
         set_reconnecting([](){});
     }
 
@@ -92,6 +104,11 @@ namespace signalr
         return proxy;
     }
 
+    pplx::task<void> hub_connection_impl::prepare()
+    {
+        return m_connection->prepare();
+    }
+
     pplx::task<void> hub_connection_impl::start()
     {
         if (m_proxies.size() > 0)
@@ -140,24 +157,43 @@ namespace signalr
             {
                 auto hub_name = message.at(_XPLATSTR("H")).as_string();
                 auto method = message.at(_XPLATSTR("M")).as_string();
+                SIGNALRCLIENT_PROBE2(hub_dispatch, hub_name.c_str(), method.c_str());
                 auto iter = m_proxies.find(hub_name);
                 if (iter != m_proxies.end())
                 {
-                    iter->second->invoke_event(method, message.at(_XPLATSTR("A")));
+                    if (m_invocation_tracer)
+                    {
+                        auto trace_handle = m_invocation_tracer->event_received(hub_name, method);
+                        iter->second->invoke_event(method, message.at(_XPLATSTR("A")));
+                        m_invocation_tracer->event_handled(trace_handle);
+                    }
+                    else
+                    {
+                        iter->second->invoke_event(method, message.at(_XPLATSTR("A")));
+                    }
                 }
                 else
                 {
-                    m_logger.log(trace_level::info,
-                        utility::string_t(_XPLATSTR("no proxy found for hub invocation. hub: "))
-                        .append(hub_name).append(_XPLATSTR(", method: ")).append(method));
+                    uint64_t suppressed;
+                    if (m_logger.is_enabled(trace_level::info) && m_unhandled_invocation_log_limiter.try_acquire(suppressed))
+                    {
+                        m_logger.log(trace_level::info, log_limiter::append_suppressed(
+                            utility::string_t(_XPLATSTR("no proxy found for hub invocation. hub: "))
+                            .append(hub_name).append(_XPLATSTR(", method: ")).append(method), suppressed));
+                    }
                 }
 
                 return;
             }
         }
 
-        m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("non-hub message received and will be discarded. message: "))
-            .append(message.serialize()));
+        uint64_t suppressed;
+        if (m_logger.is_enabled(trace_level::info) && m_unhandled_message_log_limiter.try_acquire(suppressed))
+        {
+            m_logger.log(trace_level::info, log_limiter::append_suppressed(
+                utility::string_t(_XPLATSTR("non-hub message received and will be discarded. message: "))
+                .append(message.serialize()), suppressed));
+        }
     }
 
     bool hub_connection_impl::invoke_callback(const web::json::value& message)
@@ -169,9 +205,12 @@ namespace signalr
             auto callback_id = id_source.at(_XPLATSTR("I")).as_string();
 
             // callbacks must not be removed for progress updates
-            if (!m_callback_manager.invoke_callback(callback_id, message, /*remove_callback*/ !is_progress))
+            uint64_t suppressed;
+            if (!m_callback_manager.invoke_callback(callback_id, message, /*remove_callback*/ !is_progress) &&
+                m_logger.is_enabled(trace_level::info) && m_unhandled_callback_log_limiter.try_acquire(suppressed))
             {
-                m_logger.log(trace_level::info, utility::string_t(_XPLATSTR("no callback found for id: ")).append(callback_id));
+                m_logger.log(trace_level::info, log_limiter::append_suppressed(
+                    utility::string_t(_XPLATSTR("no callback found for id: ")).append(callback_id), suppressed));
             }
 
             return true;
@@ -183,39 +222,119 @@ namespace signalr
     pplx::task<json::value> hub_connection_impl::invoke_json(const utility::string_t& hub_name, const utility::string_t& method_name,
         const json::value& arguments, const std::function<void(const json::value&)>& on_progress)
     {
-        _ASSERTE(arguments.is_array());
-
         pplx::task_completion_event<json::value> tce;
 
-        const auto callback_id = m_callback_manager.register_callback(
-            create_hub_invocation_callback(m_logger, [tce](const json::value& result) { tce.set(result); },
-                [tce](const std::exception_ptr e) { tce.set_exception(e); }, on_progress));
-
-        invoke_hub_method(hub_name, method_name, arguments, callback_id,
-            [tce](const std::exception_ptr e){tce.set_exception(e); });
+        invoke(hub_name, method_name, arguments, [tce](const json::value& result, const std::exception_ptr e)
+        {
+            if (e)
+            {
+                tce.set_exception(e);
+            }
+            else
+            {
+                tce.set(result);
+            }
+        }, on_progress);
 
         return pplx::create_task(tce);
     }
 
     pplx::task<void> hub_connection_impl::invoke_void(const utility::string_t& hub_name, const utility::string_t& method_name,
         const json::value& arguments, const std::function<void(const json::value&)>& on_progress)
+    {
+        pplx::task_completion_event<void> tce;
+
+        invoke(hub_name, method_name, arguments, [tce](const json::value&, const std::exception_ptr e)
+        {
+            if (e)
+            {
+                tce.set_exception(e);
+            }
+            else
+            {
+                tce.set();
+            }
+        }, on_progress);
+
+        return pplx::create_task(tce);
+    }
+
+    // on_completed is invoked exactly once - either with the result or with the exception (in which case the result is
+    // null). It runs on the thread that completed the invocation (typically the thread that received the response)
+    // so it should not block.
+    void hub_connection_impl::invoke(const utility::string_t& hub_name, const utility::string_t& method_name,
+        const json::value& arguments, const std::function<void(const json::value&, const std::exception_ptr)>& on_completed,
+        const std::function<void(const json::value&)>& on_progress)
     {
         _ASSERTE(arguments.is_array());
 
-        pplx::task_completion_event<void> tce;
+        // null if latencies are not recorded
+        auto latency = m_record_invocation_latencies
+            ? get_invocation_latency_recorders(hub_name, method_name)
+            : std::shared_ptr<invocation_latency_recorders>();
+        auto invoked = std::chrono::steady_clock::now();
+        auto weak_connection = std::weak_ptr<connection_impl>(m_connection);
+        auto tracer = m_invocation_tracer;
+        std::shared_ptr<void> trace_handle;
+        if (tracer)
+        {
+            trace_handle = tracer->invocation_started(hub_name, method_name);
+        }
+
+        auto invocation_callback = create_hub_invocation_callback(m_logger,
+            [on_completed](const json::value& result) { on_completed(result, nullptr); },
+            [on_completed](const std::exception_ptr e) { on_completed(json::value::null(), e); }, on_progress);
 
         const auto callback_id = m_callback_manager.register_callback(
-            create_hub_invocation_callback(m_logger, [tce](const json::value&) { tce.set(); },
-            [tce](const std::exception_ptr e){ tce.set_exception(e); }, on_progress));
+            [invocation_callback, latency, invoked, weak_connection, tracer, trace_handle](const json::value& message)
+            {
+                auto is_progress = message.has_field(_XPLATSTR("P"));
 
-        invoke_hub_method(hub_name, method_name, arguments, callback_id,
-            [tce](const std::exception_ptr e){tce.set_exception(e); });
+                // only the final response from the server completes the invocation - invocations completed because the
+                // connection was stopped do not have the invocation id and progress updates (which have their own id
+                // and carry the invocation id in "P") must not be counted as completions. Recorded before the result
+                // is passed on so that the latency is visible to the caller once the invocation completes.
+                if (message.has_field(_XPLATSTR("I")) && !is_progress)
+                {
+                    auto completed = std::chrono::steady_clock::now();
+                    auto round_trip = std::chrono::duration_cast<std::chrono::microseconds>(completed - invoked);
+                    SIGNALRCLIENT_PROBE2(invocation_complete, message.at(_XPLATSTR("I")).as_string().c_str(),
+                        static_cast<int64_t>(round_trip.count()));
+                    if (latency)
+                    {
+                        latency->round_trip.record(round_trip);
+
+                        auto connection = weak_connection.lock();
+                        if (connection)
+                        {
+                            latency->response_dispatch.record(std::chrono::duration_cast<std::chrono::microseconds>(
+                                completed - connection->get_response_received_time()));
+                        }
+                    }
 
-        return pplx::create_task(tce);
+                    if (tracer)
+                    {
+                        tracer->result_received(trace_handle);
+                    }
+                }
+
+                invocation_callback(message);
+
+                // the invocation completes with the result or the error - not with a progress update
+                if (tracer && !is_progress)
+                {
+                    tracer->invocation_completed(trace_handle);
+                }
+            });
+
+        invoke_hub_method(hub_name, method_name, arguments, callback_id,
+            [on_completed](const std::exception_ptr e) { on_completed(json::value::null(), e); }, latency, invoked, trace_handle);
     }
 
     void hub_connection_impl::invoke_hub_method(const utility::string_t& hub_name, const utility::string_t& method_name,
-        const json::value& arguments, const utility::string_t& callback_id, std::function<void(const std::exception_ptr)> set_exception)
+        const json::value& arguments, const utility::string_t& callback_id, std::function<void(const std::exception_ptr)> set_exception,
+        const std::shared_ptr<invocation_latency_recorders>& latency, std::chrono::steady_clock::time_point invoked,
+        const std::shared_ptr<void>& trace_handle)
     {
         json::value request;
         request[_XPLATSTR("H")] = json::value::string(hub_name);
@@ -227,21 +346,43 @@ namespace signalr
 
         // weak_ptr prevents a circular dependency leading to memory leak and other problems
         auto weak_hub_connection = std::weak_ptr<hub_connection_impl>(this_hub_connection);
+        auto tracer = m_invocation_tracer;
 
+        SIGNALRCLIENT_PROBE3(invocation_send, hub_name.c_str(), method_name.c_str(), callback_id.c_str());
         m_connection->send(request.serialize())
-            .then([set_exception, weak_hub_connection, callback_id](pplx::task<void> send_task)
+            .then([set_exception, weak_hub_connection, callback_id, latency, invoked, tracer, trace_handle](pplx::task<void> send_task)
             {
                 try
                 {
                     send_task.get();
+                    if (latency)
+                    {
+                        latency->send.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - invoked));
+                    }
+
+                    if (tracer)
+                    {
+                        tracer->invocation_sent(trace_handle, nullptr);
+                    }
                 }
                 catch (const std::exception&)
                 {
-                    set_exception(std::current_exception());
+                    if (tracer)
+                    {
+                        tracer->invocation_sent(trace_handle, std::current_exception());
+                    }
+
+                    // if the callback is no longer registered it has already been completed (e.g. the connection was
+                    // stopped or went out of scope) and must not be completed again
                     auto hub_connection = weak_hub_connection.lock();
-                    if (hub_connection)
+                    if (hub_connection && hub_connection->m_callback_manager.remove_callback(callback_id))
                     {
-                        hub_connection->m_callback_manager.remove_callback(callback_id);
+                        set_exception(std::current_exception());
+
+                        if (tracer)
+                        {
+                            tracer->invocation_completed(trace_handle);
+                        }
                     }
                 }
             });
@@ -265,6 +406,133 @@ namespace signalr
     void hub_connection_impl::set_client_config(const signalr_client_config& config)
     {
         m_connection->set_client_config(config);
+        m_callback_manager.set_memory_allocator(config.get_memory_allocator());
+        m_invocation_tracer = config.get_invocation_tracer();
+        m_record_invocation_latencies = config.get_record_invocation_latencies();
+    }
+
+    void hub_connection_impl::set_reconnect_policy(const std::shared_ptr<reconnect_policy>& reconnect_policy)
+    {
+        m_connection->set_reconnect_policy(reconnect_policy);
+    }
+
+    reconnect_statistics hub_connection_impl::get_reconnect_statistics() const
+    {
+        return m_connection->get_reconnect_statistics();
+    }
+
+    connection_statistics hub_connection_impl::get_statistics() const
+    {
+        auto statistics = m_connection->get_statistics();
+        add_invocation_statistics(statistics);
+        return statistics;
+    }
+
+    void hub_connection_impl::add_invocation_statistics(connection_statistics& statistics) const
+    {
+        statistics.pending_invocations = m_callback_manager.get_callback_count();
+
+        auto& allocation_counters = m_callback_manager.get_allocation_counters();
+        statistics.invocation_allocations = allocation_counters.allocations.load(std::memory_order_relaxed);
+        statistics.invocation_allocated_bytes = allocation_counters.allocated_bytes.load(std::memory_order_relaxed);
+        statistics.invocation_bytes_in_use = allocation_counters.get_bytes_in_use();
+    }
+
+    std::shared_ptr<hub_connection_impl::invocation_latency_recorders> hub_connection_impl::get_invocation_latency_recorders(
+        const utility::string_t& hub_name, const utility::string_t& method_name)
+    {
+        auto find_entry = [&hub_name, &method_name](const invocation_latency_entry* entry)
+        {
+            for (; entry != nullptr; entry = entry->next)
+            {
+                if (entry->recorders->method_name == method_name && entry->recorders->hub_name == hub_name)
+                {
+                    break;
+                }
+            }
+
+            return entry;
+        };
+
+        auto entry = find_entry(m_invocation_latencies.load(std::memory_order_acquire));
+        if (entry)
+        {
+            return entry->recorders;
+        }
+
+        std::lock_guard<std::mutex> lock(m_invocation_latencies_lock);
+
+        // the method could have been invoked for the first time on another thread in the meantime
+        auto head = m_invocation_latencies.load(std::memory_order_relaxed);
+        entry = find_entry(head);
+        if (entry)
+        {
+            return entry->recorders;
+        }
+
+        auto new_entry = std::unique_ptr<invocation_latency_entry>(new invocation_latency_entry());
+        new_entry->recorders = std::make_shared<invocation_latency_recorders>();
+        new_entry->recorders->hub_name = hub_name;
+        new_entry->recorders->method_name = method_name;
+        new_entry->next = head;
+        m_invocation_latencies.store(new_entry.get(), std::memory_order_release);
+        m_invocation_latency_entries.push_back(std::move(new_entry));
+
+        return m_invocation_latency_entries.back()->recorders;
+    }
+
+    std::vector<invocation_latency> hub_connection_impl::get_invocation_latencies(bool reset)
+    {
+        std::vector<std::shared_ptr<invocation_latency_recorders>> recorders;
+        for (auto entry = m_invocation_latencies.load(std::memory_order_acquire); entry != nullptr; entry = entry->next)
+        {
+            recorders.push_back(entry->recorders);
+        }
+
+        std::vector<invocation_latency> latencies;
+        for (const auto& recorder : recorders)
+        {
+            invocation_latency latency;
+            latency.hub_name = recorder->hub_name;
+            latency.method_name = recorder->method_name;
+            latency.round_trip = recorder->round_trip.get_snapshot(reset);
+            latency.send = recorder->send.get_snapshot(reset);
+            latency.response_dispatch = recorder->response_dispatch.get_snapshot(reset);
+            latencies.push_back(latency);
+        }
+
+        return latencies;
+    }
+
+    void hub_connection_impl::set_failover_urls(const std::vector<utility::string_t>& failover_urls)
+    {
+        std::vector<utility::string_t> adapted_urls;
+        for (const auto& url : failover_urls)
+        {
+            adapted_urls.push_back(adapt_url(url, m_use_default_url));
+        }
+
+        m_connection->set_failover_urls(adapted_urls);
+    }
+
+    void hub_connection_impl::set_hot_standby(bool hot_standby)
+    {
+        m_connection->set_hot_standby(hot_standby);
+    }
+
+    void hub_connection_impl::set_fast_restart(int max_negotiation_age)
+    {
+        m_connection->set_fast_restart(max_negotiation_age);
+    }
+
+    void hub_connection_impl::set_speculative_connect(bool speculative_connect)
+    {
+        m_connection->set_speculative_connect(speculative_connect);
+    }
+
+    void hub_connection_impl::set_reconnect_outbox(size_t max_messages, size_t max_bytes)
+    {
+        m_connection->set_reconnect_outbox(max_messages, max_bytes);
     }
 
     void hub_connection_impl::set_reconnecting(const std::function<void()>& reconnecting)
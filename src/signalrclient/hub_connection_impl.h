@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include "cpprest/details/basic_types.h"
 #include "connection_impl.h"
 #include "internal_hub_proxy.h"
 #include "callback_manager.h"
+#include "log_limiter.h"
+#include "latency_recorder.h"
 #include "case_insensitive_comparison_utils.h"
 
 namespace signalr
@@ -35,7 +38,11 @@ namespace signalr
             const std::function<void(const json::value&)>& on_progress = [](const json::value&){});
         pplx::task<void> invoke_void(const utility::string_t& hub_name, const utility::string_t& method_name, const json::value& arguments,
             const std::function<void(const json::value&)>& on_progress = [](const json::value&){});
+        void invoke(const utility::string_t& hub_name, const utility::string_t& method_name, const json::value& arguments,
+            const std::function<void(const json::value&, const std::exception_ptr)>& on_completed,
+            const std::function<void(const json::value&)>& on_progress = [](const json::value&){});
 
+        pplx::task<void> prepare();
         pplx::task<void> start();
         pplx::task<void> stop();
 
@@ -44,6 +51,15 @@ namespace signalr
         utility::string_t get_connection_token() const;
 
         void set_client_config(const signalr_client_config& config);
+        void set_reconnect_policy(const std::shared_ptr<reconnect_policy>& reconnect_policy);
+        reconnect_statistics get_reconnect_statistics() const;
+        connection_statistics get_statistics() const;
+        std::vector<invocation_latency> get_invocation_latencies(bool reset);
+        void set_failover_urls(const std::vector<utility::string_t>& failover_urls);
+        void set_hot_standby(bool hot_standby);
+        void set_reconnect_outbox(size_t max_messages, size_t max_bytes);
+        void set_fast_restart(int max_negotiation_age);
+        void set_speculative_connect(bool speculative_connect);
         void set_reconnecting(const std::function<void()>& reconnecting);
         void set_reconnected(const std::function<void()>& reconnected);
         void set_disconnected(const std::function<void()>& disconnected);
@@ -54,17 +70,49 @@ namespace signalr
             std::unique_ptr<web_request_factory> web_request_factory, std::unique_ptr<transport_factory> transport_factory);
 
         std::shared_ptr<connection_impl> m_connection;
+        bool m_use_default_url;
         logger m_logger;
         callback_manager m_callback_manager;
+        // limit the entries logged for unexpected messages which can be received at a high rate
+        log_limiter m_unhandled_invocation_log_limiter;
+        log_limiter m_unhandled_message_log_limiter;
+        log_limiter m_unhandled_callback_log_limiter;
         std::unordered_map<utility::string_t, std::shared_ptr<internal_hub_proxy>, case_insensitive_hash, case_insensitive_equals> m_proxies;
 
+        struct invocation_latency_recorders
+        {
+            utility::string_t hub_name;
+            utility::string_t method_name;
+            latency_recorder round_trip;
+            latency_recorder send;
+            latency_recorder response_dispatch;
+        };
+
+        struct invocation_latency_entry
+        {
+            std::shared_ptr<invocation_latency_recorders> recorders;
+            const invocation_latency_entry* next;
+        };
+
+        // one entry per hub name and method name. Entries are only ever prepended to the list (under the lock) so once
+        // a method has been invoked its recorders are found without allocating or taking a lock.
+        std::atomic<const invocation_latency_entry*> m_invocation_latencies;
+        std::vector<std::unique_ptr<invocation_latency_entry>> m_invocation_latency_entries;
+        std::mutex m_invocation_latencies_lock;
+        std::shared_ptr<invocation_tracer> m_invocation_tracer;
+        bool m_record_invocation_latencies;
 
         void initialize();
 
         void process_message(const web::json::value& message);
 
         void invoke_hub_method(const utility::string_t& hub_name, const utility::string_t& method_name,
-            const json::value& arguments, const utility::string_t& callback_id, std::function<void(const std::exception_ptr)> set_exception);
+            const json::value& arguments, const utility::string_t& callback_id, std::function<void(const std::exception_ptr)> set_exception,
+            const std::shared_ptr<invocation_latency_recorders>& latency, std::chrono::steady_clock::time_point invoked,
+            const std::shared_ptr<void>& trace_handle);
+        std::shared_ptr<invocation_latency_recorders> get_invocation_latency_recorders(const utility::string_t& hub_name,
+            const utility::string_t& method_name);
         bool invoke_callback(const web::json::value& message);
+        void add_invocation_statistics(connection_statistics& statistics) const;
     };
 }
@@ -69,6 +69,17 @@ namespace signalr
         return m_pImpl->invoke_void(method_name, arguments, on_progress);
     }
 
+    void hub_proxy::invoke(const utility::string_t& method_name, const web::json::value& arguments,
+        const invocation_completed_handler& on_completed, const on_progress_handler& on_progress)
+    {
+        if (!m_pImpl)
+        {
+            throw signalr_exception(_XPLATSTR("invoke() cannot be called on uninitialized hub_proxy instance"));
+        }
+
+        m_pImpl->invoke(method_name, arguments, on_completed, on_progress);
+    }
+
     hub_proxy& hub_proxy::operator=(const hub_proxy& other)
     {
         if (this != &other)
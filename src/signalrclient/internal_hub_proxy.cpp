@@ -48,9 +48,13 @@ namespace signalr
         }
         else
         {
-            m_logger.log(trace_level::info,
-                utility::string_t(_XPLATSTR("no handler found for event. hub name: "))
-                .append(m_hub_name).append(_XPLATSTR(", event name: ")).append(event_name));
+            uint64_t suppressed;
+            if (m_logger.is_enabled(trace_level::info) && m_unhandled_event_log_limiter.try_acquire(suppressed))
+            {
+                m_logger.log(trace_level::info, log_limiter::append_suppressed(
+                    utility::string_t(_XPLATSTR("no handler found for event. hub name: "))
+                    .append(m_hub_name).append(_XPLATSTR(", event name: ")).append(event_name), suppressed));
+            }
         }
     }
 
@@ -79,4 +83,19 @@ namespace signalr
 
         return connection->invoke_void(get_hub_name(), method_name, arguments, on_progress);
     }
+
+    void internal_hub_proxy::invoke(const utility::string_t& method_name, const json::value& arguments,
+        const std::function<void(const json::value&, const std::exception_ptr)>& on_completed,
+        const std::function<void(const json::value&)>& on_progress)
+    {
+        auto connection = m_hub_connection.lock();
+        if (!connection)
+        {
+            on_completed(json::value::null(), std::make_exception_ptr(
+                signalr_exception(_XPLATSTR("the connection for which this hub proxy was created is no longer valid - it was either destroyed or went out of scope"))));
+            return;
+        }
+
+        connection->invoke(get_hub_name(), method_name, arguments, on_completed, on_progress);
+    }
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "cpprest/details/basic_types.h"
 #include "cpprest/json.h"
 #include "logger.h"
+#include "log_limiter.h"
 #include "case_insensitive_comparison_utils.h"
 
 using namespace web;
@@ -31,11 +32,15 @@ namespace signalr
             const std::function<void(const json::value&)>& on_progress = [](const json::value&){});
         pplx::task<void> invoke_void(const utility::string_t& method_name, const json::value& arguments,
             const std::function<void(const json::value&)>& on_progress = [](const json::value&){});
+        void invoke(const utility::string_t& method_name, const json::value& arguments,
+            const std::function<void(const json::value&, const std::exception_ptr)>& on_completed,
+            const std::function<void(const json::value&)>& on_progress = [](const json::value&){});
 
     private:
         std::weak_ptr<hub_connection_impl> m_hub_connection;
         const utility::string_t m_hub_name;
         logger m_logger;
+        log_limiter m_unhandled_event_log_limiter;
 
         std::unordered_map<utility::string_t, std::function<void(const json::value &)>, case_insensitive_hash, case_insensitive_equals> m_subscriptions;
     };
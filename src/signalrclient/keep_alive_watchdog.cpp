@@ -0,0 +1,142 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include <vector>
+#include "keep_alive_watchdog.h"
+
+namespace signalr
+{
+    namespace
+    {
+        // the check interval is a fraction of the shortest watched timeout so that a timeout is detected at most 10%
+        // late, but the timer does not fire more often than every 10 ms or less often than once a second
+        const std::chrono::milliseconds min_check_interval(10);
+        const std::chrono::milliseconds max_check_interval(1000);
+        const int check_interval_divisor = 10;
+
+        std::once_flag default_watchdog_created;
+        std::shared_ptr<keep_alive_watchdog>* default_watchdog;
+    }
+
+    std::shared_ptr<keep_alive_watchdog> keep_alive_watchdog::get_default()
+    {
+        std::call_once(default_watchdog_created, []()
+        {
+            // intentionally never deleted - joining the timer thread while the process is exiting (e.g. when the
+            // library is being unloaded) could deadlock
+            default_watchdog = new std::shared_ptr<keep_alive_watchdog>(keep_alive_watchdog::create());
+        });
+
+        return *default_watchdog;
+    }
+
+    std::shared_ptr<keep_alive_watchdog> keep_alive_watchdog::create()
+    {
+        return std::shared_ptr<keep_alive_watchdog>(new keep_alive_watchdog());
+    }
+
+    keep_alive_watchdog::keep_alive_watchdog()
+        : m_next_watch_id(0), m_check_scheduled(false)
+    { }
+
+    uint64_t keep_alive_watchdog::watch(const std::shared_ptr<transport>& transport, std::chrono::milliseconds timeout,
+        const timeout_callback& on_timeout)
+    {
+        _ASSERTE(timeout > std::chrono::milliseconds::zero());
+
+        std::lock_guard<std::mutex> lock(m_lock);
+
+        auto watch_id = ++m_next_watch_id;
+
+        watch_entry entry;
+        entry.watched_transport = transport;
+        entry.timeout = timeout;
+        entry.on_timeout = on_timeout;
+        entry.watch_started = std::chrono::steady_clock::now();
+        m_entries.insert(std::make_pair(watch_id, entry));
+
+        schedule_check();
+
+        return watch_id;
+    }
+
+    void keep_alive_watchdog::unwatch(uint64_t watch_id)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_entries.erase(watch_id);
+    }
+
+    size_t keep_alive_watchdog::get_watched_count() const
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_entries.size();
+    }
+
+    // must be called with the lock held
+    void keep_alive_watchdog::schedule_check()
+    {
+        if (m_check_scheduled || m_entries.empty())
+        {
+            return;
+        }
+
+        auto check_interval = max_check_interval;
+        for (const auto& entry : m_entries)
+        {
+            check_interval = std::min(check_interval, entry.second.timeout / check_interval_divisor);
+        }
+
+        m_check_scheduled = true;
+
+        auto weak_watchdog = std::weak_ptr<keep_alive_watchdog>(shared_from_this());
+        m_timer_queue.schedule(std::max(check_interval, min_check_interval), [weak_watchdog]()
+        {
+            auto watchdog = weak_watchdog.lock();
+            if (watchdog)
+            {
+                watchdog->check();
+            }
+        });
+    }
+
+    void keep_alive_watchdog::check()
+    {
+        std::vector<std::pair<timeout_callback, std::chrono::milliseconds>> timed_out;
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_check_scheduled = false;
+
+            auto now = std::chrono::steady_clock::now();
+            for (auto iter = m_entries.begin(); iter != m_entries.end();)
+            {
+                auto transport = iter->second.watched_transport.lock();
+                if (!transport)
+                {
+                    iter = m_entries.erase(iter);
+                    continue;
+                }
+
+                auto last_activity = std::max(transport->get_last_activity(), iter->second.watch_started);
+                auto time_since_last_activity = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_activity);
+                if (time_since_last_activity > iter->second.timeout)
+                {
+                    timed_out.push_back(std::make_pair(iter->second.on_timeout, time_since_last_activity));
+                    iter = m_entries.erase(iter);
+                    continue;
+                }
+
+                ++iter;
+            }
+
+            schedule_check();
+        }
+
+        for (const auto& entry : timed_out)
+        {
+            entry.first(entry.second);
+        }
+    }
+}
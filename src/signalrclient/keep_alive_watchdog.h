@@ -0,0 +1,61 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "signalrclient/timer_queue.h"
+#include "transport.h"
+
+namespace signalr
+{
+    // Detects transports that have not received anything (including server keep-alives) for longer than the keep-alive
+    // timeout, which is the only way to notice a half-open connection without waiting for the OS to give up. All the
+    // watched transports are checked from a single periodic timer. Thread safe.
+    class keep_alive_watchdog : public std::enable_shared_from_this<keep_alive_watchdog>
+    {
+    public:
+        typedef std::function<void(std::chrono::milliseconds time_since_last_activity)> timeout_callback;
+
+        // the watchdog shared by all the connections in the process
+        static std::shared_ptr<keep_alive_watchdog> get_default();
+
+        static std::shared_ptr<keep_alive_watchdog> create();
+
+        keep_alive_watchdog(const keep_alive_watchdog&) = delete;
+
+        keep_alive_watchdog& operator=(const keep_alive_watchdog&) = delete;
+
+        // `on_timeout` is invoked at most once, on the timer thread, after which the transport is no longer watched.
+        // The transport is considered active when the watch starts (e.g. it has just been reconnected) even if it has
+        // not received anything for longer than the timeout. Returns the id to pass to `unwatch`.
+        uint64_t watch(const std::shared_ptr<transport>& transport, std::chrono::milliseconds timeout, const timeout_callback& on_timeout);
+        void unwatch(uint64_t watch_id);
+
+        size_t get_watched_count() const;
+
+    private:
+        keep_alive_watchdog();
+
+        struct watch_entry
+        {
+            std::weak_ptr<transport> watched_transport;
+            std::chrono::milliseconds timeout;
+            timeout_callback on_timeout;
+            std::chrono::steady_clock::time_point watch_started;
+        };
+
+        timer_queue m_timer_queue;
+        mutable std::mutex m_lock;
+        std::unordered_map<uint64_t, watch_entry> m_entries;
+        uint64_t m_next_watch_id;
+        bool m_check_scheduled;
+
+        void schedule_check();
+        void check();
+    };
+}
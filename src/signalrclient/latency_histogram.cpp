@@ -0,0 +1,200 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "signalrclient/latency_histogram.h"
+#include "latency_recorder.h"
+
+namespace signalr
+{
+    namespace
+    {
+        // values below 2^exact_bits are counted exactly, above they are bucketed by their highest bit and the
+        // sub_bucket_bits bits below it
+        const int exact_bits = 6;
+        const int sub_bucket_bits = 5;
+        const int max_magnitude = 35;
+
+        const uint64_t exact_values = 1ULL << exact_bits;
+        const uint64_t sub_bucket_count = 1ULL << sub_bucket_bits;
+
+        int get_magnitude(uint64_t value)
+        {
+            auto magnitude = 0;
+            while (value >>= 1)
+            {
+                magnitude++;
+            }
+
+            return magnitude;
+        }
+
+        void update_min(std::atomic<uint64_t>& min, uint64_t value)
+        {
+            auto current = min.load(std::memory_order_relaxed);
+            while (value < current && !min.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            { }
+        }
+
+        void update_max(std::atomic<uint64_t>& max, uint64_t value)
+        {
+            auto current = max.load(std::memory_order_relaxed);
+            while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            { }
+        }
+    }
+
+    const size_t latency_histogram::bucket_count =
+        static_cast<size_t>(exact_values + (max_magnitude - exact_bits + 1) * sub_bucket_count);
+
+    latency_histogram::latency_histogram()
+        : m_counts(bucket_count), m_count(0), m_min(std::numeric_limits<uint64_t>::max()), m_max(0), m_sum(0)
+    { }
+
+    size_t latency_histogram::get_bucket_index(uint64_t value)
+    {
+        if (value < exact_values)
+        {
+            return static_cast<size_t>(value);
+        }
+
+        auto magnitude = get_magnitude(value);
+        if (magnitude > max_magnitude)
+        {
+            return bucket_count - 1;
+        }
+
+        auto sub_bucket = (value >> (magnitude - sub_bucket_bits)) & (sub_bucket_count - 1);
+        return static_cast<size_t>(exact_values + (magnitude - exact_bits) * sub_bucket_count + sub_bucket);
+    }
+
+    uint64_t latency_histogram::get_bucket_upper_bound(size_t index)
+    {
+        if (index < exact_values)
+        {
+            return index;
+        }
+
+        auto magnitude = static_cast<int>((index - exact_values) / sub_bucket_count) + exact_bits;
+        auto sub_bucket = (index - exact_values) % sub_bucket_count;
+        auto sub_bucket_width = 1ULL << (magnitude - sub_bucket_bits);
+        return (1ULL << magnitude) + (sub_bucket + 1) * sub_bucket_width - 1;
+    }
+
+    void latency_histogram::record(std::chrono::microseconds value)
+    {
+        auto microseconds = static_cast<uint64_t>(std::max<std::chrono::microseconds::rep>(value.count(), 0));
+
+        m_counts[get_bucket_index(microseconds)]++;
+        m_count++;
+        m_min = std::min(m_min, microseconds);
+        m_max = std::max(m_max, microseconds);
+        m_sum += microseconds;
+    }
+
+    void latency_histogram::merge(const latency_histogram& other)
+    {
+        for (size_t i = 0; i < bucket_count; i++)
+        {
+            m_counts[i] += other.m_counts[i];
+        }
+
+        m_count += other.m_count;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+        m_sum += other.m_sum;
+    }
+
+    uint64_t latency_histogram::get_count() const
+    {
+        return m_count;
+    }
+
+    std::chrono::microseconds latency_histogram::get_min() const
+    {
+        return std::chrono::microseconds(m_count > 0 ? m_min : 0);
+    }
+
+    std::chrono::microseconds latency_histogram::get_max() const
+    {
+        return std::chrono::microseconds(m_max);
+    }
+
+    std::chrono::microseconds latency_histogram::get_mean() const
+    {
+        return std::chrono::microseconds(m_count > 0 ? m_sum / m_count : 0);
+    }
+
+    std::chrono::microseconds latency_histogram::get_sum() const
+    {
+        return std::chrono::microseconds(m_sum);
+    }
+
+    std::chrono::microseconds latency_histogram::get_value_at_percentile(double percentile) const
+    {
+        if (m_count == 0)
+        {
+            return std::chrono::microseconds(0);
+        }
+
+        percentile = std::min(std::max(percentile, 0.0), 100.0);
+        auto target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percentile / 100 * m_count)), 1);
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; i++)
+        {
+            seen += m_counts[i];
+            if (seen >= target)
+            {
+                // the bucket bounds are not exact - the recorded extremes are
+                return std::chrono::microseconds(std::min(std::max(get_bucket_upper_bound(i), m_min), m_max));
+            }
+        }
+
+        return std::chrono::microseconds(m_max);
+    }
+
+    latency_recorder::latency_recorder()
+        : m_counts(new std::atomic<uint64_t>[latency_histogram::bucket_count]), m_min(std::numeric_limits<uint64_t>::max()),
+        m_max(0), m_sum(0)
+    {
+        for (size_t i = 0; i < latency_histogram::bucket_count; i++)
+        {
+            m_counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void latency_recorder::record(std::chrono::microseconds value)
+    {
+        auto microseconds = static_cast<uint64_t>(std::max<std::chrono::microseconds::rep>(value.count(), 0));
+
+        m_counts[latency_histogram::get_bucket_index(microseconds)].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(microseconds, std::memory_order_relaxed);
+        update_min(m_min, microseconds);
+        update_max(m_max, microseconds);
+    }
+
+    latency_histogram latency_recorder::get_snapshot(bool reset)
+    {
+        latency_histogram histogram;
+        for (size_t i = 0; i < latency_histogram::bucket_count; i++)
+        {
+            auto count = reset ? m_counts[i].exchange(0, std::memory_order_relaxed) : m_counts[i].load(std::memory_order_relaxed);
+            histogram.m_counts[i] = count;
+            histogram.m_count += count;
+        }
+
+        if (histogram.m_count > 0)
+        {
+            histogram.m_sum = reset ? m_sum.exchange(0, std::memory_order_relaxed) : m_sum.load(std::memory_order_relaxed);
+            histogram.m_min = reset ? m_min.exchange(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed)
+                : m_min.load(std::memory_order_relaxed);
+            histogram.m_max = reset ? m_max.exchange(0, std::memory_order_relaxed) : m_max.load(std::memory_order_relaxed);
+        }
+
+        return histogram;
+    }
+}
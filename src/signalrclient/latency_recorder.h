@@ -0,0 +1,34 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "signalrclient/latency_histogram.h"
+
+namespace signalr
+{
+    // Records latencies into `latency_histogram` buckets from multiple threads without taking locks - recording a
+    // value is a few relaxed atomic operations.
+    class latency_recorder
+    {
+    public:
+        latency_recorder();
+
+        latency_recorder(const latency_recorder&) = delete;
+        latency_recorder& operator=(const latency_recorder&) = delete;
+
+        void record(std::chrono::microseconds value);
+
+        // values recorded while the snapshot is taken may be missing from it (and are then in the next snapshot if
+        // `reset` is true) but they are never lost or counted twice - only the min, max and mean may be slightly off
+        latency_histogram get_snapshot(bool reset);
+
+    private:
+        std::unique_ptr<std::atomic<uint64_t>[]> m_counts;
+        std::atomic<uint64_t> m_min;
+        std::atomic<uint64_t> m_max;
+        std::atomic<uint64_t> m_sum;
+    };
+}
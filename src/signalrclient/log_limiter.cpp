@@ -0,0 +1,49 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <string>
+#include "log_limiter.h"
+
+namespace signalr
+{
+    log_limiter::log_limiter(uint64_t max_entries, std::chrono::milliseconds interval, uint64_t sample_rate)
+        : m_max_entries(max_entries), m_interval(interval), m_sample_rate(sample_rate),
+        m_interval_start(std::chrono::steady_clock::now().time_since_epoch().count()), m_entries(0), m_suppressed(0)
+    { }
+
+    bool log_limiter::try_acquire(uint64_t& suppressed)
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+        auto interval_start = m_interval_start.load(std::memory_order_relaxed);
+        if (now - interval_start >= m_interval.count() &&
+            m_interval_start.compare_exchange_strong(interval_start, now, std::memory_order_relaxed))
+        {
+            // entries counted concurrently by other threads may be attributed to the new interval which only makes
+            // the limit approximate
+            m_entries.store(0, std::memory_order_relaxed);
+        }
+
+        auto entry = m_entries.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (entry <= m_max_entries || (m_sample_rate > 0 && (entry - m_max_entries) % m_sample_rate == 0))
+        {
+            suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    utility::string_t log_limiter::append_suppressed(utility::string_t entry, uint64_t suppressed)
+    {
+        if (suppressed > 0)
+        {
+            entry.append(_XPLATSTR(" ("))
+                .append(utility::conversions::to_string_t(std::to_string(suppressed)))
+                .append(_XPLATSTR(" similar entries suppressed)"));
+        }
+
+        return entry;
+    }
+}
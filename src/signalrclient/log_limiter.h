@@ -0,0 +1,42 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "cpprest/details/basic_types.h"
+
+namespace signalr
+{
+    // Limits how often an entry logged from a single call site (e.g. for every unexpected message received) is
+    // written. Within each interval the first `max_entries` entries are logged and after that only every
+    // `sample_rate`-th entry (none if `sample_rate` is 0). The next entry that is logged carries the number of entries
+    // suppressed before it. Each call site has its own limiter, owned by the object that logs. Errors should not be
+    // limited.
+    class log_limiter
+    {
+    public:
+        explicit log_limiter(uint64_t max_entries = 10, std::chrono::milliseconds interval = std::chrono::seconds(1),
+            uint64_t sample_rate = 1000);
+
+        log_limiter(const log_limiter&) = delete;
+        log_limiter& operator=(const log_limiter&) = delete;
+
+        // thread safe - returns true if the entry should be logged in which case `suppressed` is set to the number
+        // of entries suppressed since the last entry that was logged
+        bool try_acquire(uint64_t& suppressed);
+
+        // appends the number of suppressed entries (if any) to the entry
+        static utility::string_t append_suppressed(utility::string_t entry, uint64_t suppressed);
+
+    private:
+        const uint64_t m_max_entries;
+        const std::chrono::steady_clock::duration m_interval;
+        const uint64_t m_sample_rate;
+        std::atomic<int64_t> m_interval_start; // steady_clock ticks
+        std::atomic<uint64_t> m_entries;
+        std::atomic<uint64_t> m_suppressed;
+    };
+}
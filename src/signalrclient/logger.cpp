@@ -9,30 +9,74 @@
 namespace signalr
 {
     logger::logger(const std::shared_ptr<log_writer>& log_writer, trace_level trace_level)
-        : m_log_writer(log_writer), m_trace_level(trace_level)
+        : m_log_writer(log_writer), m_async_log_writer(std::dynamic_pointer_cast<async_log_writer>(log_writer)),
+        m_binary_log_writer(std::dynamic_pointer_cast<binary_log_writer>(log_writer)), m_trace_level(trace_level)
     { }
 
     void logger::log(trace_level level, const utility::string_t& entry)
     {
-        if ((level & m_trace_level) != trace_level::none)
+        if (is_enabled(level))
         {
-            try
+            write(level, log_event::text, utility::string_t(), entry);
+        }
+    }
+
+    void logger::log(trace_level level, log_event event, const utility::string_t& connection_id, const utility::string_t& payload)
+    {
+        if (is_enabled(level))
+        {
+            write(level, event, connection_id, payload);
+        }
+    }
+
+    void logger::write(trace_level level, log_event event, const utility::string_t& connection_id, const utility::string_t& payload)
+    {
+        try
+        {
+            if (m_binary_log_writer)
             {
-                utility::ostringstream_t os;
-                os << utility::datetime::utc_now().to_string(utility::datetime::date_format::ISO_8601) << _XPLATSTR(" [")
-                    << std::left << std::setw(12) << translate_trace_level(level) << "] "<< entry << std::endl;
-                m_log_writer->write(os.str());
+                m_binary_log_writer->write_event(level, event, connection_id, utility::datetime::utc_now(), payload);
             }
-            catch (const std::exception &e)
+            else if (m_async_log_writer)
             {
-                ucerr << _XPLATSTR("error occurred when logging: ") << utility::conversions::to_string_t(e.what())
-                    << std::endl << _XPLATSTR("    entry: ") << entry << std::endl;
+                m_async_log_writer->enqueue(level, event, connection_id, std::chrono::steady_clock::now(), payload);
             }
-            catch (...)
+            else
             {
-                ucerr << _XPLATSTR("unknown error occurred when logging") << std::endl << _XPLATSTR("    entry: ") << entry << std::endl;
+                m_log_writer->write(format_entry(level, utility::datetime::utc_now(),
+                    event == log_event::text ? payload : format_event(event, payload)));
             }
         }
+        catch (const std::exception &e)
+        {
+            ucerr << _XPLATSTR("error occurred when logging: ") << utility::conversions::to_string_t(e.what())
+                << std::endl << _XPLATSTR("    entry: ") << payload << std::endl;
+        }
+        catch (...)
+        {
+            ucerr << _XPLATSTR("unknown error occurred when logging") << std::endl << _XPLATSTR("    entry: ") << payload << std::endl;
+        }
+    }
+
+    utility::string_t logger::format_event(log_event event, const utility::string_t& payload)
+    {
+        switch (event)
+        {
+        case log_event::message_received:
+            return utility::string_t(_XPLATSTR("processing message: ")).append(payload);
+        case log_event::message_sent:
+            return utility::string_t(_XPLATSTR("sending data: ")).append(payload);
+        default:
+            return payload;
+        }
+    }
+
+    utility::string_t logger::format_entry(trace_level level, const utility::datetime& timestamp, const utility::string_t& entry)
+    {
+        utility::ostringstream_t os;
+        os << timestamp.to_string(utility::datetime::date_format::ISO_8601) << _XPLATSTR(" [")
+            << std::left << std::setw(12) << translate_trace_level(level) << "] "<< entry << std::endl;
+        return os.str();
     }
 
     utility::string_t logger::translate_trace_level(trace_level trace_level)
@@ -4,8 +4,18 @@
 #pragma once
 
 #include <memory>
+#include "cpprest/asyncrt_utils.h"
 #include "signalrclient/trace_level.h"
 #include "signalrclient/log_writer.h"
+#include "signalrclient/async_log_writer.h"
+#include "signalrclient/binary_log_writer.h"
+
+// The trace levels (a `trace_level` mask) the library is compiled with. Entries for levels not in the mask are never
+// logged regardless of the trace level of the connection and the code logging them is removed by the compiler where
+// it is guarded with `logger::is_enabled`. E.g. -DSIGNALRCLIENT_TRACE_LEVEL_MASK=24 keeps only errors and info.
+#ifndef SIGNALRCLIENT_TRACE_LEVEL_MASK
+#define SIGNALRCLIENT_TRACE_LEVEL_MASK 31
+#endif
 
 namespace signalr
 {
@@ -14,12 +24,33 @@ namespace signalr
     public:
         logger(const std::shared_ptr<log_writer>& log_writer, trace_level trace_level);
 
+        // allows skipping building the entry when it would not be logged - call sites logging per message should
+        // check it first
+        bool is_enabled(trace_level level) const
+        {
+            return (static_cast<int>(level) & SIGNALRCLIENT_TRACE_LEVEL_MASK) != 0 && (level & m_trace_level) != trace_level::none;
+        }
+
         void log(trace_level level, const utility::string_t& entry);
 
+        // a structured entry - recorded as is by a `binary_log_writer`, other log writers get the entry formatted with
+        // `format_event`
+        void log(trace_level level, log_event event, const utility::string_t& connection_id, const utility::string_t& payload);
+
+        static utility::string_t format_event(log_event event, const utility::string_t& payload);
+
+        static utility::string_t format_entry(trace_level level, const utility::datetime& timestamp, const utility::string_t& entry);
+
     private:
         std::shared_ptr<log_writer> m_log_writer;
+        // set if the log writer is an `async_log_writer` in which case entries are formatted on its background thread
+        std::shared_ptr<async_log_writer> m_async_log_writer;
+        // set if the log writer is a `binary_log_writer` which records entries without formatting them
+        std::shared_ptr<binary_log_writer> m_binary_log_writer;
         trace_level m_trace_level;
 
+        void write(trace_level level, log_event event, const utility::string_t& connection_id, const utility::string_t& payload);
+
         static utility::string_t translate_trace_level(trace_level trace_level);
     };
 }
\ No newline at end of file
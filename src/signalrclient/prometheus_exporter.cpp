@@ -0,0 +1,245 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include <functional>
+#include <locale>
+#include <sstream>
+#include "signalrclient/prometheus_exporter.h"
+
+namespace signalr
+{
+    namespace
+    {
+        const char* state_names[] = { "connecting", "connected", "reconnecting", "disconnecting", "disconnected" };
+        const double quantiles[] = { 0.5, 0.9, 0.99 };
+
+        std::string escape_label_value(const utility::string_t& value)
+        {
+            auto utf8_value = utility::conversions::to_utf8string(value);
+
+            std::string escaped;
+            escaped.reserve(utf8_value.size());
+            for (auto c : utf8_value)
+            {
+                switch (c)
+                {
+                case '\\':
+                    escaped.append("\\\\");
+                    break;
+                case '"':
+                    escaped.append("\\\"");
+                    break;
+                case '\n':
+                    escaped.append("\\n");
+                    break;
+                default:
+                    escaped.push_back(c);
+                }
+            }
+
+            return escaped;
+        }
+
+        // the metrics of a source together with the id the exporter assigned to it
+        struct source_metrics
+        {
+            uint64_t source_id;
+            connection_metrics metrics;
+        };
+
+        // the source id identifies the connection - the connection id is empty until the connection is started and
+        // changes on every restart so it would create a new series each time
+        std::string connection_labels(const source_metrics& source)
+        {
+            return std::string("source=\"").append(std::to_string(source.source_id))
+                .append("\",url=\"").append(escape_label_value(source.metrics.url)).append("\"");
+        }
+
+        double to_seconds(std::chrono::microseconds duration)
+        {
+            return std::chrono::duration<double>(duration).count();
+        }
+
+        void write_header(std::ostringstream& output, const char* name, const char* type, const char* help)
+        {
+            output << "# HELP " << name << " " << help << "\n";
+            output << "# TYPE " << name << " " << type << "\n";
+        }
+
+        template<typename T>
+        void write_family(std::ostringstream& output, const std::vector<source_metrics>& connections,
+            const char* name, const char* type, const char* help, std::function<T(const connection_metrics&)> value)
+        {
+            write_header(output, name, type, help);
+            for (auto& source : connections)
+            {
+                output << name << "{" << connection_labels(source) << "} " << value(source.metrics) << "\n";
+            }
+        }
+
+        void write_latency_summary(std::ostringstream& output, const std::vector<source_metrics>& connections,
+            const char* name, const char* help, std::function<const latency_histogram&(const invocation_latency&)> histogram)
+        {
+            write_header(output, name, "summary", help);
+            for (auto& source : connections)
+            {
+                for (auto& latency : source.metrics.invocation_latencies)
+                {
+                    auto labels = connection_labels(source)
+                        .append(",hub=\"").append(escape_label_value(latency.hub_name))
+                        .append("\",method=\"").append(escape_label_value(latency.method_name)).append("\"");
+
+                    auto& values = histogram(latency);
+                    for (auto quantile : quantiles)
+                    {
+                        output << name << "{" << labels << ",quantile=\"" << quantile << "\"} "
+                            << to_seconds(values.get_value_at_percentile(quantile * 100)) << "\n";
+                    }
+
+                    output << name << "_sum{" << labels << "} " << to_seconds(values.get_sum()) << "\n";
+                    output << name << "_count{" << labels << "} " << values.get_count() << "\n";
+                }
+            }
+        }
+    }
+
+    prometheus_exporter::prometheus_exporter()
+        : m_next_source_id(1)
+    { }
+
+    void prometheus_exporter::add_source(const std::shared_ptr<metrics_source>& source)
+    {
+        std::lock_guard<std::mutex> lock(m_sources_lock);
+
+        if (m_sources.find(source) == m_sources.end())
+        {
+            m_sources.insert(std::make_pair(source, m_next_source_id++));
+        }
+    }
+
+    void prometheus_exporter::remove_source(const std::shared_ptr<metrics_source>& source)
+    {
+        std::lock_guard<std::mutex> lock(m_sources_lock);
+
+        m_sources.erase(source);
+    }
+
+    std::string prometheus_exporter::render() const
+    {
+        std::vector<std::pair<uint64_t, std::shared_ptr<metrics_source>>> sources;
+        {
+            std::lock_guard<std::mutex> lock(m_sources_lock);
+            for (auto& source : m_sources)
+            {
+                sources.push_back(std::make_pair(source.second, source.first));
+            }
+        }
+
+        // the sources are keyed by address - they are rendered in the order they were added so that the output is stable
+        std::sort(sources.begin(), sources.end(),
+            [](const std::pair<uint64_t, std::shared_ptr<metrics_source>>& first, const std::pair<uint64_t, std::shared_ptr<metrics_source>>& second)
+            {
+                return first.first < second.first;
+            });
+
+        // sources are collected without holding the lock so that connections can come and go in the meantime
+        std::vector<source_metrics> connections;
+        for (auto& source : sources)
+        {
+            source_metrics metrics;
+            metrics.source_id = source.first;
+            if (source.second->collect(metrics.metrics))
+            {
+                connections.push_back(std::move(metrics));
+            }
+        }
+
+        std::ostringstream output;
+        // the format requires a '.' as the decimal separator regardless of the global locale
+        output.imbue(std::locale::classic());
+
+        write_family<uint64_t>(output, connections, "signalr_frames_received_total", "counter",
+            "Frames received from the transport.", [](const connection_metrics& m) { return m.statistics.frames_received; });
+        write_family<uint64_t>(output, connections, "signalr_bytes_received_total", "counter",
+            "Bytes received from the transport.", [](const connection_metrics& m) { return m.statistics.bytes_received; });
+        write_family<uint64_t>(output, connections, "signalr_frames_parsed_total", "counter",
+            "Frames successfully parsed.", [](const connection_metrics& m) { return m.statistics.frames_parsed; });
+        write_family<uint64_t>(output, connections, "signalr_parse_errors_total", "counter",
+            "Frames that could not be parsed.", [](const connection_metrics& m) { return m.statistics.parse_errors; });
+        write_family<uint64_t>(output, connections, "signalr_messages_received_total", "counter",
+            "Messages passed to the message received callback.", [](const connection_metrics& m) { return m.statistics.messages_received; });
+        write_family<uint64_t>(output, connections, "signalr_messages_sent_total", "counter",
+            "Messages sent to the server.", [](const connection_metrics& m) { return m.statistics.messages_sent; });
+        write_family<uint64_t>(output, connections, "signalr_bytes_sent_total", "counter",
+            "Bytes sent to the server.", [](const connection_metrics& m) { return m.statistics.bytes_sent; });
+        write_family<size_t>(output, connections, "signalr_outbound_queue_depth", "gauge",
+            "Messages waiting to be sent.", [](const connection_metrics& m) { return m.statistics.outbound_queue_depth; });
+        write_family<size_t>(output, connections, "signalr_pending_invocations", "gauge",
+            "Hub method invocations waiting for a result.", [](const connection_metrics& m) { return m.statistics.pending_invocations; });
+        write_family<uint64_t>(output, connections, "signalr_reconnect_attempts_total", "counter",
+            "Reconnect attempts.", [](const connection_metrics& m) { return m.statistics.reconnect_attempts; });
+        write_family<uint64_t>(output, connections, "signalr_keep_alive_timeouts_total", "counter",
+            "Connections lost because nothing was received within the keep-alive timeout.",
+            [](const connection_metrics& m) { return m.reconnects.keep_alive_timeouts; });
+        write_family<int>(output, connections, "signalr_connection_up", "gauge",
+            "1 if the connection is connected, 0 otherwise.",
+            [](const connection_metrics& m) { return m.state == connection_state::connected ? 1 : 0; });
+
+        write_header(output, "signalr_allocations_total", "counter",
+            "Allocations for messages buffered while reconnecting and for pending hub method invocations.");
+        for (auto& source : connections)
+        {
+            output << "signalr_allocations_total{" << connection_labels(source) << ",purpose=\"outbox\"} "
+                << source.metrics.statistics.outbox_allocations << "\n";
+            output << "signalr_allocations_total{" << connection_labels(source) << ",purpose=\"invocation\"} "
+                << source.metrics.statistics.invocation_allocations << "\n";
+        }
+
+        write_header(output, "signalr_allocated_bytes_total", "counter",
+            "Bytes allocated for messages buffered while reconnecting and for pending hub method invocations.");
+        for (auto& source : connections)
+        {
+            output << "signalr_allocated_bytes_total{" << connection_labels(source) << ",purpose=\"outbox\"} "
+                << source.metrics.statistics.outbox_allocated_bytes << "\n";
+            output << "signalr_allocated_bytes_total{" << connection_labels(source) << ",purpose=\"invocation\"} "
+                << source.metrics.statistics.invocation_allocated_bytes << "\n";
+        }
+
+        write_header(output, "signalr_allocated_bytes_in_use", "gauge",
+            "Bytes allocated for messages buffered while reconnecting and for pending hub method invocations that have not been freed.");
+        for (auto& source : connections)
+        {
+            output << "signalr_allocated_bytes_in_use{" << connection_labels(source) << ",purpose=\"outbox\"} "
+                << source.metrics.statistics.outbox_bytes_in_use << "\n";
+            output << "signalr_allocated_bytes_in_use{" << connection_labels(source) << ",purpose=\"invocation\"} "
+                << source.metrics.statistics.invocation_bytes_in_use << "\n";
+        }
+
+        write_header(output, "signalr_connection_state_seconds_total", "counter", "Time spent in each connection state.");
+        for (auto& source : connections)
+        {
+            const std::chrono::milliseconds times[] = { source.metrics.statistics.time_connecting, source.metrics.statistics.time_connected,
+                source.metrics.statistics.time_reconnecting, source.metrics.statistics.time_disconnecting, source.metrics.statistics.time_disconnected };
+
+            for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); i++)
+            {
+                output << "signalr_connection_state_seconds_total{" << connection_labels(source) << ",state=\""
+                    << state_names[i] << "\"} " << to_seconds(times[i]) << "\n";
+            }
+        }
+
+        write_latency_summary(output, connections, "signalr_invocation_round_trip_seconds",
+            "Time between sending a hub method invocation and receiving its result.",
+            [](const invocation_latency& l) -> const latency_histogram& { return l.round_trip; });
+        write_latency_summary(output, connections, "signalr_invocation_send_seconds",
+            "Time to send a hub method invocation.",
+            [](const invocation_latency& l) -> const latency_histogram& { return l.send; });
+        write_latency_summary(output, connections, "signalr_invocation_response_dispatch_seconds",
+            "Time between receiving the result of a hub method invocation and completing the invocation.",
+            [](const invocation_latency& l) -> const latency_histogram& { return l.response_dispatch; });
+
+        return output.str();
+    }
+}
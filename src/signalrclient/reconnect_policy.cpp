@@ -0,0 +1,68 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <algorithm>
+#include "signalrclient/reconnect_policy.h"
+
+namespace signalr
+{
+    fixed_delay_reconnect_policy::fixed_delay_reconnect_policy(std::chrono::milliseconds delay)
+        : m_delay(delay)
+    { }
+
+    bool fixed_delay_reconnect_policy::next_delay(const reconnect_context& context, std::chrono::milliseconds& delay)
+    {
+        delay = context.failed_attempts == 0 ? std::chrono::milliseconds::zero() : m_delay;
+        return true;
+    }
+
+    exponential_backoff_reconnect_policy::exponential_backoff_reconnect_policy(std::chrono::milliseconds base_delay,
+        std::chrono::milliseconds max_delay, reconnect_jitter jitter, unsigned int max_attempts)
+        : m_base_delay(base_delay), m_max_delay(std::max(base_delay, max_delay)), m_jitter(jitter), m_max_attempts(max_attempts),
+        m_random(std::random_device()())
+    { }
+
+    bool exponential_backoff_reconnect_policy::next_delay(const reconnect_context& context, std::chrono::milliseconds& delay)
+    {
+        if (m_max_attempts != 0 && context.failed_attempts >= m_max_attempts)
+        {
+            return false;
+        }
+
+        if (context.failed_attempts == 0)
+        {
+            delay = m_jitter == reconnect_jitter::none
+                ? std::chrono::milliseconds::zero()
+                : std::chrono::milliseconds(random_between(0, m_base_delay.count()));
+            return true;
+        }
+
+        if (m_jitter == reconnect_jitter::decorrelated)
+        {
+            auto upper_bound = std::max(m_base_delay.count(), context.previous_delay.count() * 3);
+            delay = std::chrono::milliseconds(std::min(random_between(m_base_delay.count(), upper_bound), (int64_t)m_max_delay.count()));
+            return true;
+        }
+
+        // stop doubling once the cap is reached to avoid overflowing
+        auto backoff = m_base_delay;
+        for (auto i = 1U; i < context.failed_attempts && backoff < m_max_delay; ++i)
+        {
+            backoff *= 2;
+        }
+        backoff = std::min(backoff, m_max_delay);
+
+        delay = m_jitter == reconnect_jitter::full
+            ? std::chrono::milliseconds(random_between(0, backoff.count()))
+            : backoff;
+
+        return true;
+    }
+
+    int64_t exponential_backoff_reconnect_policy::random_between(int64_t min, int64_t max)
+    {
+        std::lock_guard<std::mutex> lock(m_random_lock);
+        return std::uniform_int_distribution<int64_t>(min, max)(m_random);
+    }
+}
@@ -65,5 +65,24 @@ namespace signalr
 
             return http_sender::get(request_factory, abort_url, signalr_client_config);
         }
+
+        pplx::task<void> ping(web_request_factory& request_factory, const web::uri& base_url, const utility::string_t& query_string,
+            const signalr_client_config& signalr_client_config)
+        {
+            auto ping_url = url_builder::build_ping(base_url, query_string);
+
+            return http_sender::get(request_factory, ping_url, signalr_client_config)
+                .then([](utility::string_t body)
+            {
+                auto ping_response_json = web::json::value::parse(body);
+
+                if (ping_response_json[_XPLATSTR("Response")].is_null() ||
+                    ping_response_json[_XPLATSTR("Response")].as_string() != _XPLATSTR("pong"))
+                {
+                    throw signalr_exception(
+                        _XPLATSTR("ping request failed due to unexpected response from the server: ") + body);
+                }
+            });
+        }
     }
 }
\ No newline at end of file
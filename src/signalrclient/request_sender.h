@@ -23,5 +23,7 @@ namespace signalr
         pplx::task<utility::string_t> abort(web_request_factory& request_factory, const web::uri& base_url, transport_type transport,
             const utility::string_t& connection_token, const utility::string_t& connection_data, const utility::string_t& query_string,
             const signalr_client_config& signalr_client_config = signalr::signalr_client_config{});
+        pplx::task<void> ping(web_request_factory& request_factory, const web::uri& base_url, const utility::string_t& query_string,
+            const signalr_client_config& signalr_client_config = signalr::signalr_client_config{});
     }
 }
\ No newline at end of file
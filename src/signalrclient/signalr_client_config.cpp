@@ -8,6 +8,10 @@
 
 namespace signalr
 {
+    signalr_client_config::signalr_client_config()
+        : m_admission_priority(admission_priority::normal), m_record_invocation_latencies(false)
+    { }
+
     void signalr_client_config::set_proxy(const web::web_proxy &proxy)
     {
         m_http_client_config.set_proxy(proxy);
@@ -49,4 +53,94 @@ namespace signalr
     {
         m_http_headers = http_headers;
     }
+
+    std::shared_ptr<event_loop> signalr_client_config::get_event_loop() const
+    {
+        return m_event_loop;
+    }
+
+    void signalr_client_config::set_event_loop(const std::shared_ptr<event_loop>& event_loop)
+    {
+        m_event_loop = event_loop;
+    }
+
+    std::shared_ptr<timer_queue> signalr_client_config::get_timer_queue() const
+    {
+        return m_timer_queue;
+    }
+
+    void signalr_client_config::set_timer_queue(const std::shared_ptr<timer_queue>& timer_queue)
+    {
+        m_timer_queue = timer_queue;
+    }
+
+    std::shared_ptr<http_client_cache> signalr_client_config::get_http_client_cache() const
+    {
+        return m_http_client_cache;
+    }
+
+    void signalr_client_config::set_http_client_cache(const std::shared_ptr<http_client_cache>& http_client_cache)
+    {
+        m_http_client_cache = http_client_cache;
+    }
+
+    std::shared_ptr<admission_controller> signalr_client_config::get_admission_controller() const
+    {
+        return m_admission_controller;
+    }
+
+    void signalr_client_config::set_admission_controller(const std::shared_ptr<admission_controller>& admission_controller)
+    {
+        m_admission_controller = admission_controller;
+    }
+
+    admission_priority signalr_client_config::get_admission_priority() const
+    {
+        return m_admission_priority;
+    }
+
+    void signalr_client_config::set_admission_priority(admission_priority priority)
+    {
+        m_admission_priority = priority;
+    }
+
+    std::shared_ptr<metrics_sink> signalr_client_config::get_metrics_sink() const
+    {
+        return m_metrics_sink;
+    }
+
+    void signalr_client_config::set_metrics_sink(const std::shared_ptr<metrics_sink>& metrics_sink)
+    {
+        m_metrics_sink = metrics_sink;
+    }
+
+    std::shared_ptr<memory_allocator> signalr_client_config::get_memory_allocator() const
+    {
+        return m_memory_allocator;
+    }
+
+    void signalr_client_config::set_memory_allocator(const std::shared_ptr<memory_allocator>& memory_allocator)
+    {
+        m_memory_allocator = memory_allocator;
+    }
+
+    std::shared_ptr<invocation_tracer> signalr_client_config::get_invocation_tracer() const
+    {
+        return m_invocation_tracer;
+    }
+
+    void signalr_client_config::set_invocation_tracer(const std::shared_ptr<invocation_tracer>& invocation_tracer)
+    {
+        m_invocation_tracer = invocation_tracer;
+    }
+
+    bool signalr_client_config::get_record_invocation_latencies() const
+    {
+        return m_record_invocation_latencies;
+    }
+
+    void signalr_client_config::set_record_invocation_latencies(bool record_invocation_latencies)
+    {
+        m_record_invocation_latencies = record_invocation_latencies;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,151 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include "signalrclient/timer_queue.h"
+
+namespace signalr
+{
+    namespace
+    {
+        struct timer
+        {
+            std::chrono::steady_clock::time_point due_time;
+            // keeps the callbacks with the same due time in the order they were scheduled
+            uint64_t sequence_number;
+            std::function<void()> callback;
+            // invoked instead of the callback if the queue is destroyed before the callback runs
+            std::function<void()> on_cancelled;
+
+            bool operator>(const timer& other) const
+            {
+                return due_time != other.due_time ? due_time > other.due_time : sequence_number > other.sequence_number;
+            }
+        };
+    }
+
+    struct timer_queue::state
+    {
+        std::priority_queue<timer, std::vector<timer>, std::greater<timer>> timers;
+        uint64_t next_sequence_number;
+        std::mutex lock;
+        std::condition_variable timers_changed;
+        bool stop_requested;
+
+        state()
+            : next_sequence_number(0), stop_requested(false)
+        { }
+
+        void run()
+        {
+            std::unique_lock<std::mutex> guard(lock);
+
+            while (!stop_requested)
+            {
+                if (timers.empty())
+                {
+                    timers_changed.wait(guard);
+                    continue;
+                }
+
+                if (timers.top().due_time > std::chrono::steady_clock::now())
+                {
+                    timers_changed.wait_until(guard, timers.top().due_time);
+                    continue;
+                }
+
+                auto callback = timers.top().callback;
+                timers.pop();
+
+                guard.unlock();
+                try
+                {
+                    callback();
+                }
+                catch (...)
+                {
+                    // there is no one to report the exception to - callbacks are not supposed to throw
+                }
+                guard.lock();
+            }
+        }
+    };
+
+    timer_queue::timer_queue()
+        : m_state(std::make_shared<state>())
+    {
+        auto state = m_state;
+        m_thread = std::thread([state]() { state->run(); });
+    }
+
+    timer_queue::~timer_queue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->lock);
+            m_state->stop_requested = true;
+        }
+
+        m_state->timers_changed.notify_one();
+
+        // the last reference to the queue can be released by a callback running on the timer thread in which case
+        // joining would deadlock
+        if (m_thread.get_id() == std::this_thread::get_id())
+        {
+            m_thread.detach();
+        }
+        else
+        {
+            m_thread.join();
+        }
+
+        // the timer thread no longer takes timers off the queue so the pending timers can be cancelled. Anything waiting
+        // for a timer (e.g. a delay task) would otherwise never complete.
+        std::priority_queue<timer, std::vector<timer>, std::greater<timer>> pending_timers;
+        {
+            std::lock_guard<std::mutex> lock(m_state->lock);
+            std::swap(pending_timers, m_state->timers);
+        }
+
+        for (; !pending_timers.empty(); pending_timers.pop())
+        {
+            auto& on_cancelled = pending_timers.top().on_cancelled;
+            if (on_cancelled)
+            {
+                try
+                {
+                    on_cancelled();
+                }
+                catch (...)
+                {
+                    // there is no one to report the exception to - callbacks are not supposed to throw
+                }
+            }
+        }
+    }
+
+    void timer_queue::schedule(std::chrono::milliseconds delay, const std::function<void()>& callback)
+    {
+        schedule(delay, callback, std::function<void()>());
+    }
+
+    void timer_queue::schedule(std::chrono::milliseconds delay, const std::function<void()>& callback,
+        const std::function<void()>& on_cancelled)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->lock);
+            m_state->timers.push(timer{ std::chrono::steady_clock::now() + delay, m_state->next_sequence_number++, callback, on_cancelled });
+        }
+
+        m_state->timers_changed.notify_one();
+    }
+
+    size_t timer_queue::get_pending_timer_count() const
+    {
+        std::lock_guard<std::mutex> lock(m_state->lock);
+        return m_state->timers.size();
+    }
+}
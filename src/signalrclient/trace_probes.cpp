@@ -0,0 +1,36 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "trace_probes.h"
+
+#if defined(SIGNALRCLIENT_USDT) && defined(SIGNALRCLIENT_USDT_TESTING)
+
+#include <atomic>
+
+namespace signalr
+{
+    namespace trace_probes
+    {
+        namespace
+        {
+            std::atomic<probe_observer> current_observer(nullptr);
+        }
+
+        void set_observer(probe_observer observer)
+        {
+            current_observer.store(observer);
+        }
+
+        void notify_observer(const char* probe)
+        {
+            auto observer = current_observer.load(std::memory_order_relaxed);
+            if (observer)
+            {
+                observer(probe);
+            }
+        }
+    }
+}
+
+#endif
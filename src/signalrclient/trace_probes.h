@@ -0,0 +1,68 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+// USDT (user-level statically defined tracing) probes of the `signalrclient` provider. When the library is built
+// with -DSIGNALRCLIENT_USDT (the SIGNALRCLIENT_USDT CMake option) each probe compiles to a single nop plus an ELF
+// note so that tools like bpftrace or perf can attach to it, e.g.
+//     bpftrace -e 'usdt:./libsignalrclient.so:signalrclient:frame_received { @bytes = hist(arg0); }'
+// Otherwise probes compile to nothing and their arguments are not evaluated. String arguments are UTF-8 `char*`.
+// Builds for testing the probes (-DSIGNALRCLIENT_USDT_TESTING, the SIGNALRCLIENT_USDT_TESTING CMake option) also
+// notify the observer set by the tests from each probe.
+//
+// probes:
+//     frame_received(size_t bytes)
+//     parse_start(size_t bytes)
+//     parse_end(int succeeded)
+//     hub_dispatch(const char* hub_name, const char* method_name)
+//     invocation_send(const char* hub_name, const char* method_name, const char* invocation_id)
+//     invocation_complete(const char* invocation_id, int64_t round_trip_microseconds)
+//     state_change(int old_state, int new_state)
+//     reconnect_attempt(uint64_t attempt, unsigned int failed_attempts)
+
+#if defined(SIGNALRCLIENT_USDT)
+
+#if defined(_UTF16_STRINGS)
+#error USDT probes require utility::string_t to be UTF-8
+#endif
+
+#include <sys/sdt.h>
+
+#if defined(SIGNALRCLIENT_USDT_TESTING)
+
+namespace signalr
+{
+    namespace trace_probes
+    {
+        // called with the name of every probe that fires - lets the tests check where probes fire without attaching
+        // a tracer. Only exists in builds for testing the probes.
+        typedef void (*probe_observer)(const char* probe);
+
+        void set_observer(probe_observer observer);
+        void notify_observer(const char* probe);
+    }
+}
+
+#define SIGNALRCLIENT_NOTIFY_PROBE_OBSERVER(name) ::signalr::trace_probes::notify_observer(#name)
+
+#else
+
+#define SIGNALRCLIENT_NOTIFY_PROBE_OBSERVER(name) do { } while (0)
+
+#endif
+
+#define SIGNALRCLIENT_PROBE1(name, arg1) \
+    do { DTRACE_PROBE1(signalrclient, name, arg1); SIGNALRCLIENT_NOTIFY_PROBE_OBSERVER(name); } while (0)
+#define SIGNALRCLIENT_PROBE2(name, arg1, arg2) \
+    do { DTRACE_PROBE2(signalrclient, name, arg1, arg2); SIGNALRCLIENT_NOTIFY_PROBE_OBSERVER(name); } while (0)
+#define SIGNALRCLIENT_PROBE3(name, arg1, arg2, arg3) \
+    do { DTRACE_PROBE3(signalrclient, name, arg1, arg2, arg3); SIGNALRCLIENT_NOTIFY_PROBE_OBSERVER(name); } while (0)
+
+#else
+
+#define SIGNALRCLIENT_PROBE1(name, arg1) do { } while (0)
+#define SIGNALRCLIENT_PROBE2(name, arg1, arg2) do { } while (0)
+#define SIGNALRCLIENT_PROBE3(name, arg1, arg2, arg3) do { } while (0)
+
+#endif
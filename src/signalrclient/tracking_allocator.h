@@ -0,0 +1,110 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include "signalrclient/memory_allocator.h"
+
+namespace signalr
+{
+    struct allocation_counters
+    {
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> allocated_bytes;
+        std::atomic<uint64_t> deallocations;
+        std::atomic<uint64_t> deallocated_bytes;
+
+        allocation_counters()
+            : allocations(0), allocated_bytes(0), deallocations(0), deallocated_bytes(0)
+        { }
+
+        uint64_t get_bytes_in_use() const
+        {
+            // the counters are read separately so a concurrent deallocation may be seen before its allocation
+            auto deallocated = deallocated_bytes.load(std::memory_order_relaxed);
+            auto allocated = allocated_bytes.load(std::memory_order_relaxed);
+            return allocated > deallocated ? allocated - deallocated : 0;
+        }
+    };
+
+    // A standard library allocator that takes the memory from the given `memory_allocator` (or the global operator
+    // new if there is none) and counts the allocations. Containers keep the allocator they were created with so
+    // replacing the `memory_allocator` of a container requires creating a new container. Node based containers copy
+    // the allocator for every node so the `memory_allocator` and the counters are not owned - the owner of the
+    // container has to keep them alive for as long as the container (and anything allocated from it) exists.
+    template<typename T>
+    class tracking_allocator
+    {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        tracking_allocator(memory_allocator* allocator, allocation_counters* counters)
+            : m_allocator(allocator), m_counters(counters)
+        { }
+
+        template<typename U>
+        tracking_allocator(const tracking_allocator<U>& other)
+            : m_allocator(other.m_allocator), m_counters(other.m_counters)
+        { }
+
+        T* allocate(size_t count)
+        {
+            auto size = count * sizeof(T);
+            auto memory = m_allocator
+                ? m_allocator->allocate(size, std::alignment_of<T>::value)
+                : ::operator new(size);
+
+            m_counters->allocations.fetch_add(1, std::memory_order_relaxed);
+            m_counters->allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+            return static_cast<T*>(memory);
+        }
+
+        void deallocate(T* pointer, size_t count)
+        {
+            if (m_allocator)
+            {
+                m_allocator->deallocate(pointer, count * sizeof(T), std::alignment_of<T>::value);
+            }
+            else
+            {
+                ::operator delete(pointer);
+            }
+
+            m_counters->deallocations.fetch_add(1, std::memory_order_relaxed);
+            m_counters->deallocated_bytes.fetch_add(count * sizeof(T), std::memory_order_relaxed);
+        }
+
+        memory_allocator* get_memory_allocator() const
+        {
+            return m_allocator;
+        }
+
+        template<typename U>
+        bool operator==(const tracking_allocator<U>& other) const
+        {
+            return m_allocator == other.m_allocator;
+        }
+
+        template<typename U>
+        bool operator!=(const tracking_allocator<U>& other) const
+        {
+            return m_allocator != other.m_allocator;
+        }
+
+    private:
+        template<typename U>
+        friend class tracking_allocator;
+
+        memory_allocator* m_allocator;
+        allocation_counters* m_counters;
+    };
+}
@@ -7,9 +7,10 @@
 
 namespace signalr
 {
-    transport::transport(const logger& logger, const std::function<void(const utility::string_t&)>& process_response_callback,
+    transport::transport(const logger& logger, const std::function<void(utility::string_t)>& process_response_callback,
         std::function<void(const std::exception&)> error_callback)
-        : m_logger(logger), m_process_response_callback(process_response_callback), m_error_callback(error_callback)
+        : m_logger(logger), m_process_response_callback(process_response_callback), m_error_callback(error_callback),
+        m_last_activity(std::chrono::steady_clock::now().time_since_epoch().count())
     {}
 
     // Do NOT remove this destructor. Letting the compiler generate and inline the default dtor may lead to
@@ -17,9 +18,15 @@ namespace signalr
     transport::~transport()
     { }
 
-    void transport::process_response(const utility::string_t &message)
+    std::chrono::steady_clock::time_point transport::get_last_activity() const
     {
-        m_process_response_callback(message);
+        return std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(m_last_activity.load(std::memory_order_relaxed)));
+    }
+
+    void transport::process_response(utility::string_t message)
+    {
+        m_last_activity.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        m_process_response_callback(std::move(message));
     }
 
     void transport::error(const std::exception& e)
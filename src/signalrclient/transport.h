@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include "pplx/pplxtasks.h"
 #include "cpprest/base_uri.h"
 #include "signalrclient/transport_type.h"
@@ -21,20 +23,26 @@ namespace signalr
 
         virtual transport_type get_transport_type() const = 0;
 
+        // the time the transport was created or last received a message (including keep-alives) - thread safe
+        std::chrono::steady_clock::time_point get_last_activity() const;
+
         virtual ~transport();
 
     protected:
-        transport(const logger& logger, const std::function<void(const utility::string_t &)>& process_response_callback,
+        transport(const logger& logger, const std::function<void(utility::string_t)>& process_response_callback,
             std::function<void(const std::exception&)> error_callback);
 
-        void process_response(const utility::string_t &message);
+        // the message is moved to the callback
+        void process_response(utility::string_t message);
         void error(const std::exception &e);
 
         logger m_logger;
 
     private:
-        std::function<void(const utility::string_t &)> m_process_response_callback;
+        std::function<void(utility::string_t)> m_process_response_callback;
 
         std::function<void(const std::exception&)> m_error_callback;
+
+        std::atomic<std::chrono::steady_clock::rep> m_last_activity;
     };
 }
\ No newline at end of file
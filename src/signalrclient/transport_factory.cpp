@@ -9,19 +9,67 @@ namespace signalr
 {
     std::shared_ptr<transport> transport_factory::create_transport(transport_type transport_type, const logger& logger,
         const signalr_client_config& signalr_client_config,
-        std::function<void(const utility::string_t&)> process_response_callback,
+        std::function<void(utility::string_t)> process_response_callback,
         std::function<void(const std::exception&)> error_callback)
     {
         if (transport_type == signalr::transport_type::websockets)
         {
+            std::shared_ptr<pplx::task<std::shared_ptr<websocket_client>>> prepared_websocket_client;
+            {
+                std::lock_guard<std::mutex> lock(m_prepared_websocket_client_lock);
+                prepared_websocket_client.swap(m_prepared_websocket_client);
+            }
+
+            // the transport creates a new client each time it connects - the prepared client (if any) is used the
+            // first time. Connecting is serialized by the transport.
             return websocket_transport::create(
-                [signalr_client_config](){ return std::make_shared<default_websocket_client>(signalr_client_config); },
+                [signalr_client_config, prepared_websocket_client]() mutable
+                {
+                    if (prepared_websocket_client)
+                    {
+                        auto websocket_client = prepared_websocket_client->get();
+                        prepared_websocket_client = nullptr;
+
+                        if (websocket_client)
+                        {
+                            return websocket_client;
+                        }
+                    }
+
+                    return std::static_pointer_cast<websocket_client>(std::make_shared<default_websocket_client>(signalr_client_config));
+                },
                 logger, process_response_callback, error_callback);
         }
 
         throw std::runtime_error("not implemented");
     }
 
+    void transport_factory::prepare_transport(transport_type transport_type, const signalr_client_config& signalr_client_config)
+    {
+        if (transport_type != signalr::transport_type::websockets)
+        {
+            return;
+        }
+
+        // creating the client sets up the TLS context (including loading the certificate store) which is expensive
+        auto prepared_websocket_client = std::make_shared<pplx::task<std::shared_ptr<websocket_client>>>(
+            pplx::create_task([signalr_client_config]()
+            {
+                // if the client could not be created it will be created again (and the error reported) when connecting
+                try
+                {
+                    return std::static_pointer_cast<websocket_client>(std::make_shared<default_websocket_client>(signalr_client_config));
+                }
+                catch (...)
+                {
+                    return std::shared_ptr<websocket_client>();
+                }
+            }));
+
+        std::lock_guard<std::mutex> lock(m_prepared_websocket_client_lock);
+        m_prepared_websocket_client = prepared_websocket_client;
+    }
+
     transport_factory::~transport_factory()
     { }
 }
\ No newline at end of file
@@ -4,9 +4,11 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include "signalrclient/signalr_client_config.h"
 #include "signalrclient/transport_type.h"
 #include "transport.h"
+#include "websocket_client.h"
 
 namespace signalr
 {
@@ -15,9 +17,17 @@ namespace signalr
     public:
         virtual std::shared_ptr<transport> create_transport(transport_type transport_type, const logger& logger,
             const signalr_client_config& signalr_client_config,
-            std::function<void(const utility::string_t&)> process_response_callback,
+            std::function<void(utility::string_t)> process_response_callback,
             std::function<void(const std::exception&)> error_callback);
 
+        // starts creating the client the next transport of the given type will use in the background so that it is
+        // ready (or at least closer to being ready) when the transport connects
+        virtual void prepare_transport(transport_type transport_type, const signalr_client_config& signalr_client_config);
+
         virtual ~transport_factory();
+
+    private:
+        std::mutex m_prepared_websocket_client_lock;
+        std::shared_ptr<pplx::task<std::shared_ptr<websocket_client>>> m_prepared_websocket_client;
     };
 }
\ No newline at end of file
@@ -132,5 +132,12 @@ namespace signalr
 
             return build_uri(base_url, _XPLATSTR("abort"), transport, connection_token, connection_data, query_string).to_uri();
         }
+
+        web::uri build_ping(const web::uri& base_url, const utility::string_t& query_string)
+        {
+            web::uri_builder builder(base_url);
+            builder.append_path(_XPLATSTR("ping"));
+            return builder.append_query(query_string).to_uri();
+        }
     }
 }
\ No newline at end of file
@@ -25,5 +25,6 @@ namespace signalr
         web::uri build_abort(const web::uri &base_url, transport_type transport,
             const utility::string_t& connection_token, const utility::string_t& connection_data,
             const utility::string_t& query_string);
+        web::uri build_ping(const web::uri& base_url, const utility::string_t& query_string);
     }
 }
@@ -28,15 +28,27 @@ namespace signalr
 
     pplx::task<web_response> web_request::get_response()
     {
-        web::http::client::http_client client(m_url, m_signalr_client_config.get_http_client_config());
-
         m_request.headers() = m_signalr_client_config.get_http_headers();
         if (!m_user_agent_string.empty())
         {
             m_request.headers()[_XPLATSTR("User-Agent")] = m_user_agent_string;
         }
 
-        return client.request(m_request)
+        std::shared_ptr<web::http::client::http_client> client;
+
+        auto http_client_cache = m_signalr_client_config.get_http_client_cache();
+        if (http_client_cache)
+        {
+            // the cached client is created for the host so the request has to target the path and query
+            client = http_client_cache->get_client(m_url, m_signalr_client_config.get_http_client_config());
+            m_request.set_request_uri(m_url.resource());
+        }
+        else
+        {
+            client = std::make_shared<web::http::client::http_client>(m_url, m_signalr_client_config.get_http_client_config());
+        }
+
+        return client->request(m_request)
             .then([](web::http::http_response response)
         {
             return web_response
@@ -4,12 +4,13 @@
 #include "stdafx.h"
 #include "websocket_transport.h"
 #include "logger.h"
+#include "trace_probes.h"
 #include "signalrclient/signalr_exception.h"
 
 namespace signalr
 {
     std::shared_ptr<transport> websocket_transport::create(const std::function<std::shared_ptr<websocket_client>()>& websocket_client_factory,
-        const logger& logger, const std::function<void(const utility::string_t &)>& process_response_callback,
+        const logger& logger, const std::function<void(utility::string_t)>& process_response_callback,
         std::function<void(const std::exception&)> error_callback)
     {
         return std::shared_ptr<transport>(
@@ -17,7 +18,7 @@ namespace signalr
     }
 
     websocket_transport::websocket_transport(const std::function<std::shared_ptr<websocket_client>()>& websocket_client_factory,
-        const logger& logger, const std::function<void(const utility::string_t &)>& process_response_callback,
+        const logger& logger, const std::function<void(utility::string_t)>& process_response_callback,
         std::function<void(const std::exception&)> error_callback)
         : transport(logger, process_response_callback, error_callback), m_websocket_client_factory(websocket_client_factory)
     {
@@ -161,10 +162,12 @@ namespace signalr
             // been started in which case we just stop the loop by not scheduling another receive task.
             .then([weak_transport, cts](std::string message)
             {
+                SIGNALRCLIENT_PROBE1(frame_received, message.size());
+
                 auto transport = weak_transport.lock();
                 if (transport)
                 {
-                    transport->process_response(utility::conversions::to_string_t(message));
+                    transport->process_response(utility::conversions::to_string_t(std::move(message)));
 
                     if (!cts.get_token().is_canceled())
                     {
@@ -16,7 +16,7 @@ namespace signalr
     {
     public:
         static std::shared_ptr<transport> create(const std::function<std::shared_ptr<websocket_client>()>& websocket_client_factory,
-            const logger& logger, const std::function<void(const utility::string_t&)>& process_response_callback,
+            const logger& logger, const std::function<void(utility::string_t)>& process_response_callback,
             std::function<void(const std::exception&)> error_callback);
 
         ~websocket_transport();
@@ -35,7 +35,7 @@ namespace signalr
 
     private:
         websocket_transport(const std::function<std::shared_ptr<websocket_client>()>& websocket_client_factory,
-            const logger& logger, const std::function<void(const utility::string_t &)>& process_response_callback,
+            const logger& logger, const std::function<void(utility::string_t)>& process_response_callback,
             std::function<void(const std::exception&)> error_callback);
 
         std::function<std::shared_ptr<websocket_client>()> m_websocket_client_factory;
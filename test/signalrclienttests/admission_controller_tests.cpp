@@ -0,0 +1,122 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/admission_controller.h"
+
+using namespace signalr;
+
+TEST(admission_controller_acquire, attempts_admitted_up_to_max_concurrent_attempts)
+{
+    admission_controller controller(2);
+
+    auto attempt1 = controller.acquire(admission_priority::normal);
+    auto attempt2 = controller.acquire(admission_priority::normal);
+    auto attempt3 = controller.acquire(admission_priority::normal);
+
+    ASSERT_TRUE(attempt1.is_done());
+    ASSERT_TRUE(attempt2.is_done());
+    ASSERT_FALSE(attempt3.is_done());
+
+    controller.release();
+    attempt3.get();
+
+    auto statistics = controller.get_statistics();
+    ASSERT_EQ(3U, statistics.admitted);
+    ASSERT_EQ(2U, statistics.active);
+    ASSERT_EQ(0U, statistics.queue_depth);
+    ASSERT_EQ(1U, statistics.max_queue_depth);
+}
+
+TEST(admission_controller_acquire, waiting_attempts_admitted_in_priority_order)
+{
+    admission_controller controller(1);
+
+    controller.acquire(admission_priority::normal).get();
+
+    auto low = controller.acquire(admission_priority::low);
+    auto normal1 = controller.acquire(admission_priority::normal);
+    auto high = controller.acquire(admission_priority::high);
+    auto normal2 = controller.acquire(admission_priority::normal);
+
+    ASSERT_EQ(4U, controller.get_statistics().queue_depth);
+
+    std::vector<pplx::task<void>> expected_order{ high, normal1, normal2, low };
+    for (size_t i = 0; i < expected_order.size(); i++)
+    {
+        controller.release();
+
+        for (size_t j = 0; j < expected_order.size(); j++)
+        {
+            ASSERT_EQ(j <= i, expected_order[j].is_done());
+        }
+    }
+}
+
+TEST(admission_controller_acquire, rate_of_admitted_attempts_limited)
+{
+    admission_controller controller(0, 20, 2);
+
+    auto started = std::chrono::steady_clock::now();
+
+    // the burst is admitted right away
+    ASSERT_TRUE(controller.acquire(admission_priority::normal).is_done());
+    ASSERT_TRUE(controller.acquire(admission_priority::normal).is_done());
+
+    auto attempt = controller.acquire(admission_priority::normal);
+    ASSERT_FALSE(attempt.is_done());
+    attempt.get();
+
+    ASSERT_GE(std::chrono::steady_clock::now() - started, std::chrono::milliseconds(40));
+
+    auto statistics = controller.get_statistics();
+    ASSERT_EQ(3U, statistics.admitted);
+    ASSERT_GE(statistics.max_wait_time, std::chrono::milliseconds(40));
+    ASSERT_GE(statistics.total_wait_time, statistics.max_wait_time);
+}
+
+TEST(admission_controller_acquire, cancelled_attempts_no_longer_wait)
+{
+    admission_controller controller(1);
+
+    controller.acquire(admission_priority::normal).get();
+
+    pplx::cancellation_token_source cts;
+    auto cancelled_attempt = controller.acquire(admission_priority::high, cts.get_token());
+    auto attempt = controller.acquire(admission_priority::normal);
+
+    cts.cancel();
+    ASSERT_THROW(cancelled_attempt.get(), pplx::task_canceled);
+
+    controller.release();
+    attempt.get();
+
+    auto statistics = controller.get_statistics();
+    ASSERT_EQ(2U, statistics.admitted);
+    ASSERT_EQ(1U, statistics.cancelled);
+    ASSERT_EQ(0U, statistics.queue_depth);
+}
+
+TEST(admission_controller_acquire, attempts_not_admitted_if_cancellation_token_cancelled)
+{
+    admission_controller controller(1);
+
+    pplx::cancellation_token_source cts;
+    cts.cancel();
+
+    ASSERT_THROW(controller.acquire(admission_priority::normal, cts.get_token()).get(), pplx::task_canceled);
+    ASSERT_EQ(0U, controller.get_statistics().active);
+}
+
+TEST(admission_controller_acquire, waiting_attempts_cancelled_when_controller_destroyed)
+{
+    pplx::task<void> attempt;
+    {
+        admission_controller controller(1);
+
+        controller.acquire(admission_priority::normal).get();
+        attempt = controller.acquire(admission_priority::normal);
+    }
+
+    ASSERT_THROW(attempt.get(), pplx::task_canceled);
+}
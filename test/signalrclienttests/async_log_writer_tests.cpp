@@ -0,0 +1,176 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <thread>
+#include "signalrclient/async_log_writer.h"
+#include "logger.h"
+#include "event.h"
+#include "memory_log_writer.h"
+
+using namespace signalr;
+
+namespace
+{
+    utility::string_t join_entries(const std::shared_ptr<memory_log_writer>& writer)
+    {
+        utility::string_t joined;
+        for (const auto& entry : writer->get_log_entries())
+        {
+            joined.append(entry);
+        }
+
+        return joined;
+    }
+
+    // blocks writing until released so that the entries pile up in the buffer
+    class blocking_log_writer : public log_writer
+    {
+    public:
+        explicit blocking_log_writer(const std::shared_ptr<log_writer>& writer)
+            : m_writer(writer)
+        { }
+
+        void __cdecl write(const utility::string_t &entry) override
+        {
+            m_write_started.set();
+            m_released.wait();
+            m_writer->write(entry);
+        }
+
+        void wait_for_write()
+        {
+            m_write_started.wait();
+        }
+
+        void release()
+        {
+            m_released.set();
+        }
+
+    private:
+        std::shared_ptr<log_writer> m_writer;
+        event m_write_started;
+        event m_released;
+    };
+}
+
+TEST(async_log_writer_write, entries_written_in_order_after_flush)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    async_log_writer async_writer(writer);
+
+    async_writer.write(_XPLATSTR("first\n"));
+    async_writer.write(_XPLATSTR("second\n"));
+    async_writer.flush();
+
+    ASSERT_EQ(_XPLATSTR("first\nsecond\n"), join_entries(writer));
+}
+
+TEST(async_log_writer_write, entries_logged_by_logger_formatted_on_background_thread)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    auto async_writer = std::make_shared<async_log_writer>(writer);
+
+    logger l(async_writer, trace_level::all);
+    l.log(trace_level::info, _XPLATSTR("message"));
+    async_writer->flush();
+
+    auto entries = join_entries(writer);
+    ASSERT_NE(utility::string_t::npos, entries.find(_XPLATSTR("[info        ] message\n"))) << utility::conversions::to_utf8string(entries);
+}
+
+TEST(async_log_writer_write, events_logged_by_logger_formatted_on_background_thread)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    auto async_writer = std::make_shared<async_log_writer>(writer);
+
+    logger l(async_writer, trace_level::all);
+    auto year = utility::datetime::utc_now().to_string(utility::datetime::date_format::ISO_8601).substr(0, 4);
+    l.log(trace_level::messages, log_event::message_received, _XPLATSTR("connection-id"), _XPLATSTR("{}"));
+    async_writer->flush();
+
+    auto entries = join_entries(writer);
+    ASSERT_EQ(0U, entries.find(year)) << utility::conversions::to_utf8string(entries);
+    ASSERT_NE(utility::string_t::npos, entries.find(_XPLATSTR("[message     ] processing message: {}\n"))) << utility::conversions::to_utf8string(entries);
+}
+
+TEST(async_log_writer_write, entries_written_when_writer_destroyed)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    {
+        async_log_writer async_writer(writer);
+        async_writer.write(_XPLATSTR("entry\n"));
+    }
+
+    ASSERT_EQ(_XPLATSTR("entry\n"), join_entries(writer));
+}
+
+TEST(async_log_writer_write, entries_dropped_when_buffer_full_with_drop_policy)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    auto blocking_writer = std::make_shared<blocking_log_writer>(writer);
+    async_log_writer async_writer(blocking_writer, 2, log_overflow_policy::drop);
+
+    async_writer.write(_XPLATSTR("0\n"));
+    blocking_writer->wait_for_write();
+
+    for (int i = 1; i <= 5; i++)
+    {
+        async_writer.write(utility::conversions::to_string_t(std::to_string(i)).append(_XPLATSTR("\n")));
+    }
+
+    ASSERT_EQ(3U, async_writer.get_dropped_entry_count());
+
+    blocking_writer->release();
+    async_writer.flush();
+
+    auto entries = join_entries(writer);
+    ASSERT_EQ(0U, entries.find(_XPLATSTR("0\n1\n2\n"))) << utility::conversions::to_utf8string(entries);
+    ASSERT_NE(utility::string_t::npos, entries.find(_XPLATSTR("3 log entries dropped"))) << utility::conversions::to_utf8string(entries);
+}
+
+TEST(async_log_writer_write, no_entries_lost_with_block_policy)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    async_log_writer async_writer(writer, 16, log_overflow_policy::block);
+
+    const int thread_count = 4;
+    const int entries_per_thread = 1000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; t++)
+    {
+        threads.push_back(std::thread([&async_writer, t]()
+        {
+            for (int i = 0; i < entries_per_thread; i++)
+            {
+                async_writer.write(utility::conversions::to_string_t(std::to_string(t) + ":" + std::to_string(i) + "\n"));
+            }
+        }));
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    async_writer.flush();
+
+    ASSERT_EQ(0U, async_writer.get_dropped_entry_count());
+
+    // entries of each thread are written in the order they were logged
+    std::vector<int> next_entry(thread_count, 0);
+    utility::istringstream_t entries(join_entries(writer));
+    utility::string_t line;
+    while (std::getline(entries, line))
+    {
+        auto separator = line.find(_XPLATSTR(':'));
+        auto t = std::stoi(utility::conversions::to_utf8string(line.substr(0, separator)));
+        auto i = std::stoi(utility::conversions::to_utf8string(line.substr(separator + 1)));
+        ASSERT_EQ(next_entry[t], i);
+        next_entry[t]++;
+    }
+
+    ASSERT_EQ(std::vector<int>(thread_count, entries_per_thread), next_entry);
+}
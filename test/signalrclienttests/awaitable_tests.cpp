@@ -0,0 +1,93 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/awaitable.h"
+
+#ifdef SIGNALRCLIENT_HAS_COROUTINES
+
+#include <future>
+#include "signalrclient/hub_connection.h"
+
+using namespace signalr;
+
+namespace
+{
+    // starts running eagerly and destroys the coroutine frame as soon as the coroutine completes
+    struct detached_task
+    {
+        struct promise_type
+        {
+            detached_task get_return_object() { return detached_task(); }
+            std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+            std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+    };
+
+    struct invoke_outcome
+    {
+        std::string error;
+        std::thread::id suspended_on;
+        std::thread::id resumed_on;
+    };
+
+    detached_task invoke_and_report(hub_proxy proxy, std::promise<invoke_outcome>& completed)
+    {
+        invoke_outcome outcome;
+        outcome.suspended_on = std::this_thread::get_id();
+        try
+        {
+            co_await coro::invoke(proxy, _XPLATSTR("method"));
+        }
+        catch (const std::exception& e)
+        {
+            outcome.error = e.what();
+        }
+
+        outcome.resumed_on = std::this_thread::get_id();
+        completed.set_value(outcome);
+    }
+}
+
+TEST(invoke_awaitable, coroutine_continues_without_suspending_if_invocation_completes_inline)
+{
+    hub_proxy proxy;
+    {
+        hub_connection hub_connection(_XPLATSTR("http://fakeuri"));
+        proxy = hub_connection.create_hub_proxy(_XPLATSTR("hub"));
+    }
+
+    // the connection is gone so the invocation completes before hub_proxy::invoke returns
+    std::promise<invoke_outcome> completed;
+    invoke_and_report(proxy, completed);
+
+    auto future = completed.get_future();
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(0)));
+    auto outcome = future.get();
+    ASSERT_EQ("the connection for which this hub proxy was created is no longer valid - it was either destroyed or went out of scope",
+        outcome.error);
+    ASSERT_EQ(outcome.suspended_on, outcome.resumed_on);
+}
+
+TEST(invoke_awaitable, coroutine_resumed_if_invocation_completes_on_another_thread)
+{
+    hub_connection hub_connection(_XPLATSTR("http://fakeuri"));
+    auto proxy = hub_connection.create_hub_proxy(_XPLATSTR("hub"));
+
+    // sending fails because the connection has not been started and the failure is reported from a continuation so
+    // the invocation completes on another thread - possibly while the awaitable is still being suspended
+    for (auto i = 0; i < 100; i++)
+    {
+        std::promise<invoke_outcome> completed;
+        invoke_and_report(proxy, completed);
+
+        auto future = completed.get_future();
+        ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(5)));
+        ASSERT_EQ("cannot send data when the connection is not in the connected state. current connection state: disconnected",
+            future.get().error);
+    }
+}
+
+#endif
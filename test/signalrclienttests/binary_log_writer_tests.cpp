@@ -0,0 +1,188 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "test_utils.h"
+#include <cstdio>
+#include <fstream>
+#include "signalrclient/async_log_writer.h"
+#include "signalrclient/binary_log_writer.h"
+#include "signalrclient/signalr_exception.h"
+#include "logger.h"
+#include "memory_log_writer.h"
+
+using namespace signalr;
+
+namespace
+{
+    const utility::string_t log_file_path = _XPLATSTR("binary_log_writer_tests.log");
+
+    void remove_log_file()
+    {
+        std::remove(utility::conversions::to_utf8string(log_file_path).c_str());
+    }
+
+    size_t get_file_size(const utility::string_t& file_path)
+    {
+        std::ifstream stream(file_path, std::ios::in | std::ios::binary | std::ios::ate);
+        return static_cast<size_t>(stream.tellg());
+    }
+}
+
+TEST(binary_log_writer_decode, entries_decoded_as_text)
+{
+    {
+        logger l(std::make_shared<binary_log_writer>(log_file_path), trace_level::all);
+        l.log(trace_level::info, _XPLATSTR("connecting"));
+        l.log(trace_level::messages, log_event::message_received, _XPLATSTR("connection-1"), _XPLATSTR("{\"M\":[]}"));
+        l.log(trace_level::info, log_event::message_sent, _XPLATSTR("connection-2"), _XPLATSTR("data"));
+        l.log(trace_level::messages, log_event::message_received, _XPLATSTR("connection-1"), _XPLATSTR("{}"));
+    }
+
+    memory_log_writer output;
+    binary_log_writer::decode(log_file_path, output);
+    remove_log_file();
+
+    auto entries = output.get_log_entries();
+    ASSERT_EQ(4U, entries.size());
+    ASSERT_EQ(_XPLATSTR("[info        ] connecting\n"), remove_date_from_log_entry(entries[0]));
+    ASSERT_EQ(_XPLATSTR("[message     ] [connection-1] processing message: {\"M\":[]}\n"), remove_date_from_log_entry(entries[1]));
+    ASSERT_EQ(_XPLATSTR("[info        ] [connection-2] sending data: data\n"), remove_date_from_log_entry(entries[2]));
+    ASSERT_EQ(_XPLATSTR("[message     ] [connection-1] processing message: {}\n"), remove_date_from_log_entry(entries[3]));
+}
+
+TEST(binary_log_writer_decode, entries_recorded_on_background_thread_of_async_log_writer_decoded_as_text)
+{
+    {
+        auto async_writer = std::make_shared<async_log_writer>(std::make_shared<binary_log_writer>(log_file_path));
+        logger l(async_writer, trace_level::all);
+        l.log(trace_level::info, _XPLATSTR("connecting"));
+        l.log(trace_level::messages, log_event::message_received, _XPLATSTR("connection-1"), _XPLATSTR("{\"M\":[]}"));
+        async_writer->write(_XPLATSTR("written directly\n"));
+    }
+
+    memory_log_writer output;
+    binary_log_writer::decode(log_file_path, output);
+    remove_log_file();
+
+    auto entries = output.get_log_entries();
+    ASSERT_EQ(3U, entries.size());
+    ASSERT_EQ(_XPLATSTR("[info        ] connecting\n"), remove_date_from_log_entry(entries[0]));
+    ASSERT_EQ(_XPLATSTR("[message     ] [connection-1] processing message: {\"M\":[]}\n"), remove_date_from_log_entry(entries[1]));
+    ASSERT_EQ(_XPLATSTR("written directly\n"), entries[2]);
+}
+
+TEST(binary_log_writer_decode, entries_written_directly_decoded_unchanged)
+{
+    {
+        binary_log_writer writer(log_file_path);
+        writer.write(_XPLATSTR("first entry\n"));
+        writer.write(_XPLATSTR("second entry\n"));
+    }
+
+    memory_log_writer output;
+    binary_log_writer::decode(log_file_path, output);
+    remove_log_file();
+
+    auto entries = output.get_log_entries();
+    ASSERT_EQ(2U, entries.size());
+    ASSERT_EQ(_XPLATSTR("first entry\n"), entries[0]);
+    ASSERT_EQ(_XPLATSTR("second entry\n"), entries[1]);
+}
+
+TEST(binary_log_writer_write, file_trimmed_to_recorded_entries)
+{
+    {
+        binary_log_writer writer(log_file_path, 1024 * 1024);
+        writer.write(_XPLATSTR("entry"));
+    }
+
+    auto file_size = get_file_size(log_file_path);
+    remove_log_file();
+
+    // header + type + level + event + connection index + timestamp + payload
+    ASSERT_LT(file_size, 40U);
+    ASSERT_GT(file_size, 8U + 5U);
+}
+
+TEST(binary_log_writer_write, entries_dropped_when_file_full)
+{
+    {
+        binary_log_writer writer(log_file_path, 64);
+        writer.write(_XPLATSTR("short"));
+        writer.write(utility::string_t(100, _XPLATSTR('x')));
+        // not recorded even though it would fit so that the log has no gaps
+        writer.write(_XPLATSTR("short"));
+
+        ASSERT_EQ(2U, writer.get_dropped_entry_count());
+    }
+
+    memory_log_writer output;
+    binary_log_writer::decode(log_file_path, output);
+    remove_log_file();
+
+    auto entries = output.get_log_entries();
+    ASSERT_EQ(1U, entries.size());
+    ASSERT_EQ(_XPLATSTR("short"), entries[0]);
+}
+
+TEST(binary_log_writer_decode, truncated_record_ignored)
+{
+    {
+        binary_log_writer writer(log_file_path);
+        writer.write(_XPLATSTR("first entry"));
+        writer.write(_XPLATSTR("second entry"));
+    }
+
+    auto file_size = get_file_size(log_file_path);
+    {
+        std::ifstream input(log_file_path, std::ios::in | std::ios::binary);
+        std::vector<char> contents(file_size - 3);
+        input.read(contents.data(), contents.size());
+        input.close();
+
+        std::ofstream truncated(log_file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        truncated.write(contents.data(), contents.size());
+    }
+
+    memory_log_writer output;
+    binary_log_writer::decode(log_file_path, output);
+    remove_log_file();
+
+    auto entries = output.get_log_entries();
+    ASSERT_EQ(1U, entries.size());
+    ASSERT_EQ(_XPLATSTR("first entry"), entries[0]);
+}
+
+TEST(binary_log_writer_decode, throws_for_files_that_are_not_binary_logs)
+{
+    {
+        std::ofstream text_log(log_file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        text_log << "2015-01-01T00:00:00Z [info        ] connecting" << std::endl;
+    }
+
+    memory_log_writer output;
+    try
+    {
+        binary_log_writer::decode(log_file_path, output);
+        remove_log_file();
+        ASSERT_TRUE(false); // exception not thrown
+    }
+    catch (const signalr_exception& e)
+    {
+        remove_log_file();
+        ASSERT_EQ(_XPLATSTR("not a binary log file: ") + log_file_path, utility::conversions::to_string_t(e.what()));
+    }
+}
+
+TEST(logger_write, structured_entries_formatted_for_text_log_writers)
+{
+    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
+
+    logger l(writer, trace_level::all);
+    l.log(trace_level::messages, log_event::message_received, _XPLATSTR("connection-1"), _XPLATSTR("{}"));
+
+    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
+    ASSERT_EQ(1U, log_entries.size());
+    ASSERT_EQ(_XPLATSTR("[message     ] processing message: {}\n"), remove_date_from_log_entry(log_entries[0]));
+}
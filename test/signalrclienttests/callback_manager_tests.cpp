@@ -128,3 +128,80 @@ TEST(callback_manager_dtor, clear_invokes_all_callbacks)
     ASSERT_EQ(10, invocation_count);
     ASSERT_TRUE(parameter_correct);
 }
+
+namespace
+{
+    class counting_memory_allocator : public memory_allocator
+    {
+    public:
+        counting_memory_allocator()
+            : allocated_bytes(0), deallocated_bytes(0)
+        { }
+
+        void* __cdecl allocate(size_t size, size_t) override
+        {
+            allocated_bytes += size;
+            return ::operator new(size);
+        }
+
+        void __cdecl deallocate(void* pointer, size_t size, size_t) override
+        {
+            deallocated_bytes += size;
+            ::operator delete(pointer);
+        }
+
+        std::atomic<size_t> allocated_bytes;
+        std::atomic<size_t> deallocated_bytes;
+    };
+}
+
+TEST(callback_manager_allocations, registering_callbacks_counts_allocations)
+{
+    callback_manager callback_mgr{ json::value::object() };
+    auto allocations = callback_mgr.get_allocation_counters().allocations.load();
+    auto allocated_bytes = callback_mgr.get_allocation_counters().allocated_bytes.load();
+
+    callback_mgr.register_callback([](const json::value&){});
+
+    ASSERT_LT(allocations, callback_mgr.get_allocation_counters().allocations.load());
+    ASSERT_LT(allocated_bytes, callback_mgr.get_allocation_counters().allocated_bytes.load());
+}
+
+TEST(callback_manager_allocations, removing_callbacks_counts_deallocations)
+{
+    callback_manager callback_mgr{ json::value::object() };
+    auto callback_id = callback_mgr.register_callback([](const json::value&){});
+    auto deallocations = callback_mgr.get_allocation_counters().deallocations.load();
+    auto bytes_in_use = callback_mgr.get_allocation_counters().get_bytes_in_use();
+
+    ASSERT_TRUE(callback_mgr.remove_callback(callback_id));
+
+    // the buckets of the map are not freed
+    ASSERT_LT(deallocations, callback_mgr.get_allocation_counters().deallocations.load());
+    ASSERT_GT(bytes_in_use, callback_mgr.get_allocation_counters().get_bytes_in_use());
+}
+
+TEST(callback_manager_allocations, callbacks_allocated_from_memory_allocator_and_moved_when_allocator_changes)
+{
+    auto first_allocator = std::make_shared<counting_memory_allocator>();
+    auto second_allocator = std::make_shared<counting_memory_allocator>();
+
+    auto invoked = false;
+    {
+        callback_manager callback_mgr{ json::value::object() };
+        callback_mgr.set_memory_allocator(first_allocator);
+
+        auto callback_id = callback_mgr.register_callback([&invoked](const json::value&) { invoked = true; });
+        ASSERT_LT(0U, first_allocator->allocated_bytes.load());
+
+        callback_mgr.set_memory_allocator(second_allocator);
+
+        ASSERT_EQ(first_allocator->allocated_bytes.load(), first_allocator->deallocated_bytes.load());
+        ASSERT_LT(0U, second_allocator->allocated_bytes.load());
+
+        ASSERT_TRUE(callback_mgr.invoke_callback(callback_id, json::value::object(), true));
+        ASSERT_TRUE(invoked);
+    }
+
+    ASSERT_EQ(second_allocator->allocated_bytes.load(), second_allocator->deallocated_bytes.load());
+}
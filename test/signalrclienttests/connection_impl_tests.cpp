@@ -12,6 +12,7 @@
 #include "memory_log_writer.h"
 #include "cpprest/ws_client.h"
 #include "signalrclient/signalr_exception.h"
+#include "signalrclient/prometheus_exporter.h"
 
 using namespace signalr;
 
@@ -488,6 +489,51 @@ TEST(connection_impl_set_message_received, callback_invoked_when_message_receive
     ASSERT_EQ(_XPLATSTR("Test"), *message);
 }
 
+TEST(connection_impl_set_message_received, callback_invoked_on_event_loop_if_event_loop_set)
+{
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]()
+        mutable {
+        std::string responses[]
+        {
+            "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{ \"C\":\"d-486F0DF9-BAO,5|BAV,1|BAW,0\", \"M\" : [\"Test\"] }",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 2);
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto connection = create_connection(websocket_client);
+
+    auto loop = std::make_shared<event_loop>();
+    signalr_client_config config;
+    config.set_event_loop(loop);
+    connection->set_client_config(config);
+
+    auto message_thread_id = std::make_shared<std::thread::id>();
+    connection->set_message_received_string([message_thread_id, loop](const utility::string_t &m)
+    {
+        if (m == _XPLATSTR("Test"))
+        {
+            *message_thread_id = std::this_thread::get_id();
+            loop->stop();
+        }
+    });
+
+    auto start_task = connection->start();
+
+    // the connection cannot start and messages are not processed unless the loop is driven
+    loop->run();
+    start_task.get();
+
+    ASSERT_EQ(std::this_thread::get_id(), *message_thread_id);
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+}
+
 TEST(connection_impl_set_message_received, exception_from_callback_caught_and_logged)
 {
     int call_number = -1;
@@ -715,6 +761,13 @@ TEST(connection_impl_set_configuration, set_disconnected_callback_can_be_set_onl
         "cannot set the disconnected callback when the connection is not in the disconnected state. current connection state: connected");
 }
 
+TEST(connection_impl_set_configuration, set_reconnect_policy_can_be_set_only_in_disconnected_state)
+{
+    can_be_set_only_in_disconnected_state(
+        [](connection_impl* connection) { connection->set_reconnect_policy(std::make_shared<fixed_delay_reconnect_policy>(std::chrono::milliseconds(100))); },
+        "cannot set reconnect policy when the connection is not in the disconnected state. current connection state: connected");
+}
+
 TEST(connection_impl_set_configuration, set_reconnect_delay_can_be_set_only_in_disconnected_state)
 {
     can_be_set_only_in_disconnected_state(
@@ -1105,43 +1158,818 @@ TEST(connection_impl_config, custom_headers_set_in_requests)
     signalr_client_config.set_http_headers(http_headers);
     connection->set_client_config(signalr_client_config);
 
-    connection->start()
-        .then([connection]()
-    {
-        return connection->stop();
-    }).get();
+    connection->start()
+        .then([connection]()
+    {
+        return connection->stop();
+    }).get();
+
+    ASSERT_EQ(connection_state::disconnected, connection->get_connection_state());
+}
+
+TEST(connection_impl_set_config, config_can_be_set_only_in_disconnected_state)
+{
+    can_be_set_only_in_disconnected_state(
+        [](connection_impl* connection) 
+        {
+            signalr::signalr_client_config signalr_client_config;
+            connection->set_client_config(signalr_client_config);
+        },"cannot set client config when the connection is not in the disconnected state. current connection state: connected");
+}
+
+TEST(connection_impl_admission, connection_not_started_until_admitted)
+{
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{\"C\":\"x\", \"S\":1, \"M\":[] }")); });
+    auto connection = create_connection(websocket_client);
+
+    auto controller = std::make_shared<admission_controller>(1);
+    signalr_client_config config;
+    config.set_admission_controller(controller);
+    config.set_admission_priority(admission_priority::high);
+    connection->set_client_config(config);
+
+    // takes the only slot so that the connection has to wait
+    controller->acquire(admission_priority::normal).get();
+
+    auto start_task = connection->start();
+    for (int i = 0; i < 100 && controller->get_statistics().queue_depth == 0; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(1U, controller->get_statistics().queue_depth);
+    ASSERT_EQ(connection_state::connecting, connection->get_connection_state());
+
+    controller->release();
+    start_task.get();
+
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+
+    auto statistics = controller->get_statistics();
+    ASSERT_EQ(2U, statistics.admitted);
+    ASSERT_EQ(0U, statistics.active);
+    ASSERT_EQ(0U, statistics.queue_depth);
+}
+
+TEST(connection_impl_admission, reconnect_attempt_cancelled_while_waiting_to_be_admitted_not_recorded_as_failure)
+{
+    auto drop_connection_event = std::make_shared<event>();
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number, drop_connection_event]() mutable
+        {
+            call_number++;
+            if (call_number == 0)
+            {
+                return pplx::task_from_result(std::string("{\"C\":\"x\", \"S\":1, \"M\":[] }"));
+            }
+
+            if (call_number == 1)
+            {
+                drop_connection_event->wait();
+                return pplx::task_from_exception<std::string>(std::runtime_error("connection exception"));
+            }
+
+            return pplx::task_from_result(std::string("{}"));
+        });
+
+    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
+    auto connection = create_connection(websocket_client, writer, trace_level::info);
+
+    auto controller = std::make_shared<admission_controller>(1);
+    signalr_client_config config;
+    config.set_admission_controller(controller);
+    connection->set_client_config(config);
+
+    auto disconnected_event = std::make_shared<event>();
+    connection->set_disconnected([disconnected_event]() { disconnected_event->set(); });
+
+    connection->start().get();
+
+    // takes the only slot so that the reconnect attempt has to wait
+    controller->acquire(admission_priority::normal).get();
+    drop_connection_event->set();
+
+    for (int i = 0; i < 100 && controller->get_statistics().queue_depth == 0; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(1U, controller->get_statistics().queue_depth);
+    ASSERT_EQ(connection_state::reconnecting, connection->get_connection_state());
+
+    connection->stop();
+    ASSERT_FALSE(disconnected_event->wait(5000));
+    ASSERT_EQ(1U, controller->get_statistics().cancelled);
+
+    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
+    auto contains = [&log_entries](const utility::string_t& text)
+    {
+        return std::any_of(log_entries.begin(), log_entries.end(),
+            [&text](const utility::string_t& entry) { return entry.find(text) != utility::string_t::npos; });
+    };
+
+    ASSERT_TRUE(contains(_XPLATSTR("reconnect attempt cancelled before it was admitted")));
+    ASSERT_FALSE(contains(_XPLATSTR("reconnect attempt failed")));
+}
+
+TEST(connection_impl_change_state, change_state_logs)
+{
+    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{\"C\":\"x\", \"S\":1, \"M\":[] }")); });
+    auto connection = create_connection(websocket_client, writer, trace_level::state_changes);
+
+    connection->start().wait();
+
+    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
+    ASSERT_FALSE(log_entries.empty());
+
+    auto entry = remove_date_from_log_entry(log_entries[0]);
+    ASSERT_EQ(_XPLATSTR("[state change] disconnected -> connecting\n"), entry);
+}
+
+TEST(connection_impl_reconnect, can_reconnect)
+{
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]() mutable
+        {
+            std::string responses[]
+            {
+                "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+                "{}",
+                "{}",
+                "{}"
+            };
+
+            call_number = std::min(call_number + 1, 3);
+
+            return call_number == 2
+                ? pplx::task_from_exception<std::string>(std::runtime_error("connection exception"))
+                : pplx::task_from_result(responses[call_number]);
+        });
+
+    auto connection = create_connection(websocket_client);
+    connection->set_reconnect_delay(100);
+    auto reconnected_event = std::make_shared<event>();
+    connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
+    connection->start();
+
+    ASSERT_FALSE(reconnected_event->wait(5000));
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+}
+
+TEST(connection_impl_reconnect, successful_reconnect_state_changes)
+{
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]() mutable
+        {
+            std::string responses[]
+            {
+                "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+                "{}",
+                "{}",
+                "{}"
+            };
+
+            call_number = std::min(call_number + 1, 3);
+
+            return call_number == 2
+                ? pplx::task_from_exception<std::string>(std::runtime_error("connection exception"))
+                : pplx::task_from_result(responses[call_number]);
+        });
+
+    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
+    auto connection = create_connection(websocket_client, writer, trace_level::state_changes);
+    connection->set_reconnect_delay(100);
+    auto reconnected_event = std::make_shared<event>();
+    connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
+    connection->start();
+
+    ASSERT_FALSE(reconnected_event->wait(5000));
+
+    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
+    ASSERT_EQ(4, log_entries.size());
+    ASSERT_EQ(_XPLATSTR("[state change] disconnected -> connecting\n"), remove_date_from_log_entry(log_entries[0]));
+    ASSERT_EQ(_XPLATSTR("[state change] connecting -> connected\n"), remove_date_from_log_entry(log_entries[1]));
+    ASSERT_EQ(_XPLATSTR("[state change] connected -> reconnecting\n"), remove_date_from_log_entry(log_entries[2]));
+    ASSERT_EQ(_XPLATSTR("[state change] reconnecting -> connected\n"), remove_date_from_log_entry(log_entries[3]));
+}
+
+TEST(connection_impl_reconnect, connection_stopped_if_reconnecting_failed)
+{
+    auto web_request_factory = std::make_unique<test_web_request_factory>([](const web::uri& url)
+    {
+        auto response_body =
+            url.path() == _XPLATSTR("/negotiate")
+            ? _XPLATSTR("{\"Url\":\"/signalr\", \"ConnectionToken\" : \"A==\", \"ConnectionId\" : \"f7707523-307d-4cba-9abf-3eef701241e8\", ")
+            _XPLATSTR("\"DisconnectTimeout\" : 0.5, \"ConnectionTimeout\" : 110.0, \"TryWebSockets\" : true, ")
+            _XPLATSTR("\"ProtocolVersion\" : \"1.4\", \"TransportConnectTimeout\" : 5.0, \"LongPollDelay\" : 0.0}")
+            : url.path() == _XPLATSTR("/start")
+                ? _XPLATSTR("{\"Response\":\"started\" }")
+                : _XPLATSTR("");
+
+        return std::unique_ptr<web_request>(new web_request_stub((unsigned short)200, _XPLATSTR("OK"), response_body));
+    });
+
+    int call_number = -1;
+    int reconnect_invocations = 0;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]() mutable
+        {
+            std::string responses[]
+            {
+                "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+                "{}",
+                "{}",
+                "{}"
+            };
+
+            call_number = std::min(call_number + 1, 3);
+
+            return call_number == 2
+                ? pplx::task_from_exception<std::string>(std::runtime_error("connection exception"))
+                : pplx::task_from_result(responses[call_number]);
+        },
+        /* send function */ [](const utility::string_t){ return pplx::task_from_exception<void>(std::runtime_error("should not be invoked"));  },
+        /* connect function */[&reconnect_invocations](const web::uri& url)
+        {
+            if (url.path() == _XPLATSTR("/reconnect"))
+            {
+                reconnect_invocations++;
+                return pplx::task_from_exception<void>(std::runtime_error("reconnect rejected"));
+            }
+
+            return pplx::task_from_result();
+        });
+
+    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
+    auto connection =
+        connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::state_changes,
+        writer, std::move(web_request_factory), std::make_unique<test_transport_factory>(websocket_client));
+
+    auto disconnected_event = std::make_shared<event>();
+    connection->set_disconnected([disconnected_event](){ disconnected_event->set(); });
+    connection->set_reconnect_delay(100);
+    connection->start();
+
+    ASSERT_FALSE(disconnected_event->wait(5000));
+    ASSERT_EQ(connection_state::disconnected, connection->get_connection_state());
+    ASSERT_GE(reconnect_invocations, 2);
+
+    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
+    ASSERT_EQ(5, log_entries.size());
+    ASSERT_EQ(_XPLATSTR("[state change] disconnected -> connecting\n"), remove_date_from_log_entry(log_entries[0]));
+    ASSERT_EQ(_XPLATSTR("[state change] connecting -> connected\n"), remove_date_from_log_entry(log_entries[1]));
+    ASSERT_EQ(_XPLATSTR("[state change] connected -> reconnecting\n"), remove_date_from_log_entry(log_entries[2]));
+    ASSERT_EQ(_XPLATSTR("[state change] reconnecting -> disconnecting\n"), remove_date_from_log_entry(log_entries[3]));
+    ASSERT_EQ(_XPLATSTR("[state change] disconnecting -> disconnected\n"), remove_date_from_log_entry(log_entries[4]));
+}
+
+TEST(connection_impl_reconnect, reconnect_policy_stops_reconnecting_and_reconnect_statistics_updated)
+{
+    int call_number = -1;
+    auto reconnect_invocations = std::make_shared<std::atomic<int>>(0);
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]() mutable
+        {
+            std::string responses[]
+            {
+                "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+                "{}",
+                "{}",
+                "{}"
+            };
+
+            call_number = std::min(call_number + 1, 3);
+
+            return call_number == 2
+                ? pplx::task_from_exception<std::string>(std::runtime_error("connection exception"))
+                : pplx::task_from_result(responses[call_number]);
+        },
+        /* send function */ [](const utility::string_t){ return pplx::task_from_exception<void>(std::runtime_error("should not be invoked"));  },
+        /* connect function */[reconnect_invocations](const web::uri& url)
+        {
+            if (url.path() == _XPLATSTR("/reconnect"))
+            {
+                (*reconnect_invocations)++;
+                return pplx::task_from_exception<void>(std::runtime_error("reconnect rejected"));
+            }
+
+            return pplx::task_from_result();
+        });
+
+    auto connection = create_connection(websocket_client);
+
+    auto disconnected_event = std::make_shared<event>();
+    connection->set_disconnected([disconnected_event](){ disconnected_event->set(); });
+    connection->set_reconnect_policy(std::make_shared<exponential_backoff_reconnect_policy>(
+        std::chrono::milliseconds(10), std::chrono::milliseconds(10), reconnect_jitter::none, 3));
+    connection->start();
+
+    ASSERT_FALSE(disconnected_event->wait(5000));
+    ASSERT_EQ(connection_state::disconnected, connection->get_connection_state());
+    ASSERT_EQ(3, reconnect_invocations->load());
+
+    auto statistics = connection->get_reconnect_statistics();
+    ASSERT_EQ(1U, statistics.reconnects);
+    ASSERT_EQ(0U, statistics.successful_reconnects);
+    ASSERT_EQ(1U, statistics.failed_reconnects);
+    ASSERT_EQ(3U, statistics.attempts);
+    ASSERT_EQ(3U, statistics.last_reconnect_attempts);
+    ASSERT_GE(statistics.last_reconnect_duration, std::chrono::milliseconds(20));
+}
+
+namespace
+{
+    // records the number of failed attempts it is asked for and stops after `max_failed_attempts`
+    class recording_reconnect_policy : public reconnect_policy
+    {
+    public:
+        explicit recording_reconnect_policy(unsigned int max_failed_attempts)
+            : m_max_failed_attempts(max_failed_attempts)
+        { }
+
+        bool __cdecl next_delay(const reconnect_context& context, std::chrono::milliseconds& delay) override
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_failed_attempts.push_back(context.failed_attempts);
+            delay = std::chrono::milliseconds(10);
+            return context.failed_attempts < m_max_failed_attempts;
+        }
+
+        std::vector<unsigned int> get_failed_attempts()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_failed_attempts;
+        }
+
+    private:
+        unsigned int m_max_failed_attempts;
+        std::mutex m_lock;
+        std::vector<unsigned int> m_failed_attempts;
+    };
+}
+
+TEST(connection_impl_reconnect, reconnect_policy_asked_for_delay_before_first_attempt)
+{
+    for (auto max_failed_attempts = 0U; max_failed_attempts < 3; ++max_failed_attempts)
+    {
+        int call_number = -1;
+        auto reconnect_invocations = std::make_shared<std::atomic<int>>(0);
+        auto websocket_client = create_test_websocket_client(
+            /* receive function */ [call_number]() mutable
+            {
+                call_number = std::min(call_number + 1, 2);
+
+                return call_number == 0
+                    ? pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }"))
+                    : call_number == 1
+                        ? pplx::task_from_exception<std::string>(std::runtime_error("connection exception"))
+                        : pplx::task_from_result(std::string("{}"));
+            },
+            /* send function */ [](const utility::string_t){ return pplx::task_from_exception<void>(std::runtime_error("should not be invoked"));  },
+            /* connect function */[reconnect_invocations](const web::uri& url)
+            {
+                if (url.path() == _XPLATSTR("/reconnect"))
+                {
+                    (*reconnect_invocations)++;
+                    return pplx::task_from_exception<void>(std::runtime_error("reconnect rejected"));
+                }
+
+                return pplx::task_from_result();
+            });
+
+        auto connection = create_connection(websocket_client);
+
+        auto disconnected_event = std::make_shared<event>();
+        connection->set_disconnected([disconnected_event](){ disconnected_event->set(); });
+        auto reconnect_policy = std::make_shared<recording_reconnect_policy>(max_failed_attempts);
+        connection->set_reconnect_policy(reconnect_policy);
+        connection->start();
+
+        ASSERT_FALSE(disconnected_event->wait(5000));
+
+        // the policy stopping before the first attempt means that the connection does not try to reconnect at all
+        std::vector<unsigned int> expected_failed_attempts;
+        for (auto failed_attempts = 0U; failed_attempts <= max_failed_attempts; ++failed_attempts)
+        {
+            expected_failed_attempts.push_back(failed_attempts);
+        }
+
+        ASSERT_EQ(expected_failed_attempts, reconnect_policy->get_failed_attempts());
+        ASSERT_EQ(static_cast<int>(max_failed_attempts), reconnect_invocations->load());
+    }
+}
+
+namespace
+{
+    // stand-in for a server at the given host. Requests to hosts in `unavailable_hosts` fail, pings to hosts in
+    // `slow_hosts` take longer
+    std::unique_ptr<web_request_factory> create_failover_web_request_factory(const std::vector<utility::string_t>& unavailable_hosts,
+        const std::vector<utility::string_t>& slow_hosts, std::shared_ptr<std::vector<utility::string_t>> negotiated_hosts)
+    {
+        return std::make_unique<test_web_request_factory>([unavailable_hosts, slow_hosts, negotiated_hosts](const web::uri& url)
+        {
+            if (std::find(unavailable_hosts.begin(), unavailable_hosts.end(), url.host()) != unavailable_hosts.end())
+            {
+                return std::unique_ptr<web_request>(new web_request_stub((unsigned short)503, _XPLATSTR("Server unavailable")));
+            }
+
+            if (url.path() == _XPLATSTR("/ping") && std::find(slow_hosts.begin(), slow_hosts.end(), url.host()) != slow_hosts.end())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+
+            if (url.path() == _XPLATSTR("/negotiate"))
+            {
+                negotiated_hosts->push_back(url.host());
+            }
+
+            auto response_body =
+                url.path() == _XPLATSTR("/negotiate")
+                ? _XPLATSTR("{\"Url\":\"/signalr\", \"ConnectionToken\" : \"A==\", \"ConnectionId\" : \"f7707523-307d-4cba-9abf-3eef701241e8\", ")
+                _XPLATSTR("\"KeepAliveTimeout\" : 20.0, \"DisconnectTimeout\" : 10.0, \"ConnectionTimeout\" : 110.0, \"TryWebSockets\" : true, ")
+                _XPLATSTR("\"ProtocolVersion\" : \"1.4\", \"TransportConnectTimeout\" : 5.0, \"LongPollDelay\" : 0.0}")
+                : url.path() == _XPLATSTR("/start")
+                    ? _XPLATSTR("{\"Response\":\"started\" }")
+                    : url.path() == _XPLATSTR("/ping")
+                        ? _XPLATSTR("{\"Response\":\"pong\" }")
+                        : _XPLATSTR("");
+
+            return std::unique_ptr<web_request>(new web_request_stub((unsigned short)200, _XPLATSTR("OK"), response_body));
+        });
+    }
+}
+
+TEST(connection_impl_failover, connection_started_on_reachable_endpoint)
+{
+    auto negotiated_hosts = std::make_shared<std::vector<utility::string_t>>();
+    auto connect_hosts = std::make_shared<std::vector<utility::string_t>>();
+
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); },
+        /* send function */ [](const utility::string_t){ return pplx::task_from_result(); },
+        /* connect function */[connect_hosts](const web::uri& url)
+        {
+            connect_hosts->push_back(url.host());
+            return pplx::task_from_result();
+        });
+
+    auto connection = connection_impl::create(_XPLATSTR("http://server1"), _XPLATSTR(""), trace_level::none, std::make_shared<trace_log_writer>(),
+        create_failover_web_request_factory({ _XPLATSTR("server1") }, {}, negotiated_hosts),
+        std::make_unique<test_transport_factory>(websocket_client));
+    connection->set_failover_urls({ _XPLATSTR("http://server2") });
+
+    connection->start().get();
+
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+    ASSERT_EQ(std::vector<utility::string_t>{ _XPLATSTR("server2") }, *negotiated_hosts);
+    ASSERT_EQ(std::vector<utility::string_t>{ _XPLATSTR("server2") }, *connect_hosts);
+}
+
+TEST(connection_impl_failover, reconnect_fails_over_to_another_endpoint)
+{
+    auto negotiated_hosts = std::make_shared<std::vector<utility::string_t>>();
+    auto reconnect_hosts = std::make_shared<std::vector<utility::string_t>>();
+
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]() mutable
+        {
+            std::string responses[]
+            {
+                "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+                "{}",
+                "{}",
+                "{}"
+            };
+
+            call_number = std::min(call_number + 1, 3);
+
+            return call_number == 2
+                ? pplx::task_from_exception<std::string>(std::runtime_error("connection exception"))
+                : pplx::task_from_result(responses[call_number]);
+        },
+        /* send function */ [](const utility::string_t){ return pplx::task_from_result(); },
+        /* connect function */[reconnect_hosts](const web::uri& url)
+        {
+            if (url.path() == _XPLATSTR("/reconnect"))
+            {
+                reconnect_hosts->push_back(url.host());
+                if (url.host() == _XPLATSTR("server1"))
+                {
+                    return pplx::task_from_exception<void>(std::runtime_error("reconnect rejected"));
+                }
+            }
+
+            return pplx::task_from_result();
+        });
+
+    // server2 is slower so the connection starts on server1
+    auto connection = connection_impl::create(_XPLATSTR("http://server1"), _XPLATSTR(""), trace_level::none, std::make_shared<trace_log_writer>(),
+        create_failover_web_request_factory({}, { _XPLATSTR("server2") }, negotiated_hosts),
+        std::make_unique<test_transport_factory>(websocket_client));
+    connection->set_failover_urls({ _XPLATSTR("http://server2") });
+    connection->set_reconnect_delay(10);
+
+    auto reconnected_event = std::make_shared<event>();
+    connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
+
+    connection->start().get();
+    ASSERT_EQ(std::vector<utility::string_t>{ _XPLATSTR("server1") }, *negotiated_hosts);
+
+    ASSERT_FALSE(reconnected_event->wait(5000));
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+    ASSERT_EQ(std::vector<utility::string_t>({ _XPLATSTR("server1"), _XPLATSTR("server2") }), *reconnect_hosts);
+}
+
+TEST(connection_impl_set_configuration, set_failover_urls_can_be_set_only_in_disconnected_state)
+{
+    can_be_set_only_in_disconnected_state(
+        [](connection_impl* connection) { connection->set_failover_urls({ _XPLATSTR("http://server2") }); },
+        "cannot set failover urls when the connection is not in the disconnected state. current connection state: connected");
+}
+
+TEST(connection_impl_hot_standby, connection_lost_switches_to_standby_without_reconnecting)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    auto connect_urls = std::make_shared<std::vector<utility::string_t>>();
+    auto connect_urls_lock = std::make_shared<std::mutex>();
+    auto websocket_client_count = std::make_shared<std::atomic<int>>(0);
+
+    auto websocket_client_factory = [writer, connect_urls, connect_urls_lock, websocket_client_count]()
+    {
+        auto is_first = (*websocket_client_count)++ == 0;
+        auto call_number = std::make_shared<int>(-1);
+
+        return create_test_websocket_client(
+            /* receive function */ [writer, is_first, call_number]()
+            {
+                if (++(*call_number) == 0)
+                {
+                    return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }"));
+                }
+
+                if (is_first && *call_number == 1)
+                {
+                    // drop the first connection only after the standby connection is ready
+                    for (int i = 0; i < 500; i++)
+                    {
+                        auto entries = writer->get_log_entries();
+                        if (!filter_vector(entries, _XPLATSTR("standby connection ready")).empty())
+                        {
+                            break;
+                        }
+
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+
+                    return pplx::task_from_exception<std::string>(std::runtime_error("connection exception"));
+                }
+
+                return pplx::task_from_result(std::string("{}"));
+            },
+            /* send function */ [](const utility::string_t){ return pplx::task_from_result(); },
+            /* connect function */[connect_urls, connect_urls_lock](const web::uri& url)
+            {
+                std::lock_guard<std::mutex> lock(*connect_urls_lock);
+                connect_urls->push_back(url.path());
+                return pplx::task_from_result();
+            });
+    };
+
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::state_changes | trace_level::info, writer,
+        create_test_web_request_factory(), std::make_unique<test_transport_factory>(websocket_client_factory));
+    connection->set_hot_standby(true);
+
+    auto reconnected_event = std::make_shared<event>();
+    connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
+
+    connection->start().get();
+
+    ASSERT_FALSE(reconnected_event->wait(5000));
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+
+    auto statistics = connection->get_reconnect_statistics();
+    ASSERT_EQ(1U, statistics.successful_reconnects);
+    ASSERT_EQ(0U, statistics.attempts);
+
+    std::lock_guard<std::mutex> lock(*connect_urls_lock);
+    ASSERT_TRUE(std::find(connect_urls->begin(), connect_urls->end(), _XPLATSTR("/reconnect")) == connect_urls->end());
+    ASSERT_GE(std::count(connect_urls->begin(), connect_urls->end(), _XPLATSTR("/connect")), 2);
+}
+
+TEST(connection_impl_hot_standby, messages_received_only_by_standby_are_replayed_when_switching_to_standby)
+{
+    auto writer = std::make_shared<memory_log_writer>();
+    auto websocket_client_count = std::make_shared<std::atomic<int>>(0);
+
+    auto websocket_client_factory = [writer, websocket_client_count]()
+    {
+        auto is_first = (*websocket_client_count)++ == 0;
+        auto call_number = std::make_shared<int>(-1);
+
+        return create_test_websocket_client(
+            /* receive function */ [writer, is_first, call_number]()
+            {
+                ++(*call_number);
+                if (*call_number == 0)
+                {
+                    return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }"));
+                }
+
+                if (*call_number == 1)
+                {
+                    return pplx::task_from_result(std::string("{ \"C\":\"m1\", \"M\":[\"a\"] }"));
+                }
+
+                if (is_first && *call_number == 2)
+                {
+                    // drop the first connection only after the standby connection is ready
+                    for (int i = 0; i < 500; i++)
+                    {
+                        auto entries = writer->get_log_entries();
+                        if (!filter_vector(entries, _XPLATSTR("standby connection ready")).empty())
+                        {
+                            break;
+                        }
+
+                        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    }
+
+                    return pplx::task_from_exception<std::string>(std::runtime_error("connection exception"));
+                }
+
+                if (!is_first && *call_number == 2)
+                {
+                    // only the standby connection receives this message
+                    return pplx::task_from_result(std::string("{ \"C\":\"m2\", \"M\":[\"b\"] }"));
+                }
+
+                return pplx::task_from_result(std::string("{}"));
+            });
+    };
+
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::state_changes | trace_level::info, writer,
+        create_test_web_request_factory(), std::make_unique<test_transport_factory>(websocket_client_factory));
+    connection->set_hot_standby(true);
+
+    auto messages = std::make_shared<std::vector<utility::string_t>>();
+    auto messages_lock = std::make_shared<std::mutex>();
+    auto last_message_received = std::make_shared<event>();
+    connection->set_message_received_string([messages, messages_lock, last_message_received](const utility::string_t& m)
+    {
+        std::lock_guard<std::mutex> lock(*messages_lock);
+        messages->push_back(m);
+        if (m == _XPLATSTR("b"))
+        {
+            last_message_received->set();
+        }
+    });
+
+    connection->start().get();
+
+    ASSERT_FALSE(last_message_received->wait(5000));
+
+    std::lock_guard<std::mutex> lock(*messages_lock);
+    ASSERT_EQ(std::vector<utility::string_t>({ _XPLATSTR("a"), _XPLATSTR("b") }), *messages);
+}
+
+TEST(connection_impl_set_configuration, set_hot_standby_can_be_set_only_in_disconnected_state)
+{
+    can_be_set_only_in_disconnected_state(
+        [](connection_impl* connection) { connection->set_hot_standby(true); },
+        "cannot set hot standby when the connection is not in the disconnected state. current connection state: connected");
+}
+
+TEST(connection_impl_keep_alive, reconnects_if_nothing_received_within_keep_alive_timeout)
+{
+    auto web_request_factory = std::make_unique<test_web_request_factory>([](const web::uri& url)
+    {
+        auto response_body =
+            url.path() == _XPLATSTR("/negotiate")
+            ? _XPLATSTR("{\"Url\":\"/signalr\", \"ConnectionToken\" : \"A==\", \"ConnectionId\" : \"f7707523-307d-4cba-9abf-3eef701241e8\", ")
+            _XPLATSTR("\"KeepAliveTimeout\" : 0.2, \"DisconnectTimeout\" : 10.0, \"ConnectionTimeout\" : 110.0, \"TryWebSockets\" : true, ")
+            _XPLATSTR("\"ProtocolVersion\" : \"1.4\", \"TransportConnectTimeout\" : 5.0, \"LongPollDelay\" : 0.0}")
+            : url.path() == _XPLATSTR("/start")
+                ? _XPLATSTR("{\"Response\":\"started\" }")
+                : _XPLATSTR("");
+
+        return std::unique_ptr<web_request>(new web_request_stub((unsigned short)200, _XPLATSTR("OK"), response_body));
+    });
+
+    auto call_number = std::make_shared<std::atomic<int>>(-1);
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]()
+        {
+            auto current_call = ++(*call_number);
+            if (current_call == 0)
+            {
+                return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }"));
+            }
+
+            // half-open connection - the second receive never completes
+            if (current_call == 1)
+            {
+                return pplx::create_task(pplx::task_completion_event<std::string>());
+            }
+
+            return pplx::create_task([]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                return std::string("{}");
+            });
+        });
+
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::none, std::make_shared<trace_log_writer>(),
+        std::move(web_request_factory), std::make_unique<test_transport_factory>(websocket_client));
+    connection->set_reconnect_delay(100);
+
+    auto reconnected_event = std::make_shared<event>();
+    connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
+
+    connection->start().get();
+
+    ASSERT_FALSE(reconnected_event->wait(5000));
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+
+    auto statistics = connection->get_reconnect_statistics();
+    ASSERT_EQ(1U, statistics.keep_alive_timeouts);
+    ASSERT_GT(statistics.last_keep_alive_detection_time, std::chrono::milliseconds(200));
+    ASSERT_EQ(1U, statistics.successful_reconnects);
+
+    connection->stop().get();
+}
+
+TEST(connection_impl_keep_alive, connection_not_lost_again_if_server_silent_for_less_than_timeout_after_reconnect)
+{
+    auto web_request_factory = std::make_unique<test_web_request_factory>([](const web::uri& url)
+    {
+        auto response_body =
+            url.path() == _XPLATSTR("/negotiate")
+            ? _XPLATSTR("{\"Url\":\"/signalr\", \"ConnectionToken\" : \"A==\", \"ConnectionId\" : \"f7707523-307d-4cba-9abf-3eef701241e8\", ")
+            _XPLATSTR("\"KeepAliveTimeout\" : 0.2, \"DisconnectTimeout\" : 10.0, \"ConnectionTimeout\" : 110.0, \"TryWebSockets\" : true, ")
+            _XPLATSTR("\"ProtocolVersion\" : \"1.4\", \"TransportConnectTimeout\" : 5.0, \"LongPollDelay\" : 0.0}")
+            : url.path() == _XPLATSTR("/start")
+                ? _XPLATSTR("{\"Response\":\"started\" }")
+                : _XPLATSTR("");
+
+        return std::unique_ptr<web_request>(new web_request_stub((unsigned short)200, _XPLATSTR("OK"), response_body));
+    });
+
+    auto call_number = std::make_shared<std::atomic<int>>(-1);
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]()
+        {
+            auto current_call = ++(*call_number);
+            if (current_call == 0)
+            {
+                return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }"));
+            }
+
+            // half-open connection - the second receive never completes
+            if (current_call == 1)
+            {
+                return pplx::create_task(pplx::task_completion_event<std::string>());
+            }
 
-    ASSERT_EQ(connection_state::disconnected, connection->get_connection_state());
-}
+            // after reconnecting the server is silent for a while but always for less than the keep-alive timeout
+            return pplx::create_task([]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(150));
+                return std::string("{}");
+            });
+        });
 
-TEST(connection_impl_set_config, config_can_be_set_only_in_disconnected_state)
-{
-    can_be_set_only_in_disconnected_state(
-        [](connection_impl* connection) 
-        {
-            signalr::signalr_client_config signalr_client_config;
-            connection->set_client_config(signalr_client_config);
-        },"cannot set client config when the connection is not in the disconnected state. current connection state: connected");
-}
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::none, std::make_shared<trace_log_writer>(),
+        std::move(web_request_factory), std::make_unique<test_transport_factory>(websocket_client));
+    connection->set_reconnect_delay(100);
 
-TEST(connection_impl_change_state, change_state_logs)
-{
-    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
-    auto websocket_client = create_test_websocket_client(
-        /* receive function */ []() { return pplx::task_from_result(std::string("{\"C\":\"x\", \"S\":1, \"M\":[] }")); });
-    auto connection = create_connection(websocket_client, writer, trace_level::state_changes);
+    auto reconnected_event = std::make_shared<event>();
+    connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
 
-    connection->start().wait();
+    connection->start().get();
 
-    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
-    ASSERT_FALSE(log_entries.empty());
+    ASSERT_FALSE(reconnected_event->wait(5000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
 
-    auto entry = remove_date_from_log_entry(log_entries[0]);
-    ASSERT_EQ(_XPLATSTR("[state change] disconnected -> connecting\n"), entry);
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+    auto statistics = connection->get_reconnect_statistics();
+    ASSERT_EQ(1U, statistics.keep_alive_timeouts);
+    ASSERT_EQ(1U, statistics.reconnects);
+
+    connection->stop().get();
 }
 
-TEST(connection_impl_reconnect, can_reconnect)
+TEST(connection_impl_outbox, messages_sent_while_reconnecting_sent_in_order_after_reconnected)
 {
+    auto sent_messages = std::make_shared<std::vector<utility::string_t>>();
+    auto sent_messages_lock = std::make_shared<std::mutex>();
+
     int call_number = -1;
     auto websocket_client = create_test_websocket_client(
         /* receive function */ [call_number]() mutable
@@ -1159,19 +1987,44 @@ TEST(connection_impl_reconnect, can_reconnect)
             return call_number == 2
                 ? pplx::task_from_exception<std::string>(std::runtime_error("connection exception"))
                 : pplx::task_from_result(responses[call_number]);
+        },
+        /* send function */ [sent_messages, sent_messages_lock](const utility::string_t& message)
+        {
+            std::lock_guard<std::mutex> lock(*sent_messages_lock);
+            sent_messages->push_back(message);
+            return pplx::task_from_result();
         });
 
     auto connection = create_connection(websocket_client);
     connection->set_reconnect_delay(100);
+    connection->set_reconnect_outbox(10, 1024);
+
+    auto send_tasks = std::make_shared<std::vector<pplx::task<void>>>();
+    auto weak_connection = std::weak_ptr<connection_impl>(connection);
+    connection->set_reconnecting([weak_connection, send_tasks]()
+    {
+        auto connection = weak_connection.lock();
+        send_tasks->push_back(connection->send(_XPLATSTR("a")));
+        send_tasks->push_back(connection->send(_XPLATSTR("b")));
+        send_tasks->push_back(connection->send(_XPLATSTR("c")));
+    });
+
     auto reconnected_event = std::make_shared<event>();
     connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
     connection->start();
 
     ASSERT_FALSE(reconnected_event->wait(5000));
-    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+    ASSERT_EQ(3U, send_tasks->size());
+    for (auto& send_task : *send_tasks)
+    {
+        send_task.get();
+    }
+
+    std::lock_guard<std::mutex> lock(*sent_messages_lock);
+    ASSERT_EQ(std::vector<utility::string_t>({ _XPLATSTR("a"), _XPLATSTR("b"), _XPLATSTR("c") }), *sent_messages);
 }
 
-TEST(connection_impl_reconnect, successful_reconnect_state_changes)
+TEST(connection_impl_outbox, send_fails_if_outbox_full)
 {
     int call_number = -1;
     auto websocket_client = create_test_websocket_client(
@@ -1192,24 +2045,40 @@ TEST(connection_impl_reconnect, successful_reconnect_state_changes)
                 : pplx::task_from_result(responses[call_number]);
         });
 
-    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
-    auto connection = create_connection(websocket_client, writer, trace_level::state_changes);
+    auto connection = create_connection(websocket_client);
     connection->set_reconnect_delay(100);
+    connection->set_reconnect_outbox(1, 1024);
+
+    auto send_tasks = std::make_shared<std::vector<pplx::task<void>>>();
+    auto weak_connection = std::weak_ptr<connection_impl>(connection);
+    connection->set_reconnecting([weak_connection, send_tasks]()
+    {
+        auto connection = weak_connection.lock();
+        send_tasks->push_back(connection->send(_XPLATSTR("a")));
+        send_tasks->push_back(connection->send(_XPLATSTR("b")));
+    });
+
     auto reconnected_event = std::make_shared<event>();
     connection->set_reconnected([reconnected_event](){ reconnected_event->set(); });
     connection->start();
 
     ASSERT_FALSE(reconnected_event->wait(5000));
+    ASSERT_EQ(2U, send_tasks->size());
 
-    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
-    ASSERT_EQ(4, log_entries.size());
-    ASSERT_EQ(_XPLATSTR("[state change] disconnected -> connecting\n"), remove_date_from_log_entry(log_entries[0]));
-    ASSERT_EQ(_XPLATSTR("[state change] connecting -> connected\n"), remove_date_from_log_entry(log_entries[1]));
-    ASSERT_EQ(_XPLATSTR("[state change] connected -> reconnecting\n"), remove_date_from_log_entry(log_entries[2]));
-    ASSERT_EQ(_XPLATSTR("[state change] reconnecting -> connected\n"), remove_date_from_log_entry(log_entries[3]));
+    (*send_tasks)[0].get();
+
+    try
+    {
+        (*send_tasks)[1].get();
+        ASSERT_TRUE(false); // exception expected but not thrown
+    }
+    catch (const signalr_exception& e)
+    {
+        ASSERT_STREQ("cannot send data because the outbox is full. current connection state: reconnecting", e.what());
+    }
 }
 
-TEST(connection_impl_reconnect, connection_stopped_if_reconnecting_failed)
+TEST(connection_impl_outbox, buffered_messages_fail_if_reconnecting_failed)
 {
     auto web_request_factory = std::make_unique<test_web_request_factory>([](const web::uri& url)
     {
@@ -1226,7 +2095,6 @@ TEST(connection_impl_reconnect, connection_stopped_if_reconnecting_failed)
     });
 
     int call_number = -1;
-    int reconnect_invocations = 0;
     auto websocket_client = create_test_websocket_client(
         /* receive function */ [call_number]() mutable
         {
@@ -1245,38 +2113,188 @@ TEST(connection_impl_reconnect, connection_stopped_if_reconnecting_failed)
                 : pplx::task_from_result(responses[call_number]);
         },
         /* send function */ [](const utility::string_t){ return pplx::task_from_exception<void>(std::runtime_error("should not be invoked"));  },
-        /* connect function */[&reconnect_invocations](const web::uri& url)
+        /* connect function */[](const web::uri& url)
         {
             if (url.path() == _XPLATSTR("/reconnect"))
             {
-                reconnect_invocations++;
                 return pplx::task_from_exception<void>(std::runtime_error("reconnect rejected"));
             }
 
             return pplx::task_from_result();
         });
 
-    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
     auto connection =
-        connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::state_changes,
-        writer, std::move(web_request_factory), std::make_unique<test_transport_factory>(websocket_client));
+        connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::none,
+        std::make_shared<trace_log_writer>(), std::move(web_request_factory), std::make_unique<test_transport_factory>(websocket_client));
+    connection->set_reconnect_delay(100);
+    connection->set_reconnect_outbox(10, 1024);
+
+    auto send_tasks = std::make_shared<std::vector<pplx::task<void>>>();
+    auto weak_connection = std::weak_ptr<connection_impl>(connection);
+    connection->set_reconnecting([weak_connection, send_tasks]()
+    {
+        auto connection = weak_connection.lock();
+        send_tasks->push_back(connection->send(_XPLATSTR("a")));
+    });
 
     auto disconnected_event = std::make_shared<event>();
     connection->set_disconnected([disconnected_event](){ disconnected_event->set(); });
-    connection->set_reconnect_delay(100);
     connection->start();
 
     ASSERT_FALSE(disconnected_event->wait(5000));
-    ASSERT_EQ(connection_state::disconnected, connection->get_connection_state());
-    ASSERT_GE(reconnect_invocations, 2);
+    ASSERT_EQ(1U, send_tasks->size());
+
+    try
+    {
+        (*send_tasks)[0].get();
+        ASSERT_TRUE(false); // exception expected but not thrown
+    }
+    catch (const signalr_exception& e)
+    {
+        ASSERT_STREQ("the connection was stopped before the buffered message could be sent", e.what());
+    }
+}
+
+static std::unique_ptr<web_request_factory> create_negotiate_counting_web_request_factory(const std::shared_ptr<std::atomic<int>>& negotiate_requests)
+{
+    return std::make_unique<test_web_request_factory>([negotiate_requests](const web::uri& url)
+    {
+        if (url.path() == _XPLATSTR("/negotiate"))
+        {
+            (*negotiate_requests)++;
+        }
+
+        return create_test_web_request_factory()->create_web_request(url);
+    });
+}
+
+TEST(connection_impl_fast_restart, restart_reuses_previous_negotiation)
+{
+    auto negotiate_requests = std::make_shared<std::atomic<int>>(0);
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); });
+
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::none, std::make_shared<trace_log_writer>(),
+        create_negotiate_counting_web_request_factory(negotiate_requests), std::make_unique<test_transport_factory>(websocket_client));
+    connection->set_fast_restart(60000);
+
+    connection->start().get();
+    auto connection_id = connection->get_connection_id();
+    connection->stop().get();
+
+    connection->start().get();
+
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+    ASSERT_EQ(connection_id, connection->get_connection_id());
+    ASSERT_EQ(1, negotiate_requests->load());
+}
+
+TEST(connection_impl_fast_restart, restart_negotiates_if_previous_negotiation_rejected)
+{
+    auto negotiate_requests = std::make_shared<std::atomic<int>>(0);
+    auto connect_attempts = std::make_shared<std::atomic<int>>(0);
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); },
+        /* send function */ [](const utility::string_t){ return pplx::task_from_result(); },
+        /* connect function */[connect_attempts](const web::uri&)
+        {
+            // the server rejects the connection token of the first connection when restarting
+            return ++(*connect_attempts) == 2
+                ? pplx::task_from_exception<void>(std::runtime_error("connection token rejected"))
+                : pplx::task_from_result();
+        });
+
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::none, std::make_shared<trace_log_writer>(),
+        create_negotiate_counting_web_request_factory(negotiate_requests), std::make_unique<test_transport_factory>(websocket_client));
+    connection->set_fast_restart(60000);
+
+    connection->start().get();
+    connection->stop().get();
+
+    connection->start().get();
+
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+    ASSERT_EQ(3, connect_attempts->load());
+    ASSERT_EQ(2, negotiate_requests->load());
+}
+
+TEST(connection_impl_fast_restart, restart_negotiates_if_fast_restart_disabled)
+{
+    auto negotiate_requests = std::make_shared<std::atomic<int>>(0);
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); });
+
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::none, std::make_shared<trace_log_writer>(),
+        create_negotiate_counting_web_request_factory(negotiate_requests), std::make_unique<test_transport_factory>(websocket_client));
+
+    connection->start().get();
+    connection->stop().get();
+    connection->start().get();
+
+    ASSERT_EQ(2, negotiate_requests->load());
+}
+
+TEST(connection_impl_speculative_connect, transport_prepared_before_negotiate_response_received)
+{
+    class preparing_transport_factory : public test_transport_factory
+    {
+    public:
+        preparing_transport_factory(const std::shared_ptr<websocket_client>& websocket_client, const std::shared_ptr<std::vector<utility::string_t>>& events)
+            : test_transport_factory(websocket_client), m_events(events)
+        { }
+
+        void prepare_transport(transport_type, const signalr_client_config&) override
+        {
+            m_events->push_back(_XPLATSTR("prepare_transport"));
+        }
+
+    private:
+        std::shared_ptr<std::vector<utility::string_t>> m_events;
+    };
+
+    auto events = std::make_shared<std::vector<utility::string_t>>();
+    auto web_request_factory = std::make_unique<test_web_request_factory>([events](const web::uri& url)
+    {
+        events->push_back(url.path());
+        return create_test_web_request_factory()->create_web_request(url);
+    });
+
+    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); });
+
+    auto connection = connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::info, writer,
+        std::move(web_request_factory), std::make_unique<preparing_transport_factory>(websocket_client, events));
+    connection->set_speculative_connect(true);
+
+    connection->start().get();
+
+    ASSERT_EQ(connection_state::connected, connection->get_connection_state());
+    ASSERT_EQ(std::vector<utility::string_t>({ _XPLATSTR("prepare_transport"), _XPLATSTR("/negotiate"), _XPLATSTR("/start") }), *events);
 
     auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
-    ASSERT_EQ(5, log_entries.size());
-    ASSERT_EQ(_XPLATSTR("[state change] disconnected -> connecting\n"), remove_date_from_log_entry(log_entries[0]));
-    ASSERT_EQ(_XPLATSTR("[state change] connecting -> connected\n"), remove_date_from_log_entry(log_entries[1]));
-    ASSERT_EQ(_XPLATSTR("[state change] connected -> reconnecting\n"), remove_date_from_log_entry(log_entries[2]));
-    ASSERT_EQ(_XPLATSTR("[state change] reconnecting -> disconnecting\n"), remove_date_from_log_entry(log_entries[3]));
-    ASSERT_EQ(_XPLATSTR("[state change] disconnecting -> disconnected\n"), remove_date_from_log_entry(log_entries[4]));
+    ASSERT_EQ(1U, filter_vector(log_entries, _XPLATSTR("speculative connect: on")).size()) << dump_vector(log_entries);
+}
+
+TEST(connection_impl_set_configuration, set_speculative_connect_can_be_set_only_in_disconnected_state)
+{
+    can_be_set_only_in_disconnected_state(
+        [](connection_impl* connection) { connection->set_speculative_connect(true); },
+        "cannot set speculative connect when the connection is not in the disconnected state. current connection state: connected");
+}
+
+TEST(connection_impl_set_configuration, set_fast_restart_can_be_set_only_in_disconnected_state)
+{
+    can_be_set_only_in_disconnected_state(
+        [](connection_impl* connection) { connection->set_fast_restart(1000); },
+        "cannot set fast restart when the connection is not in the disconnected state. current connection state: connected");
+}
+
+TEST(connection_impl_set_configuration, set_reconnect_outbox_can_be_set_only_in_disconnected_state)
+{
+    can_be_set_only_in_disconnected_state(
+        [](connection_impl* connection) { connection->set_reconnect_outbox(10, 1024); },
+        "cannot set reconnect outbox when the connection is not in the disconnected state. current connection state: connected");
 }
 
 TEST(connection_impl_reconnect, reconnect_works_if_connection_dropped_during_after_init_and_before_start_successfully_completed)
@@ -2081,4 +3099,120 @@ TEST(connection_token, connection_token_reset_when_starting_connection)
         }).get();
 
     ASSERT_EQ(_XPLATSTR(""), connection->get_connection_token());
+}
+
+TEST(connection_impl_statistics, counters_updated_for_received_and_sent_messages)
+{
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]()
+        mutable {
+        std::string responses[]
+        {
+            "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{ 42",
+            "{ \"C\":\"d-486F0DF9-BAO,5|BAV,1|BAW,0\", \"M\" : [\"first\", \"second\"] }",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 3);
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto connection = create_connection(websocket_client);
+
+    auto message_received_event = std::make_shared<event>();
+    connection->set_message_received_string([message_received_event](const utility::string_t& message)
+    {
+        if (message == _XPLATSTR("second"))
+        {
+            message_received_event->set();
+        }
+    });
+
+    connection->start()
+        .then([connection]()
+        {
+            return connection->send(_XPLATSTR("data"));
+        }).get();
+
+    ASSERT_FALSE(message_received_event->wait(5000));
+
+    auto statistics = connection->get_statistics();
+    ASSERT_LE(4U, statistics.frames_received);
+    ASSERT_EQ(1U, statistics.parse_errors);
+    ASSERT_LE(2U, statistics.frames_parsed);
+    ASSERT_EQ(2U, statistics.messages_received);
+    ASSERT_EQ(1U, statistics.messages_sent);
+    ASSERT_EQ(4 * sizeof(utility::char_t), statistics.bytes_sent);
+    ASSERT_LT(0U, statistics.bytes_received);
+    ASSERT_EQ(0U, statistics.outbound_queue_depth);
+    ASSERT_EQ(0U, statistics.pending_invocations);
+}
+
+TEST(connection_impl_statistics, time_in_state_tracked)
+{
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{\"C\":\"x\", \"S\":1, \"M\":[] }")); });
+
+    auto connection = create_connection(websocket_client);
+
+    connection->start().get();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto statistics = connection->get_statistics();
+    ASSERT_GE(statistics.time_connected, std::chrono::milliseconds(50));
+    ASSERT_EQ(std::chrono::milliseconds(0), statistics.time_reconnecting);
+
+    connection->stop().get();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto stopped_statistics = connection->get_statistics();
+    ASSERT_GE(stopped_statistics.time_connected, statistics.time_connected);
+    ASSERT_GE(stopped_statistics.time_disconnected, statistics.time_disconnected + std::chrono::milliseconds(20));
+}
+
+TEST(connection_impl_metrics, source_added_to_metrics_sink_while_connection_alive)
+{
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{\"C\":\"x\", \"S\":1, \"M\":[] }")); });
+
+    auto exporter = std::make_shared<prometheus_exporter>();
+    signalr_client_config config;
+    config.set_metrics_sink(exporter);
+
+    auto connection = create_connection(websocket_client);
+    connection->set_client_config(config);
+    connection->start().get();
+
+    auto metrics = exporter->render();
+    ASSERT_NE(std::string::npos, metrics.find("signalr_connection_up{url=\"")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("\"} 1\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("state=\"connected\"}")) << metrics;
+
+    connection->stop().get();
+    connection = nullptr;
+
+    metrics = exporter->render();
+    ASSERT_EQ(std::string::npos, metrics.find("signalr_connection_up{")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("# TYPE signalr_connection_up gauge\n")) << metrics;
+}
+
+TEST(connection_impl_metrics, source_moved_when_metrics_sink_replaced)
+{
+    auto first_exporter = std::make_shared<prometheus_exporter>();
+    auto second_exporter = std::make_shared<prometheus_exporter>();
+
+    auto connection = create_connection();
+
+    signalr_client_config config;
+    config.set_metrics_sink(first_exporter);
+    connection->set_client_config(config);
+
+    config.set_metrics_sink(second_exporter);
+    connection->set_client_config(config);
+
+    ASSERT_EQ(std::string::npos, first_exporter->render().find("signalr_connection_up{"));
+    ASSERT_NE(std::string::npos, second_exporter->render().find("signalr_connection_up{"));
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "test_utils.h"
+#include "signalrclient/connection_pool.h"
+
+using namespace signalr;
+
+TEST(connection_pool_get_health, health_includes_all_connections_in_the_pool)
+{
+    connection_pool pool(2);
+
+    pool.create_connection(create_uri());
+    auto hub_connection = pool.create_hub_connection(create_uri());
+
+    auto health = pool.get_health();
+    ASSERT_EQ(2U, health.connections);
+    ASSERT_EQ(2U, health.disconnected);
+    ASSERT_EQ(0U, health.connected);
+    ASSERT_EQ(0U, health.reconnects);
+
+    pool.remove(hub_connection);
+
+    ASSERT_EQ(1U, pool.get_health().connections);
+}
+
+TEST(connection_pool_stop_all, stop_all_completes_if_connections_not_started)
+{
+    connection_pool pool(1);
+
+    pool.create_connection(create_uri());
+    pool.create_hub_connection(create_uri());
+
+    pool.stop_all().get();
+
+    ASSERT_EQ(2U, pool.get_health().disconnected);
+}
+
+TEST(connection_pool_start_all, start_all_completes_if_pool_is_empty)
+{
+    connection_pool pool(1);
+
+    pool.start_all().get();
+
+    ASSERT_EQ(0U, pool.get_health().connections);
+}
@@ -0,0 +1,95 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "pplx/pplxtasks.h"
+#include "signalrclient/dispatch_pool.h"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace signalr;
+
+TEST(dispatch_pool_ctor, throws_if_thread_count_is_zero)
+{
+    try
+    {
+        dispatch_pool pool(0);
+        ASSERT_TRUE(false); // exception expected but not thrown
+    }
+    catch (const std::invalid_argument& e)
+    {
+        ASSERT_STREQ("thread_count must be greater than 0", e.what());
+    }
+}
+
+TEST(dispatch_pool_get_event_loop, event_loops_handed_out_round_robin)
+{
+    dispatch_pool pool(2);
+
+    auto loop1 = pool.get_event_loop();
+    auto loop2 = pool.get_event_loop();
+
+    ASSERT_EQ(2U, pool.get_thread_count());
+    ASSERT_NE(loop1, loop2);
+    ASSERT_EQ(loop1, pool.get_event_loop());
+    ASSERT_EQ(loop2, pool.get_event_loop());
+}
+
+TEST(dispatch_pool_get_event_loop, work_items_executed_on_pool_threads)
+{
+    dispatch_pool pool(2);
+
+    auto loop = pool.get_event_loop();
+    pplx::task_completion_event<std::thread::id> first_tce, second_tce;
+    loop->post([first_tce]() { first_tce.set(std::this_thread::get_id()); });
+    loop->post([second_tce]() { second_tce.set(std::this_thread::get_id()); });
+
+    auto first_thread_id = pplx::create_task(first_tce).get();
+    ASSERT_NE(std::this_thread::get_id(), first_thread_id);
+    ASSERT_EQ(first_thread_id, pplx::create_task(second_tce).get());
+}
+
+TEST(dispatch_pool_get_statistics, statistics_reported_per_thread)
+{
+    dispatch_pool pool(2, _XPLATSTR("test"));
+
+    pplx::task_completion_event<void> tce;
+    pool.get_event_loop()->post([tce]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        tce.set();
+    });
+    pplx::create_task(tce).get();
+
+    auto statistics = pool.get_statistics();
+    ASSERT_EQ(2U, statistics.size());
+    ASSERT_EQ(_XPLATSTR("test-0"), statistics[0].thread_name);
+    ASSERT_EQ(_XPLATSTR("test-1"), statistics[1].thread_name);
+    ASSERT_EQ(0U, statistics[1].executed_work_items);
+
+    // the statistics are updated after the work item completes
+    while (pool.get_statistics()[0].executed_work_items == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    statistics = pool.get_statistics();
+    ASSERT_EQ(1U, statistics[0].executed_work_items);
+    ASSERT_GE(statistics[0].busy_time, std::chrono::nanoseconds(std::chrono::milliseconds(10)));
+    ASSERT_GE(statistics[0].uptime, statistics[0].busy_time);
+    ASSERT_EQ(0U, statistics[0].pending_work_items);
+}
+
+#ifdef __linux__
+TEST(dispatch_pool_ctor, threads_pinned_to_cpus)
+{
+    dispatch_pool pool(1, _XPLATSTR("test"), std::vector<unsigned int> { 0 });
+
+    pplx::task_completion_event<int> tce;
+    pool.get_event_loop()->post([tce]() { tce.set(sched_getcpu()); });
+
+    ASSERT_EQ(0, pplx::create_task(tce).get());
+}
+#endif
@@ -0,0 +1,176 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "dns_cache.h"
+#include "event.h"
+#include "signalrclient/signalr_exception.h"
+
+using namespace signalr;
+
+namespace
+{
+    struct fake_clock
+    {
+        std::shared_ptr<std::chrono::steady_clock::time_point> now = std::make_shared<std::chrono::steady_clock::time_point>();
+
+        dns_cache::clock get_clock() const
+        {
+            auto now_ptr = now;
+            return [now_ptr]() { return *now_ptr; };
+        }
+
+        void advance(std::chrono::milliseconds duration)
+        {
+            *now += duration;
+        }
+    };
+
+    // waits until the background lookups have completed
+    void wait_for_lookups(const std::shared_ptr<dns_cache>& cache, const utility::string_t& host)
+    {
+        for (int i = 0; i < 500 && cache->get_status(host) == dns_cache::host_status::unknown; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+TEST(dns_cache_resolve, resolves_host_using_resolver)
+{
+    auto cache = dns_cache::create([](const utility::string_t& host)
+    {
+        return std::vector<utility::string_t> { host + _XPLATSTR("-address") };
+    }, std::chrono::milliseconds(1000), std::chrono::milliseconds(100));
+
+    auto addresses = cache->resolve(_XPLATSTR("server")).get();
+
+    ASSERT_EQ(std::vector<utility::string_t> { _XPLATSTR("server-address") }, addresses);
+    ASSERT_EQ(1U, cache->get_statistics().lookups);
+}
+
+TEST(dns_cache_resolve, fresh_entries_served_from_cache)
+{
+    auto lookups = std::make_shared<std::atomic<int>>(0);
+    fake_clock clock;
+
+    auto cache = dns_cache::create([lookups](const utility::string_t&)
+    {
+        (*lookups)++;
+        return std::vector<utility::string_t> { _XPLATSTR("127.0.0.1") };
+    }, std::chrono::milliseconds(1000), std::chrono::milliseconds(100), clock.get_clock());
+
+    cache->resolve(_XPLATSTR("server")).get();
+    wait_for_lookups(cache, _XPLATSTR("server"));
+
+    clock.advance(std::chrono::milliseconds(500));
+    ASSERT_EQ(std::vector<utility::string_t> { _XPLATSTR("127.0.0.1") }, cache->resolve(_XPLATSTR("server")).get());
+
+    ASSERT_EQ(1, lookups->load());
+    auto statistics = cache->get_statistics();
+    ASSERT_EQ(1U, statistics.lookups);
+    ASSERT_EQ(1U, statistics.hits);
+}
+
+TEST(dns_cache_resolve, concurrent_lookups_of_the_same_host_share_resolver_call)
+{
+    auto lookups = std::make_shared<std::atomic<int>>(0);
+    auto resolver_blocked = std::make_shared<event>();
+
+    auto cache = dns_cache::create([lookups, resolver_blocked](const utility::string_t&)
+    {
+        (*lookups)++;
+        resolver_blocked->wait(5000);
+        return std::vector<utility::string_t> { _XPLATSTR("127.0.0.1") };
+    }, std::chrono::milliseconds(1000), std::chrono::milliseconds(100));
+
+    auto lookup1 = cache->resolve(_XPLATSTR("server"));
+    auto lookup2 = cache->resolve(_XPLATSTR("server"));
+    resolver_blocked->set();
+
+    ASSERT_EQ(std::vector<utility::string_t> { _XPLATSTR("127.0.0.1") }, lookup1.get());
+    ASSERT_EQ(std::vector<utility::string_t> { _XPLATSTR("127.0.0.1") }, lookup2.get());
+    ASSERT_EQ(1, lookups->load());
+}
+
+TEST(dns_cache_resolve, expired_entries_served_while_refreshed)
+{
+    auto lookups = std::make_shared<std::atomic<int>>(0);
+    fake_clock clock;
+
+    auto cache = dns_cache::create([lookups](const utility::string_t&)
+    {
+        auto lookup = ++(*lookups);
+        return std::vector<utility::string_t> { lookup == 1 ? _XPLATSTR("10.0.0.1") : _XPLATSTR("10.0.0.2") };
+    }, std::chrono::milliseconds(1000), std::chrono::milliseconds(100), clock.get_clock());
+
+    cache->resolve(_XPLATSTR("server")).get();
+    wait_for_lookups(cache, _XPLATSTR("server"));
+
+    clock.advance(std::chrono::milliseconds(1500));
+    ASSERT_EQ(std::vector<utility::string_t> { _XPLATSTR("10.0.0.1") }, cache->resolve(_XPLATSTR("server")).get());
+
+    for (int i = 0; i < 500 && cache->resolve(_XPLATSTR("server")).get().front() != _XPLATSTR("10.0.0.2"); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_EQ(std::vector<utility::string_t> { _XPLATSTR("10.0.0.2") }, cache->resolve(_XPLATSTR("server")).get());
+    ASSERT_EQ(2, lookups->load());
+    ASSERT_LE(1U, cache->get_statistics().stale_hits);
+}
+
+TEST(dns_cache_resolve, failures_cached_for_failure_time_to_live)
+{
+    auto lookups = std::make_shared<std::atomic<int>>(0);
+    fake_clock clock;
+
+    auto cache = dns_cache::create([lookups](const utility::string_t&) -> std::vector<utility::string_t>
+    {
+        (*lookups)++;
+        throw signalr_exception(_XPLATSTR("could not resolve"));
+    }, std::chrono::milliseconds(1000), std::chrono::milliseconds(100), clock.get_clock());
+
+    for (int i = 0; i < 2; i++)
+    {
+        try
+        {
+            cache->resolve(_XPLATSTR("server")).get();
+            ASSERT_TRUE(false); // exception expected but not thrown
+        }
+        catch (const signalr_exception& e)
+        {
+            ASSERT_STREQ("could not resolve", e.what());
+        }
+
+        wait_for_lookups(cache, _XPLATSTR("server"));
+    }
+
+    ASSERT_EQ(1, lookups->load());
+    ASSERT_EQ(dns_cache::host_status::unresolvable, cache->get_status(_XPLATSTR("server")));
+
+    clock.advance(std::chrono::milliseconds(200));
+    ASSERT_THROW(cache->resolve(_XPLATSTR("server")).get(), signalr_exception);
+    ASSERT_EQ(2, lookups->load());
+}
+
+TEST(dns_cache_get_status, status_unknown_for_hosts_not_resolved)
+{
+    auto cache = dns_cache::create([](const utility::string_t&)
+    {
+        return std::vector<utility::string_t> { _XPLATSTR("127.0.0.1") };
+    }, std::chrono::milliseconds(1000), std::chrono::milliseconds(100));
+
+    ASSERT_EQ(dns_cache::host_status::unknown, cache->get_status(_XPLATSTR("server")));
+    ASSERT_EQ(0U, cache->get_statistics().lookups);
+
+    cache->resolve(_XPLATSTR("server")).get();
+    wait_for_lookups(cache, _XPLATSTR("server"));
+
+    ASSERT_EQ(dns_cache::host_status::resolved, cache->get_status(_XPLATSTR("server")));
+}
+
+TEST(dns_cache_resolve_host, resolves_ip_addresses)
+{
+    ASSERT_EQ(std::vector<utility::string_t> { _XPLATSTR("127.0.0.1") }, dns_cache::resolve_host(_XPLATSTR("127.0.0.1")));
+}
@@ -0,0 +1,110 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "endpoint_selector.h"
+
+using namespace signalr;
+
+namespace
+{
+    struct fake_clock
+    {
+        std::shared_ptr<std::chrono::steady_clock::time_point> now = std::make_shared<std::chrono::steady_clock::time_point>();
+
+        endpoint_selector::clock get_clock() const
+        {
+            auto now_ptr = now;
+            return [now_ptr]() { return *now_ptr; };
+        }
+
+        void advance(std::chrono::milliseconds duration)
+        {
+            *now += duration;
+        }
+    };
+
+    const web::uri server1(_XPLATSTR("http://server1/signalr"));
+    const web::uri server2(_XPLATSTR("http://server2/signalr"));
+    const web::uri server3(_XPLATSTR("http://server3/signalr"));
+}
+
+TEST(endpoint_selector_select, first_endpoint_selected_if_no_measurements)
+{
+    endpoint_selector selector(server1);
+    selector.set_endpoints(std::vector<web::uri>{ server1, server2 });
+
+    ASSERT_EQ(server1, selector.select());
+}
+
+TEST(endpoint_selector_select, endpoint_with_lowest_round_trip_time_selected)
+{
+    endpoint_selector selector(server1);
+    selector.set_endpoints(std::vector<web::uri>{ server1, server2, server3 });
+
+    selector.record_success(server1, std::chrono::milliseconds(30));
+    selector.record_success(server2, std::chrono::milliseconds(10));
+    selector.record_success(server3, std::chrono::milliseconds(20));
+
+    ASSERT_EQ(server2, selector.select());
+
+    // round trip time is smoothed so a single slow sample does not make the endpoint the slowest one
+    selector.record_success(server2, std::chrono::milliseconds(50));
+    ASSERT_EQ(server2, selector.select());
+
+    selector.record_success(server2, std::chrono::milliseconds(100));
+    ASSERT_EQ(server3, selector.select());
+}
+
+TEST(endpoint_selector_select, failed_endpoint_quarantined_until_quarantine_expires)
+{
+    fake_clock clock;
+    endpoint_selector selector(server1, clock.get_clock());
+    selector.set_endpoints(std::vector<web::uri>{ server1, server2 });
+
+    selector.record_success(server1, std::chrono::milliseconds(10));
+    selector.record_success(server2, std::chrono::milliseconds(20));
+    selector.record_failure(server1);
+
+    ASSERT_TRUE(selector.is_quarantined(server1));
+    ASSERT_EQ(server2, selector.select());
+
+    clock.advance(std::chrono::milliseconds(1001));
+
+    ASSERT_FALSE(selector.is_quarantined(server1));
+    ASSERT_EQ(server1, selector.select());
+}
+
+TEST(endpoint_selector_select, quarantine_time_doubles_with_consecutive_failures_and_resets_on_success)
+{
+    fake_clock clock;
+    endpoint_selector selector(server1, clock.get_clock());
+
+    selector.record_failure(server1);
+    selector.record_failure(server1);
+
+    clock.advance(std::chrono::milliseconds(1500));
+    ASSERT_TRUE(selector.is_quarantined(server1));
+
+    clock.advance(std::chrono::milliseconds(600));
+    ASSERT_FALSE(selector.is_quarantined(server1));
+
+    selector.record_success(server1, std::chrono::milliseconds(10));
+    selector.record_failure(server1);
+
+    clock.advance(std::chrono::milliseconds(1001));
+    ASSERT_FALSE(selector.is_quarantined(server1));
+}
+
+TEST(endpoint_selector_select, endpoint_whose_quarantine_ends_first_selected_if_all_quarantined)
+{
+    fake_clock clock;
+    endpoint_selector selector(server1, clock.get_clock());
+    selector.set_endpoints(std::vector<web::uri>{ server1, server2 });
+
+    selector.record_failure(server1);
+    selector.record_failure(server1);
+    selector.record_failure(server2);
+
+    ASSERT_EQ(server2, selector.select());
+}
@@ -0,0 +1,125 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/event_loop.h"
+
+using namespace signalr;
+
+TEST(event_loop_run_once, returns_false_if_no_work_queued)
+{
+    event_loop loop;
+
+    ASSERT_FALSE(loop.run_once());
+}
+
+TEST(event_loop_run_once, executes_work_items_one_at_a_time_in_order)
+{
+    event_loop loop;
+    std::vector<int> executed;
+
+    loop.post([&executed]() { executed.push_back(1); });
+    loop.post([&executed]() { executed.push_back(2); });
+
+    ASSERT_TRUE(loop.run_once());
+    ASSERT_EQ(1U, executed.size());
+
+    ASSERT_TRUE(loop.run_once());
+    ASSERT_FALSE(loop.run_once());
+
+    ASSERT_EQ(2U, executed.size());
+    ASSERT_EQ(1, executed[0]);
+    ASSERT_EQ(2, executed[1]);
+}
+
+TEST(event_loop_run_once, exceptions_from_work_items_propagated)
+{
+    event_loop loop;
+    loop.post([]() { throw std::runtime_error("error"); });
+
+    try
+    {
+        loop.run_once();
+        ASSERT_TRUE(false); // exception expected but not thrown
+    }
+    catch (const std::runtime_error& e)
+    {
+        ASSERT_STREQ("error", e.what());
+    }
+}
+
+TEST(event_loop_run, executes_work_posted_from_other_threads_on_loop_thread_until_stopped)
+{
+    event_loop loop;
+    auto loop_thread_id = std::this_thread::get_id();
+    std::vector<std::thread::id> thread_ids;
+
+    std::thread producer([&loop, &thread_ids]()
+    {
+        for (auto i = 0; i < 10; i++)
+        {
+            loop.post([&thread_ids]() { thread_ids.push_back(std::this_thread::get_id()); });
+        }
+
+        loop.post([&loop]() { loop.stop(); });
+    });
+
+    loop.run();
+    producer.join();
+
+    ASSERT_EQ(10U, thread_ids.size());
+    for (const auto& id : thread_ids)
+    {
+        ASSERT_EQ(loop_thread_id, id);
+    }
+}
+
+TEST(event_loop_run, can_run_loop_again_after_it_was_stopped)
+{
+    event_loop loop;
+    auto executed = 0;
+
+    loop.post([&loop]() { loop.stop(); });
+    loop.run();
+
+    loop.post([&executed, &loop]() { executed++; loop.stop(); });
+    loop.run();
+
+    ASSERT_EQ(1, executed);
+}
+
+TEST(event_loop_run, spinning_loop_executes_work_items_and_blocks_after_spin_duration)
+{
+    event_loop loop;
+    std::vector<int> executed;
+
+    std::thread producer([&loop, &executed]()
+    {
+        // the first item is picked up while spinning, the second one after the loop stopped spinning and blocked
+        loop.post([&executed]() { executed.push_back(1); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        loop.post([&executed, &loop]() { executed.push_back(2); loop.stop(); });
+    });
+
+    loop.run(std::chrono::microseconds(100));
+    producer.join();
+
+    ASSERT_EQ(std::vector<int>({ 1, 2 }), executed);
+    ASSERT_EQ(2U, loop.get_statistics().executed_work_items);
+    ASSERT_EQ(0U, loop.get_statistics().pending_work_items);
+}
+
+TEST(event_loop_run, stop_ends_spinning_loop)
+{
+    event_loop loop;
+
+    std::thread stopper([&loop]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        loop.stop();
+    });
+
+    // would spin for an hour if stop did not interrupt spinning
+    loop.run(std::chrono::hours(1));
+    stopper.join();
+}
@@ -0,0 +1,45 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/http_client_cache.h"
+
+using namespace signalr;
+
+TEST(http_client_cache, same_client_returned_for_the_same_host)
+{
+    http_client_cache cache;
+    web::http::client::http_client_config config;
+
+    auto client1 = cache.get_client(web::uri(_XPLATSTR("https://server/signalr/negotiate?a=b")), config);
+    auto client2 = cache.get_client(web::uri(_XPLATSTR("https://server/signalr/start")), config);
+
+    ASSERT_EQ(client1, client2);
+    ASSERT_EQ(_XPLATSTR("server"), client1->base_uri().host());
+    ASSERT_EQ(_XPLATSTR("/"), client1->base_uri().path());
+
+    auto statistics = cache.get_statistics();
+    ASSERT_EQ(2U, statistics.requests);
+    ASSERT_EQ(1U, statistics.hits);
+    ASSERT_EQ(1U, statistics.hosts);
+}
+
+TEST(http_client_cache, different_clients_returned_for_different_hosts_schemes_and_ports)
+{
+    http_client_cache cache;
+    web::http::client::http_client_config config;
+
+    auto client1 = cache.get_client(web::uri(_XPLATSTR("https://server1/signalr")), config);
+    auto client2 = cache.get_client(web::uri(_XPLATSTR("https://server2/signalr")), config);
+    auto client3 = cache.get_client(web::uri(_XPLATSTR("http://server1/signalr")), config);
+    auto client4 = cache.get_client(web::uri(_XPLATSTR("https://server1:8443/signalr")), config);
+
+    ASSERT_NE(client1, client2);
+    ASSERT_NE(client1, client3);
+    ASSERT_NE(client1, client4);
+
+    auto statistics = cache.get_statistics();
+    ASSERT_EQ(4U, statistics.requests);
+    ASSERT_EQ(0U, statistics.hits);
+    ASSERT_EQ(4U, statistics.hosts);
+}
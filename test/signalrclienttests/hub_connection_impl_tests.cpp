@@ -481,6 +481,90 @@ TEST(invoke, callback_not_called_if_send_throws)
     hub_connection->stop().get();
 }
 
+TEST(invoke, invoke_with_callback_completes_with_value_returned_from_the_server)
+{
+    auto callback_registered_event = std::make_shared<event>();
+
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number, callback_registered_event]()
+        mutable {
+        std::string responses[]
+        {
+            "{\"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{\"I\":\"0\", \"R\":\"abc\"}",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 2);
+
+        if (call_number > 0)
+        {
+            callback_registered_event->wait();
+        }
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    hub_connection->start().get();
+
+    pplx::task_completion_event<json::value> tce;
+    auto completed_count = std::make_shared<std::atomic<int>>(0);
+    hub_connection->invoke(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array(),
+        [tce, completed_count](const json::value& result, const std::exception_ptr e)
+        {
+            (*completed_count)++;
+            if (e)
+            {
+                tce.set_exception(e);
+            }
+            else
+            {
+                tce.set(result);
+            }
+        });
+    callback_registered_event->set();
+
+    ASSERT_EQ(_XPLATSTR("\"abc\""), pplx::create_task(tce).get().serialize());
+
+    hub_connection->stop().get();
+    ASSERT_EQ(1, completed_count->load());
+}
+
+TEST(invoke, invoke_with_callback_completes_once_with_exception_if_send_throws)
+{
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); },
+        /* send function */[](const utility::string_t&) { return pplx::task_from_exception<void>(std::runtime_error("error")); });
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    hub_connection->start().get();
+
+    pplx::task_completion_event<void> tce;
+    auto completed_count = std::make_shared<std::atomic<int>>(0);
+    hub_connection->invoke(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array(),
+        [tce, completed_count](const json::value&, const std::exception_ptr e)
+        {
+            (*completed_count)++;
+            tce.set_exception(e);
+        });
+
+    try
+    {
+        pplx::create_task(tce).get();
+        ASSERT_TRUE(false); // exception expected but not thrown
+    }
+    catch (const std::runtime_error& e)
+    {
+        ASSERT_STREQ("error", e.what());
+    }
+
+    // stop completes all outstanding callbacks - the callback must not be completed again
+    hub_connection->stop().get();
+    ASSERT_EQ(1, completed_count->load());
+}
+
 TEST(hub_invocation, hub_connection_logs_if_no_hub_for_invocation)
 {
     int call_number = -1;
@@ -1267,3 +1351,424 @@ TEST(connection_token, can_get_connection_token)
     ASSERT_EQ(_XPLATSTR("A=="), connection_token);
     ASSERT_EQ(_XPLATSTR("A=="), hub_connection->get_connection_token());
 }
+
+TEST(statistics, pending_invocations_counted)
+{
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); });
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    hub_connection->start().get();
+
+    auto t = hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array());
+
+    auto statistics = hub_connection->get_statistics();
+    ASSERT_EQ(1U, statistics.pending_invocations);
+    ASSERT_EQ(1U, statistics.messages_sent);
+
+    hub_connection->stop().get();
+
+    try
+    {
+        t.get();
+    }
+    catch (const signalr_exception&)
+    {
+    }
+
+    ASSERT_EQ(0U, hub_connection->get_statistics().pending_invocations);
+}
+
+
+TEST(invocation_latency, latencies_recorded_per_hub_method)
+{
+    auto callback_registered_event = std::make_shared<event>();
+
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number, callback_registered_event]()
+        mutable {
+        std::string responses[]
+        {
+            "{\"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{\"I\":\"0\"}",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 2);
+
+        if (call_number > 0)
+        {
+            callback_registered_event->wait();
+        }
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    signalr_client_config config;
+    config.set_record_invocation_latencies(true);
+    hub_connection->set_client_config(config);
+    hub_connection->start()
+        .then([hub_connection, callback_registered_event]()
+    {
+        auto t = hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array());
+        callback_registered_event->set();
+        return t;
+    }).get();
+
+    auto latencies = hub_connection->get_invocation_latencies(/*reset*/ true);
+    ASSERT_EQ(1U, latencies.size());
+    ASSERT_EQ(_XPLATSTR("my_hub"), latencies[0].hub_name);
+    ASSERT_EQ(_XPLATSTR("method"), latencies[0].method_name);
+    ASSERT_EQ(1U, latencies[0].round_trip.get_count());
+    ASSERT_EQ(1U, latencies[0].response_dispatch.get_count());
+    ASSERT_LE(latencies[0].response_dispatch.get_max(), latencies[0].round_trip.get_max());
+
+    latencies = hub_connection->get_invocation_latencies(/*reset*/ false);
+    ASSERT_EQ(1U, latencies.size());
+    ASSERT_EQ(0U, latencies[0].round_trip.get_count());
+}
+
+TEST(invocation_latency, latencies_not_recorded_by_default)
+{
+    auto hub_connection = create_hub_connection();
+
+    try
+    {
+        hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array()).get();
+        ASSERT_TRUE(false); // exception expected but not thrown
+    }
+    catch (const signalr_exception&)
+    { }
+
+    ASSERT_TRUE(hub_connection->get_invocation_latencies(/*reset*/ false).empty());
+}
+
+TEST(invocation_latency, one_set_of_recorders_per_hub_and_method)
+{
+    auto hub_connection = create_hub_connection();
+    signalr_client_config config;
+    config.set_record_invocation_latencies(true);
+    hub_connection->set_client_config(config);
+
+    // sending fails because the connection is not started but the recorders are resolved anyway
+    const utility::string_t invocations[][2]
+    {
+        { _XPLATSTR("my_hub"), _XPLATSTR("method") },
+        { _XPLATSTR("my_hub"), _XPLATSTR("other_method") },
+        { _XPLATSTR("my_hub"), _XPLATSTR("method") },
+        { _XPLATSTR("other_hub"), _XPLATSTR("method") }
+    };
+
+    for (const auto& invocation : invocations)
+    {
+        try
+        {
+            hub_connection->invoke_void(invocation[0], invocation[1], json::value::array()).get();
+            ASSERT_TRUE(false); // exception expected but not thrown
+        }
+        catch (const signalr_exception&)
+        { }
+    }
+
+    auto latencies = hub_connection->get_invocation_latencies(/*reset*/ false);
+    ASSERT_EQ(3U, latencies.size());
+    for (const auto& latency : latencies)
+    {
+        ASSERT_EQ(0U, latency.send.get_count());
+    }
+}
+
+TEST(invocation_latency, progress_updates_not_recorded_as_completions)
+{
+    auto callback_registered_event = std::make_shared<event>();
+
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number, callback_registered_event]()
+        mutable {
+        std::string responses[]
+        {
+            "{\"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{\"C\":\"d-5E80A020-A,1|B,0|C,15|D,0\", \"M\":[{\"I\":\"P|1\", \"P\":{\"I\":\"0\", \"D\":1}}] }",
+            "{\"C\":\"d-5E80A020-A,1|B,0|C,15|D,0\", \"M\":[{\"I\":\"P|1\", \"P\":{\"I\":\"0\", \"D\":2}}] }",
+            "{\"I\":\"0\"}",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 4);
+
+        if (call_number > 0)
+        {
+            callback_registered_event->wait();
+        }
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto progress_called_count = std::make_shared<std::atomic<int>>(0);
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    signalr_client_config config;
+    config.set_record_invocation_latencies(true);
+    hub_connection->set_client_config(config);
+    hub_connection->start()
+        .then([hub_connection, callback_registered_event, progress_called_count]()
+    {
+        auto t = hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array(),
+            [progress_called_count](const json::value&) { (*progress_called_count)++; });
+        callback_registered_event->set();
+        return t;
+    }).get();
+
+    ASSERT_EQ(2, progress_called_count->load());
+
+    auto latencies = hub_connection->get_invocation_latencies(/*reset*/ false);
+    ASSERT_EQ(1U, latencies.size());
+    ASSERT_EQ(1U, latencies[0].round_trip.get_count());
+    ASSERT_EQ(1U, latencies[0].response_dispatch.get_count());
+}
+
+TEST(invocation_latency, invocations_cancelled_by_stop_not_recorded)
+{
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []() { return pplx::task_from_result(std::string("{ \"C\":\"x\", \"S\":1, \"M\":[] }")); });
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    signalr_client_config config;
+    config.set_record_invocation_latencies(true);
+    hub_connection->set_client_config(config);
+    hub_connection->start().get();
+
+    auto t = hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array());
+    hub_connection->stop().get();
+
+    try
+    {
+        t.get();
+    }
+    catch (const signalr_exception&)
+    {
+    }
+
+    auto latencies = hub_connection->get_invocation_latencies(/*reset*/ false);
+    ASSERT_EQ(1U, latencies.size());
+    ASSERT_EQ(0U, latencies[0].round_trip.get_count());
+}
+
+namespace
+{
+    class recording_invocation_tracer : public invocation_tracer
+    {
+    public:
+        recording_invocation_tracer()
+            : completed_event(std::make_shared<event>()), m_next_handle(0)
+        { }
+
+        std::shared_ptr<void> __cdecl invocation_started(const utility::string_t& hub_name, const utility::string_t& method_name) override
+        {
+            return record(_XPLATSTR("started ") + hub_name + _XPLATSTR(".") + method_name, nullptr);
+        }
+
+        void __cdecl invocation_sent(const std::shared_ptr<void>& handle, const std::exception_ptr& error) override
+        {
+            record(error ? _XPLATSTR("send failed") : _XPLATSTR("sent"), handle);
+        }
+
+        void __cdecl result_received(const std::shared_ptr<void>& handle) override
+        {
+            record(_XPLATSTR("result received"), handle);
+        }
+
+        void __cdecl invocation_completed(const std::shared_ptr<void>& handle) override
+        {
+            record(_XPLATSTR("completed"), handle);
+            completed_event->set();
+        }
+
+        std::shared_ptr<void> __cdecl event_received(const utility::string_t& hub_name, const utility::string_t& event_name) override
+        {
+            return record(_XPLATSTR("event received ") + hub_name + _XPLATSTR(".") + event_name, nullptr);
+        }
+
+        void __cdecl event_handled(const std::shared_ptr<void>& handle) override
+        {
+            record(_XPLATSTR("event handled"), handle);
+            completed_event->set();
+        }
+
+        std::vector<utility::string_t> get_entries()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_entries;
+        }
+
+        // sending can complete after the invocation has completed
+        std::vector<utility::string_t> wait_for_entries(size_t count)
+        {
+            for (auto i = 0; i < 500 && get_entries().size() < count; i++)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+
+            return get_entries();
+        }
+
+        std::shared_ptr<event> completed_event;
+
+    private:
+        std::mutex m_lock;
+        std::vector<utility::string_t> m_entries;
+        int m_next_handle;
+
+        // the entries of later points carry the handle returned when the invocation (or event) started
+        std::shared_ptr<void> record(const utility::string_t& entry, const std::shared_ptr<void>& handle)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+
+            auto new_handle = handle ? handle : std::make_shared<int>(m_next_handle++);
+            m_entries.push_back(entry + _XPLATSTR(" ") +
+                utility::conversions::to_string_t(std::to_string(*std::static_pointer_cast<int>(new_handle))));
+            return new_handle;
+        }
+    };
+}
+
+TEST(invocation_tracer, invocation_traced_from_start_to_completion)
+{
+    auto callback_registered_event = std::make_shared<event>();
+
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number, callback_registered_event]()
+        mutable {
+        std::string responses[]
+        {
+            "{\"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{\"I\":\"0\"}",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 2);
+
+        if (call_number > 0)
+        {
+            callback_registered_event->wait();
+        }
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto tracer = std::make_shared<recording_invocation_tracer>();
+    signalr_client_config config;
+    config.set_invocation_tracer(tracer);
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    hub_connection->set_client_config(config);
+    hub_connection->start()
+        .then([hub_connection, callback_registered_event]()
+    {
+        auto t = hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array());
+        callback_registered_event->set();
+        return t;
+    }).get();
+
+    ASSERT_FALSE(tracer->completed_event->wait(5000));
+
+    auto entries = tracer->wait_for_entries(4);
+    ASSERT_EQ(4U, entries.size());
+    ASSERT_EQ(_XPLATSTR("started my_hub.method 0"), entries[0]);
+    // sending may complete after the result has been received
+    ASSERT_NE(entries.end(), std::find(entries.begin(), entries.end(), _XPLATSTR("sent 0")));
+    ASSERT_LT(std::find(entries.begin(), entries.end(), _XPLATSTR("result received 0")),
+        std::find(entries.begin(), entries.end(), _XPLATSTR("completed 0")));
+}
+
+TEST(invocation_tracer, progress_updates_do_not_complete_invocation)
+{
+    auto callback_registered_event = std::make_shared<event>();
+
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number, callback_registered_event]()
+        mutable {
+        std::string responses[]
+        {
+            "{\"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{\"C\":\"d-5E80A020-A,1|B,0|C,15|D,0\", \"M\":[{\"I\":\"P|1\", \"P\":{\"I\":\"0\", \"D\":1}}] }",
+            "{\"C\":\"d-5E80A020-A,1|B,0|C,15|D,0\", \"M\":[{\"I\":\"P|1\", \"P\":{\"I\":\"0\", \"D\":2}}] }",
+            "{\"I\":\"0\"}",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 4);
+
+        if (call_number > 0)
+        {
+            callback_registered_event->wait();
+        }
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto tracer = std::make_shared<recording_invocation_tracer>();
+    signalr_client_config config;
+    config.set_invocation_tracer(tracer);
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    hub_connection->set_client_config(config);
+    hub_connection->start()
+        .then([hub_connection, callback_registered_event]()
+    {
+        auto t = hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array(),
+            [](const json::value&) {});
+        callback_registered_event->set();
+        return t;
+    }).get();
+
+    ASSERT_FALSE(tracer->completed_event->wait(5000));
+
+    auto entries = tracer->wait_for_entries(4);
+    ASSERT_EQ(4U, entries.size());
+    ASSERT_EQ(_XPLATSTR("started my_hub.method 0"), entries[0]);
+    ASSERT_EQ(1, std::count(entries.begin(), entries.end(), _XPLATSTR("sent 0")));
+    ASSERT_EQ(1, std::count(entries.begin(), entries.end(), _XPLATSTR("result received 0")));
+    ASSERT_EQ(1, std::count(entries.begin(), entries.end(), _XPLATSTR("completed 0")));
+}
+
+TEST(invocation_tracer, hub_events_traced)
+{
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number]()
+    mutable {
+        std::string responses[]
+        {
+            "{ \"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{ \"C\":\"d- F430FB19\", \"M\" : [{\"H\":\"my_hub\", \"M\":\"broadcast\", \"A\" : [\"message\", 1]}] }",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 2);
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto tracer = std::make_shared<recording_invocation_tracer>();
+    signalr_client_config config;
+    config.set_invocation_tracer(tracer);
+
+    auto hub_connection = create_hub_connection(websocket_client);
+    hub_connection->set_client_config(config);
+    auto hub_proxy = hub_connection->create_hub_proxy(_XPLATSTR("my_hub"));
+    hub_proxy->on(_XPLATSTR("broadcast"), [](const json::value&) {});
+
+    hub_connection->start().get();
+    ASSERT_FALSE(tracer->completed_event->wait(5000));
+
+    auto entries = tracer->get_entries();
+    ASSERT_EQ(2U, entries.size());
+    ASSERT_EQ(_XPLATSTR("event received my_hub.broadcast 0"), entries[0]);
+    ASSERT_EQ(_XPLATSTR("event handled 0"), entries[1]);
+}
\ No newline at end of file
@@ -101,6 +101,24 @@ TEST(invoke_event, logs_if_no_handler_for_an_event)
     ASSERT_EQ(_XPLATSTR("[info        ] no handler found for event. hub name: hub, event name: message\n"), entry);
 }
 
+TEST(invoke_event, logging_limited_if_no_handler_for_many_events)
+{
+    std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
+    internal_hub_proxy hub_proxy{ std::weak_ptr<hub_connection_impl>(), _XPLATSTR("hub"),
+        logger{ writer, trace_level::info } };
+
+    for (auto i = 0; i < 1010; i++)
+    {
+        hub_proxy.invoke_event(_XPLATSTR("message"), json::value::parse(_XPLATSTR("{}")));
+    }
+
+    // the first 10 and then 1 in 1000
+    auto log_entries = std::dynamic_pointer_cast<memory_log_writer>(writer)->get_log_entries();
+    ASSERT_EQ(11U, log_entries.size());
+    auto entry = remove_date_from_log_entry(log_entries[10]);
+    ASSERT_EQ(_XPLATSTR("[info        ] no handler found for event. hub name: hub, event name: message (999 similar entries suppressed)\n"), entry);
+}
+
 TEST(invoke_json, invoke_json_throws_when_the_underlying_connection_is_not_valid)
 {
     internal_hub_proxy hub_proxy{ std::weak_ptr<hub_connection_impl>(), _XPLATSTR("hub"),
@@ -131,4 +149,31 @@ TEST(invoke_void, invoke_json_throws_when_the_underlying_connection_is_not_valid
     {
         ASSERT_STREQ("the connection for which this hub proxy was created is no longer valid - it was either destroyed or went out of scope", e.what());
     }
+}
+
+TEST(invoke, invoke_completes_with_exception_when_the_underlying_connection_is_not_valid)
+{
+    internal_hub_proxy hub_proxy{ std::weak_ptr<hub_connection_impl>(), _XPLATSTR("hub"),
+        logger{ std::make_shared<trace_log_writer>(), trace_level::none } };
+
+    auto completed_count = 0;
+    std::exception_ptr exception;
+    hub_proxy.invoke(_XPLATSTR("method"), web::json::value::array(),
+        [&completed_count, &exception](const json::value& result, const std::exception_ptr e)
+        {
+            completed_count++;
+            exception = e;
+            ASSERT_TRUE(result.is_null());
+        });
+
+    ASSERT_EQ(1, completed_count);
+
+    try
+    {
+        std::rethrow_exception(exception);
+    }
+    catch (const signalr_exception& e)
+    {
+        ASSERT_STREQ("the connection for which this hub proxy was created is no longer valid - it was either destroyed or went out of scope", e.what());
+    }
 }
\ No newline at end of file
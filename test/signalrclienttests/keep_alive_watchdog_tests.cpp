@@ -0,0 +1,115 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "test_utils.h"
+#include "trace_log_writer.h"
+#include "test_websocket_client.h"
+#include "websocket_transport.h"
+#include "keep_alive_watchdog.h"
+#include "event.h"
+
+using namespace signalr;
+
+namespace
+{
+    std::shared_ptr<transport> create_transport(const std::shared_ptr<websocket_client>& websocket_client = create_test_websocket_client())
+    {
+        return websocket_transport::create([websocket_client](){ return websocket_client; },
+            logger(std::make_shared<trace_log_writer>(), trace_level::none),
+            [](const utility::string_t&){}, [](const std::exception&){});
+    }
+}
+
+TEST(keep_alive_watchdog, timeout_callback_invoked_if_nothing_received)
+{
+    auto watchdog = keep_alive_watchdog::create();
+    auto transport = create_transport();
+
+    auto timed_out = std::make_shared<event>();
+    auto time_since_last_activity = std::make_shared<std::chrono::milliseconds>();
+    watchdog->watch(transport, std::chrono::milliseconds(50), [timed_out, time_since_last_activity](std::chrono::milliseconds time)
+    {
+        *time_since_last_activity = time;
+        timed_out->set();
+    });
+
+    ASSERT_FALSE(timed_out->wait(5000));
+    ASSERT_GT(*time_since_last_activity, std::chrono::milliseconds(50));
+    ASSERT_EQ(0U, watchdog->get_watched_count());
+}
+
+TEST(keep_alive_watchdog, timeout_measured_from_start_of_watch_if_transport_inactive_for_longer)
+{
+    auto watchdog = keep_alive_watchdog::create();
+    auto transport = create_transport();
+
+    // e.g. a transport that was reconnected after a keep-alive timeout
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+
+    auto timed_out = std::make_shared<event>();
+    auto time_since_last_activity = std::make_shared<std::chrono::milliseconds>();
+    auto watch_started = std::chrono::steady_clock::now();
+    watchdog->watch(transport, std::chrono::milliseconds(100), [timed_out, time_since_last_activity](std::chrono::milliseconds time)
+    {
+        *time_since_last_activity = time;
+        timed_out->set();
+    });
+
+    ASSERT_FALSE(timed_out->wait(5000));
+    ASSERT_GE(std::chrono::steady_clock::now() - watch_started, std::chrono::milliseconds(100));
+    ASSERT_LT(*time_since_last_activity, std::chrono::milliseconds(150));
+}
+
+TEST(keep_alive_watchdog, timeout_callback_not_invoked_if_messages_received)
+{
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ []()
+        {
+            return pplx::create_task([]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                return std::string("{}");
+            });
+        });
+
+    auto watchdog = keep_alive_watchdog::create();
+    auto transport = create_transport(websocket_client);
+    transport->connect(_XPLATSTR("ws://fakeuri.org/connect")).get();
+
+    auto timed_out = std::make_shared<event>();
+    watchdog->watch(transport, std::chrono::milliseconds(200), [timed_out](std::chrono::milliseconds) { timed_out->set(); });
+
+    ASSERT_TRUE(timed_out->wait(600) != 0);
+    ASSERT_EQ(1U, watchdog->get_watched_count());
+
+    transport->disconnect().get();
+}
+
+TEST(keep_alive_watchdog, timeout_callback_not_invoked_after_unwatch)
+{
+    auto watchdog = keep_alive_watchdog::create();
+    auto transport = create_transport();
+
+    auto timed_out = std::make_shared<event>();
+    auto watch_id = watchdog->watch(transport, std::chrono::milliseconds(50), [timed_out](std::chrono::milliseconds) { timed_out->set(); });
+    watchdog->unwatch(watch_id);
+
+    ASSERT_EQ(0U, watchdog->get_watched_count());
+    ASSERT_TRUE(timed_out->wait(200) != 0);
+}
+
+TEST(keep_alive_watchdog, destroyed_transports_no_longer_watched)
+{
+    auto watchdog = keep_alive_watchdog::create();
+    auto transport = create_transport();
+
+    auto timed_out = std::make_shared<event>();
+    watchdog->watch(transport, std::chrono::milliseconds(50), [timed_out](std::chrono::milliseconds) { timed_out->set(); });
+    ASSERT_EQ(1U, watchdog->get_watched_count());
+
+    transport.reset();
+
+    ASSERT_TRUE(timed_out->wait(200) != 0);
+    ASSERT_EQ(0U, watchdog->get_watched_count());
+}
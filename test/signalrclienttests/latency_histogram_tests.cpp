@@ -0,0 +1,125 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <thread>
+#include <vector>
+#include "signalrclient/latency_histogram.h"
+#include "latency_recorder.h"
+
+using namespace signalr;
+
+TEST(latency_histogram, empty_histogram_returns_zeros)
+{
+    latency_histogram histogram;
+
+    ASSERT_EQ(0U, histogram.get_count());
+    ASSERT_EQ(std::chrono::microseconds(0), histogram.get_min());
+    ASSERT_EQ(std::chrono::microseconds(0), histogram.get_max());
+    ASSERT_EQ(std::chrono::microseconds(0), histogram.get_mean());
+    ASSERT_EQ(std::chrono::microseconds(0), histogram.get_value_at_percentile(99));
+}
+
+TEST(latency_histogram, small_values_counted_exactly)
+{
+    latency_histogram histogram;
+    for (auto i = 1; i <= 50; i++)
+    {
+        histogram.record(std::chrono::microseconds(i));
+    }
+
+    ASSERT_EQ(50U, histogram.get_count());
+    ASSERT_EQ(std::chrono::microseconds(1), histogram.get_min());
+    ASSERT_EQ(std::chrono::microseconds(50), histogram.get_max());
+    ASSERT_EQ(std::chrono::microseconds(25), histogram.get_mean());
+    ASSERT_EQ(std::chrono::microseconds(25), histogram.get_value_at_percentile(50));
+    ASSERT_EQ(std::chrono::microseconds(45), histogram.get_value_at_percentile(90));
+    ASSERT_EQ(std::chrono::microseconds(50), histogram.get_value_at_percentile(100));
+}
+
+TEST(latency_histogram, percentiles_within_precision_for_large_values)
+{
+    latency_histogram histogram;
+    for (auto i = 1; i <= 1000; i++)
+    {
+        histogram.record(std::chrono::milliseconds(i));
+    }
+
+    auto median = histogram.get_value_at_percentile(50).count();
+    ASSERT_GE(median, 500000);
+    ASSERT_LE(median, 500000 * 1.04);
+
+    auto p99 = histogram.get_value_at_percentile(99).count();
+    ASSERT_GE(p99, 990000);
+    ASSERT_LE(p99, 990000 * 1.04);
+
+    ASSERT_EQ(std::chrono::microseconds(1000000), histogram.get_value_at_percentile(100));
+}
+
+TEST(latency_histogram, huge_values_counted_in_last_bucket)
+{
+    latency_histogram histogram;
+    histogram.record(std::chrono::hours(24 * 365));
+
+    ASSERT_EQ(1U, histogram.get_count());
+    ASSERT_EQ(std::chrono::hours(24 * 365), histogram.get_value_at_percentile(50));
+}
+
+TEST(latency_histogram, merge_adds_values)
+{
+    latency_histogram first;
+    first.record(std::chrono::microseconds(10));
+    latency_histogram second;
+    second.record(std::chrono::microseconds(30));
+
+    first.merge(second);
+
+    ASSERT_EQ(2U, first.get_count());
+    ASSERT_EQ(std::chrono::microseconds(10), first.get_min());
+    ASSERT_EQ(std::chrono::microseconds(30), first.get_max());
+    ASSERT_EQ(std::chrono::microseconds(20), first.get_mean());
+}
+
+TEST(latency_recorder, values_recorded_concurrently_not_lost)
+{
+    latency_recorder recorder;
+
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; i++)
+    {
+        threads.push_back(std::thread([&recorder, i]()
+        {
+            for (auto j = 0; j < 10000; j++)
+            {
+                recorder.record(std::chrono::microseconds(i * 1000 + j % 100));
+            }
+        }));
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto histogram = recorder.get_snapshot(/*reset*/ false);
+    ASSERT_EQ(40000U, histogram.get_count());
+    ASSERT_EQ(std::chrono::microseconds(0), histogram.get_min());
+    ASSERT_EQ(std::chrono::microseconds(3099), histogram.get_max());
+}
+
+TEST(latency_recorder, reset_starts_from_scratch)
+{
+    latency_recorder recorder;
+    recorder.record(std::chrono::microseconds(100));
+
+    ASSERT_EQ(1U, recorder.get_snapshot(/*reset*/ true).get_count());
+
+    auto histogram = recorder.get_snapshot(/*reset*/ false);
+    ASSERT_EQ(0U, histogram.get_count());
+
+    recorder.record(std::chrono::microseconds(5));
+    histogram = recorder.get_snapshot(/*reset*/ false);
+    ASSERT_EQ(1U, histogram.get_count());
+    ASSERT_EQ(std::chrono::microseconds(5), histogram.get_min());
+    ASSERT_EQ(std::chrono::microseconds(5), histogram.get_max());
+}
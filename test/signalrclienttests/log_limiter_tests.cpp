@@ -0,0 +1,65 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include <thread>
+#include "log_limiter.h"
+
+using namespace signalr;
+
+TEST(log_limiter_try_acquire, entries_up_to_limit_acquired_then_sampled)
+{
+    log_limiter limiter(3, std::chrono::hours(1), 10);
+
+    auto acquired = 0;
+    uint64_t total_suppressed = 0;
+    for (auto i = 0; i < 33; i++)
+    {
+        uint64_t suppressed;
+        if (limiter.try_acquire(suppressed))
+        {
+            acquired++;
+            total_suppressed += suppressed;
+        }
+    }
+
+    // 3 within the limit and every 10th of the remaining 30
+    ASSERT_EQ(6, acquired);
+    ASSERT_EQ(27U, total_suppressed);
+}
+
+TEST(log_limiter_try_acquire, no_entries_acquired_over_limit_if_sampling_disabled)
+{
+    log_limiter limiter(2, std::chrono::hours(1), 0);
+
+    uint64_t suppressed;
+    ASSERT_TRUE(limiter.try_acquire(suppressed));
+    ASSERT_EQ(0U, suppressed);
+    ASSERT_TRUE(limiter.try_acquire(suppressed));
+
+    for (auto i = 0; i < 100; i++)
+    {
+        ASSERT_FALSE(limiter.try_acquire(suppressed));
+    }
+}
+
+TEST(log_limiter_try_acquire, limit_reset_after_interval_and_suppressed_count_reported)
+{
+    log_limiter limiter(1, std::chrono::milliseconds(50), 0);
+
+    uint64_t suppressed;
+    ASSERT_TRUE(limiter.try_acquire(suppressed));
+    ASSERT_FALSE(limiter.try_acquire(suppressed));
+    ASSERT_FALSE(limiter.try_acquire(suppressed));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+    ASSERT_TRUE(limiter.try_acquire(suppressed));
+    ASSERT_EQ(2U, suppressed);
+}
+
+TEST(log_limiter_append_suppressed, count_appended_only_if_entries_suppressed)
+{
+    ASSERT_EQ(_XPLATSTR("entry"), log_limiter::append_suppressed(_XPLATSTR("entry"), 0));
+    ASSERT_EQ(_XPLATSTR("entry (42 similar entries suppressed)"), log_limiter::append_suppressed(_XPLATSTR("entry"), 42));
+}
@@ -33,6 +33,25 @@ TEST(logger_write, entry_not_added_if_trace_level_not_set)
     ASSERT_TRUE(log_entries.empty());
 }
 
+TEST(logger_is_enabled, enabled_only_for_levels_in_trace_level)
+{
+    logger l(std::make_shared<memory_log_writer>(), trace_level::messages | trace_level::errors);
+
+    ASSERT_TRUE(l.is_enabled(trace_level::messages));
+    ASSERT_TRUE(l.is_enabled(trace_level::errors));
+    ASSERT_FALSE(l.is_enabled(trace_level::events));
+    ASSERT_FALSE(l.is_enabled(trace_level::state_changes));
+    ASSERT_FALSE(l.is_enabled(trace_level::info));
+}
+
+TEST(logger_is_enabled, not_enabled_if_trace_level_none)
+{
+    logger l(std::make_shared<memory_log_writer>(), trace_level::none);
+
+    ASSERT_FALSE(l.is_enabled(trace_level::messages));
+    ASSERT_FALSE(l.is_enabled(trace_level::errors));
+}
+
 TEST(logger_write, entries_added_for_combined_trace_level)
 {
     std::shared_ptr<log_writer> writer(std::make_shared<memory_log_writer>());
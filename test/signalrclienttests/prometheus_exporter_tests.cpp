@@ -0,0 +1,171 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/prometheus_exporter.h"
+
+using namespace signalr;
+
+namespace
+{
+    class test_metrics_source : public metrics_source
+    {
+    public:
+        explicit test_metrics_source(const connection_metrics& metrics)
+            : m_metrics(metrics), m_alive(true)
+        { }
+
+        bool __cdecl collect(connection_metrics& metrics) const override
+        {
+            if (m_alive)
+            {
+                metrics = m_metrics;
+            }
+
+            return m_alive;
+        }
+
+        connection_metrics m_metrics;
+        bool m_alive;
+    };
+
+    connection_metrics create_metrics(const utility::string_t& url, const utility::string_t& connection_id)
+    {
+        connection_metrics metrics;
+        metrics.url = url;
+        metrics.connection_id = connection_id;
+        metrics.state = connection_state::connected;
+        metrics.statistics = connection_statistics();
+        metrics.reconnects = reconnect_statistics();
+        return metrics;
+    }
+}
+
+TEST(prometheus_exporter, render_returns_only_headers_if_no_sources)
+{
+    prometheus_exporter exporter;
+
+    auto metrics = exporter.render();
+
+    ASSERT_NE(std::string::npos, metrics.find("# HELP signalr_frames_received_total "));
+    ASSERT_NE(std::string::npos, metrics.find("# TYPE signalr_frames_received_total counter\n"));
+    ASSERT_EQ(std::string::npos, metrics.find("signalr_frames_received_total{"));
+}
+
+TEST(prometheus_exporter, render_writes_counters_and_gauges_of_all_sources)
+{
+    auto first_metrics = create_metrics(_XPLATSTR("http://fakeuri/"), _XPLATSTR("1"));
+    first_metrics.statistics.frames_received = 42;
+    first_metrics.statistics.pending_invocations = 3;
+    first_metrics.statistics.outbox_bytes_in_use = 128;
+    first_metrics.statistics.time_connected = std::chrono::milliseconds(1500);
+    auto second_metrics = create_metrics(_XPLATSTR("http://fakeuri/"), _XPLATSTR("2"));
+    second_metrics.state = connection_state::reconnecting;
+    second_metrics.reconnects.keep_alive_timeouts = 2;
+
+    prometheus_exporter exporter;
+    exporter.add_source(std::make_shared<test_metrics_source>(first_metrics));
+    exporter.add_source(std::make_shared<test_metrics_source>(second_metrics));
+
+    auto metrics = exporter.render();
+
+    ASSERT_NE(std::string::npos, metrics.find(
+        "signalr_frames_received_total{source=\"1\",url=\"http://fakeuri/\"} 42\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find(
+        "signalr_pending_invocations{source=\"1\",url=\"http://fakeuri/\"} 3\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find(
+        "signalr_connection_state_seconds_total{source=\"1\",url=\"http://fakeuri/\",state=\"connected\"} 1.5\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find(
+        "signalr_allocated_bytes_in_use{source=\"1\",url=\"http://fakeuri/\",purpose=\"outbox\"} 128\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find(
+        "signalr_connection_up{source=\"1\",url=\"http://fakeuri/\"} 1\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find(
+        "signalr_connection_up{source=\"2\",url=\"http://fakeuri/\"} 0\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find(
+        "signalr_keep_alive_timeouts_total{source=\"2\",url=\"http://fakeuri/\"} 2\n")) << metrics;
+}
+
+TEST(prometheus_exporter, render_writes_invocation_latency_summaries)
+{
+    auto connection_metrics = create_metrics(_XPLATSTR("http://fakeuri/"), _XPLATSTR("1"));
+    invocation_latency latency;
+    latency.hub_name = _XPLATSTR("hub");
+    latency.method_name = _XPLATSTR("method");
+    latency.round_trip.record(std::chrono::microseconds(20));
+    latency.round_trip.record(std::chrono::microseconds(30));
+    connection_metrics.invocation_latencies.push_back(latency);
+
+    prometheus_exporter exporter;
+    exporter.add_source(std::make_shared<test_metrics_source>(connection_metrics));
+
+    auto metrics = exporter.render();
+
+    ASSERT_NE(std::string::npos, metrics.find("# TYPE signalr_invocation_round_trip_seconds summary\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("signalr_invocation_round_trip_seconds{source=\"1\",url=\"http://fakeuri/\","
+        "hub=\"hub\",method=\"method\",quantile=\"0.99\"} 3e-05\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("signalr_invocation_round_trip_seconds_sum{source=\"1\",url=\"http://fakeuri/\","
+        "hub=\"hub\",method=\"method\"} 5e-05\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("signalr_invocation_round_trip_seconds_count{source=\"1\",url=\"http://fakeuri/\","
+        "hub=\"hub\",method=\"method\"} 2\n")) << metrics;
+}
+
+TEST(prometheus_exporter, render_escapes_label_values)
+{
+    prometheus_exporter exporter;
+    exporter.add_source(std::make_shared<test_metrics_source>(create_metrics(_XPLATSTR("http://fakeuri/\"a\\b\nc"), _XPLATSTR("1"))));
+
+    auto metrics = exporter.render();
+
+    ASSERT_NE(std::string::npos, metrics.find("signalr_connection_up{source=\"1\",url=\"http://fakeuri/\\\"a\\\\b\\nc\"} 1\n")) << metrics;
+}
+
+TEST(prometheus_exporter, render_skips_removed_and_dead_sources)
+{
+    auto removed_source = std::make_shared<test_metrics_source>(create_metrics(_XPLATSTR("http://removed/"), _XPLATSTR("1")));
+    auto dead_source = std::make_shared<test_metrics_source>(create_metrics(_XPLATSTR("http://dead/"), _XPLATSTR("2")));
+    dead_source->m_alive = false;
+    auto source = std::make_shared<test_metrics_source>(create_metrics(_XPLATSTR("http://alive/"), _XPLATSTR("3")));
+
+    prometheus_exporter exporter;
+    exporter.add_source(removed_source);
+    exporter.add_source(dead_source);
+    exporter.add_source(source);
+    exporter.add_source(source);
+    exporter.remove_source(removed_source);
+
+    auto metrics = exporter.render();
+
+    ASSERT_EQ(std::string::npos, metrics.find("removed")) << metrics;
+    ASSERT_EQ(std::string::npos, metrics.find("dead")) << metrics;
+    auto position = metrics.find("signalr_connection_up{source=\"3\",url=\"http://alive/\"}");
+    ASSERT_NE(std::string::npos, position) << metrics;
+    // added once even though it was added twice
+    ASSERT_EQ(std::string::npos, metrics.find("signalr_connection_up{source=", position + 1));
+}
+
+TEST(prometheus_exporter, render_labels_sources_with_the_same_url_by_source_id_not_connection_id)
+{
+    auto first_metrics = create_metrics(_XPLATSTR("http://fakeuri/"), _XPLATSTR(""));
+    first_metrics.state = connection_state::disconnected;
+    auto second_metrics = create_metrics(_XPLATSTR("http://fakeuri/"), _XPLATSTR(""));
+    second_metrics.state = connection_state::connecting;
+    auto first_source = std::make_shared<test_metrics_source>(first_metrics);
+
+    prometheus_exporter exporter;
+    exporter.add_source(first_source);
+    exporter.add_source(std::make_shared<test_metrics_source>(second_metrics));
+
+    auto metrics = exporter.render();
+
+    ASSERT_EQ(std::string::npos, metrics.find("connection_id")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("signalr_connection_up{source=\"1\",url=\"http://fakeuri/\"} 0\n")) << metrics;
+    ASSERT_NE(std::string::npos, metrics.find("signalr_connection_up{source=\"2\",url=\"http://fakeuri/\"} 0\n")) << metrics;
+
+    // the label does not change when the connection is restarted
+    first_source->m_metrics.connection_id = _XPLATSTR("f7707523");
+    first_source->m_metrics.state = connection_state::connected;
+
+    metrics = exporter.render();
+
+    ASSERT_NE(std::string::npos, metrics.find("signalr_connection_up{source=\"1\",url=\"http://fakeuri/\"} 1\n")) << metrics;
+}
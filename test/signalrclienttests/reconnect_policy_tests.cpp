@@ -0,0 +1,121 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/reconnect_policy.h"
+
+using namespace signalr;
+
+namespace
+{
+    reconnect_context create_context(unsigned int failed_attempts, std::chrono::milliseconds previous_delay = std::chrono::milliseconds::zero())
+    {
+        reconnect_context context;
+        context.failed_attempts = failed_attempts;
+        context.elapsed_time = std::chrono::milliseconds::zero();
+        context.previous_delay = previous_delay;
+        return context;
+    }
+}
+
+TEST(fixed_delay_reconnect_policy, always_returns_configured_delay)
+{
+    fixed_delay_reconnect_policy policy(std::chrono::milliseconds(100));
+
+    for (auto attempt = 1U; attempt < 100; ++attempt)
+    {
+        std::chrono::milliseconds delay;
+        ASSERT_TRUE(policy.next_delay(create_context(attempt), delay));
+        ASSERT_EQ(std::chrono::milliseconds(100), delay);
+    }
+}
+
+TEST(fixed_delay_reconnect_policy, first_attempt_not_delayed)
+{
+    fixed_delay_reconnect_policy policy(std::chrono::milliseconds(100));
+
+    std::chrono::milliseconds delay;
+    ASSERT_TRUE(policy.next_delay(create_context(0), delay));
+    ASSERT_EQ(std::chrono::milliseconds::zero(), delay);
+}
+
+TEST(exponential_backoff_reconnect_policy, first_attempt_delayed_by_jitter_only)
+{
+    exponential_backoff_reconnect_policy no_jitter_policy(std::chrono::milliseconds(100), std::chrono::milliseconds(1000), reconnect_jitter::none);
+
+    std::chrono::milliseconds delay;
+    ASSERT_TRUE(no_jitter_policy.next_delay(create_context(0), delay));
+    ASSERT_EQ(std::chrono::milliseconds::zero(), delay);
+
+    reconnect_jitter jitters[] { reconnect_jitter::full, reconnect_jitter::decorrelated };
+    for (auto jitter : jitters)
+    {
+        exponential_backoff_reconnect_policy policy(std::chrono::milliseconds(100), std::chrono::milliseconds(1000), jitter);
+
+        for (auto i = 0; i < 100; ++i)
+        {
+            ASSERT_TRUE(policy.next_delay(create_context(0), delay));
+            ASSERT_GE(delay, std::chrono::milliseconds::zero());
+            ASSERT_LE(delay, std::chrono::milliseconds(100));
+        }
+    }
+}
+
+TEST(exponential_backoff_reconnect_policy, delay_doubles_until_it_reaches_max_delay)
+{
+    exponential_backoff_reconnect_policy policy(std::chrono::milliseconds(100), std::chrono::milliseconds(1000), reconnect_jitter::none);
+
+    std::chrono::milliseconds expected_delays[] { std::chrono::milliseconds(100), std::chrono::milliseconds(200),
+        std::chrono::milliseconds(400), std::chrono::milliseconds(800), std::chrono::milliseconds(1000), std::chrono::milliseconds(1000) };
+
+    for (auto attempt = 1U; attempt <= 6; ++attempt)
+    {
+        std::chrono::milliseconds delay;
+        ASSERT_TRUE(policy.next_delay(create_context(attempt), delay));
+        ASSERT_EQ(expected_delays[attempt - 1], delay);
+    }
+
+    // large attempt numbers must not overflow
+    std::chrono::milliseconds delay;
+    ASSERT_TRUE(policy.next_delay(create_context(100000), delay));
+    ASSERT_EQ(std::chrono::milliseconds(1000), delay);
+}
+
+TEST(exponential_backoff_reconnect_policy, full_jitter_delay_not_greater_than_backoff)
+{
+    exponential_backoff_reconnect_policy policy(std::chrono::milliseconds(100), std::chrono::milliseconds(1000), reconnect_jitter::full);
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        std::chrono::milliseconds delay;
+        ASSERT_TRUE(policy.next_delay(create_context(3), delay));
+        ASSERT_GE(delay, std::chrono::milliseconds::zero());
+        ASSERT_LE(delay, std::chrono::milliseconds(400));
+    }
+}
+
+TEST(exponential_backoff_reconnect_policy, decorrelated_jitter_delay_between_base_delay_and_three_times_previous_delay)
+{
+    exponential_backoff_reconnect_policy policy(std::chrono::milliseconds(100), std::chrono::milliseconds(1000), reconnect_jitter::decorrelated);
+
+    for (auto i = 0; i < 100; ++i)
+    {
+        std::chrono::milliseconds delay;
+        ASSERT_TRUE(policy.next_delay(create_context(2, std::chrono::milliseconds(200)), delay));
+        ASSERT_GE(delay, std::chrono::milliseconds(100));
+        ASSERT_LE(delay, std::chrono::milliseconds(600));
+
+        ASSERT_TRUE(policy.next_delay(create_context(5, std::chrono::milliseconds(900)), delay));
+        ASSERT_LE(delay, std::chrono::milliseconds(1000));
+    }
+}
+
+TEST(exponential_backoff_reconnect_policy, stops_reconnecting_after_max_attempts)
+{
+    exponential_backoff_reconnect_policy policy(std::chrono::milliseconds(100), std::chrono::milliseconds(1000), reconnect_jitter::none, 3);
+
+    std::chrono::milliseconds delay;
+    ASSERT_TRUE(policy.next_delay(create_context(1), delay));
+    ASSERT_TRUE(policy.next_delay(create_context(2), delay));
+    ASSERT_FALSE(policy.next_delay(create_context(3), delay));
+}
@@ -206,4 +206,40 @@ TEST(request_sender_abort, abort_propagates_exceptions)
         ASSERT_EQ(_XPLATSTR("web exception - 503 Server unavailable"), utility::conversions::to_string_t(e.what()));
         ASSERT_EQ(503, e.status_code());
     }
-}
\ No newline at end of file
+}
+
+TEST(request_sender_ping, request_sent_with_correct_url)
+{
+    utility::string_t actual_url;
+    auto request_factory = test_web_request_factory([&actual_url](const web::uri& url)
+    {
+        actual_url = url.to_string();
+        utility::string_t response_body(_XPLATSTR("{\"Response\":\"pong\" }"));
+        return std::unique_ptr<web_request>(new web_request_stub((unsigned short)200, _XPLATSTR("OK"), response_body));
+    });
+
+    request_sender::ping(request_factory, web::uri{ _XPLATSTR("http://fake/signalr") }, _XPLATSTR("q=1")).get();
+
+    ASSERT_EQ(_XPLATSTR("http://fake/signalr/ping?q=1"), actual_url);
+}
+
+TEST(request_sender_ping, ping_throws_if_response_is_not_pong_literal)
+{
+    auto request_factory = test_web_request_factory([](const web::uri&)
+    {
+        utility::string_t response_body(_XPLATSTR("{\"Response\":\"42\" }"));
+
+        return std::unique_ptr<web_request>(new web_request_stub((unsigned short)200, _XPLATSTR("OK"), response_body));
+    });
+
+    try
+    {
+        request_sender::ping(request_factory, web::uri{ _XPLATSTR("http://fake/signalr") }, _XPLATSTR("")).get();
+
+        ASSERT_TRUE(false); // exception not thrown
+    }
+    catch (const signalr_exception& e)
+    {
+        ASSERT_STREQ("ping request failed due to unexpected response from the server: {\"Response\":\"42\" }", e.what());
+    }
+}
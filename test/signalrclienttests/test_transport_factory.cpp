@@ -6,16 +6,21 @@
 #include "websocket_transport.h"
 
 test_transport_factory::test_transport_factory(const std::shared_ptr<websocket_client>& websocket_client)
-    : m_websocket_client(websocket_client)
+    : m_websocket_client_factory([websocket_client]() { return websocket_client; })
+{ }
+
+test_transport_factory::test_transport_factory(const std::function<std::shared_ptr<websocket_client>()>& websocket_client_factory)
+    : m_websocket_client_factory(websocket_client_factory)
 { }
 
 std::shared_ptr<transport> test_transport_factory::create_transport(transport_type transport_type, const logger& logger,
-    const signalr_client_config&, std::function<void(const utility::string_t&)> process_message_callback,
+    const signalr_client_config&, std::function<void(utility::string_t)> process_message_callback,
     std::function<void(const std::exception&)> error_callback)
 {
     if (transport_type == signalr::transport_type::websockets)
     {
-        return websocket_transport::create([&](){ return m_websocket_client; }, logger, process_message_callback, error_callback);
+        auto websocket_client = m_websocket_client_factory();
+        return websocket_transport::create([websocket_client](){ return websocket_client; }, logger, process_message_callback, error_callback);
     }
 
     throw std::runtime_error("not supported");
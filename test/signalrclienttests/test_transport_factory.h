@@ -13,11 +13,14 @@ class test_transport_factory : public transport_factory
 public:
     test_transport_factory(const std::shared_ptr<websocket_client>& websocket_client);
 
+    // creates a new websocket client for each transport
+    test_transport_factory(const std::function<std::shared_ptr<websocket_client>()>& websocket_client_factory);
+
     std::shared_ptr<transport> create_transport(transport_type transport_type, const logger& logger,
         const signalr_client_config& signalr_client_config,
-        std::function<void(const utility::string_t&)> process_message_callback,
+        std::function<void(utility::string_t)> process_message_callback,
         std::function<void(const std::exception&)> error_callback) override;
 
 private:
-    std::shared_ptr<websocket_client> m_websocket_client;
+    std::function<std::shared_ptr<websocket_client>()> m_websocket_client_factory;
 };
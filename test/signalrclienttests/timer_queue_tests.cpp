@@ -0,0 +1,104 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+#include "signalrclient/timer_queue.h"
+
+using namespace signalr;
+
+TEST(timer_queue_schedule, callbacks_invoked_on_timer_thread_in_due_time_order)
+{
+    timer_queue timers;
+    std::vector<int> invoked;
+    std::vector<std::thread::id> thread_ids;
+    event done;
+
+    timers.schedule(std::chrono::milliseconds(60), [&invoked, &thread_ids, &done]()
+    {
+        invoked.push_back(3);
+        thread_ids.push_back(std::this_thread::get_id());
+        done.set();
+    });
+    timers.schedule(std::chrono::milliseconds(20), [&invoked, &thread_ids]()
+    {
+        invoked.push_back(1);
+        thread_ids.push_back(std::this_thread::get_id());
+    });
+    timers.schedule(std::chrono::milliseconds(40), [&invoked, &thread_ids]()
+    {
+        invoked.push_back(2);
+        thread_ids.push_back(std::this_thread::get_id());
+    });
+
+    ASSERT_FALSE(done.wait(5000));
+    ASSERT_EQ(std::vector<int>({ 1, 2, 3 }), invoked);
+    ASSERT_NE(std::this_thread::get_id(), thread_ids[0]);
+    ASSERT_EQ(thread_ids[0], thread_ids[1]);
+    ASSERT_EQ(thread_ids[0], thread_ids[2]);
+}
+
+TEST(timer_queue_schedule, callback_not_invoked_before_delay_elapsed)
+{
+    timer_queue timers;
+    event done;
+    auto scheduled = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point invoked;
+
+    timers.schedule(std::chrono::milliseconds(50), [&invoked, &done]()
+    {
+        invoked = std::chrono::steady_clock::now();
+        done.set();
+    });
+
+    ASSERT_FALSE(done.wait(5000));
+    ASSERT_GE(invoked - scheduled, std::chrono::milliseconds(50));
+}
+
+TEST(timer_queue_schedule, exceptions_from_callbacks_do_not_stop_the_timer_thread)
+{
+    timer_queue timers;
+    event done;
+
+    timers.schedule(std::chrono::milliseconds(0), []() { throw std::runtime_error("error"); });
+    timers.schedule(std::chrono::milliseconds(10), [&done]() { done.set(); });
+
+    ASSERT_FALSE(done.wait(5000));
+}
+
+TEST(timer_queue_dtor, pending_callbacks_dropped)
+{
+    auto invoked = std::make_shared<std::atomic<bool>>(false);
+
+    {
+        timer_queue timers;
+        timers.schedule(std::chrono::hours(1), [invoked]() { *invoked = true; });
+        ASSERT_EQ(1U, timers.get_pending_timer_count());
+    }
+
+    ASSERT_FALSE(invoked->load());
+}
+
+TEST(timer_queue_dtor, pending_callbacks_cancelled)
+{
+    auto invoked = std::make_shared<std::atomic<bool>>(false);
+    auto cancelled = std::make_shared<std::atomic<int>>(0);
+    auto due_invoked = std::make_shared<event>();
+    std::thread::id cancelled_on;
+
+    {
+        timer_queue timers;
+        timers.schedule(std::chrono::milliseconds(0), [due_invoked]() { due_invoked->set(); },
+            [cancelled]() { (*cancelled)++; });
+        ASSERT_FALSE(due_invoked->wait(5000));
+
+        timers.schedule(std::chrono::hours(1), [invoked]() { *invoked = true; },
+            [cancelled, &cancelled_on]() { (*cancelled)++; cancelled_on = std::this_thread::get_id(); });
+        timers.schedule(std::chrono::hours(2), [invoked]() { *invoked = true; }, [cancelled]() { (*cancelled)++; });
+        ASSERT_EQ(2U, timers.get_pending_timer_count());
+    }
+
+    ASSERT_FALSE(invoked->load());
+    // the callback that already ran is not cancelled
+    ASSERT_EQ(2, cancelled->load());
+    ASSERT_EQ(std::this_thread::get_id(), cancelled_on);
+}
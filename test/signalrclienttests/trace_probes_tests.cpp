@@ -0,0 +1,113 @@
+// Copyright (c) .NET Foundation. All rights reserved.
+// Licensed under the Apache License, Version 2.0. See License.txt in the project root for license information.
+
+#include "stdafx.h"
+
+// the probes only exist if the library is built with the SIGNALRCLIENT_USDT CMake option
+#if defined(SIGNALRCLIENT_USDT)
+
+#include <atomic>
+#include <cstring>
+#include <dlfcn.h>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "logger.h"
+#include "hub_connection_impl.h"
+#include "trace_probes.h"
+#include "test_utils.h"
+#include "test_transport_factory.h"
+#include "test_web_request_factory.h"
+#include "trace_log_writer.h"
+
+using namespace signalr;
+
+TEST(trace_probes, probes_exist_in_library)
+{
+    // any function of the library will do to find the file it was loaded from
+    Dl_info library_info;
+    ASSERT_NE(0, dladdr(reinterpret_cast<void*>(&signalr::logger::format_entry), &library_info));
+
+    std::ifstream library(library_info.dli_fname, std::ios::in | std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(library)), std::istreambuf_iterator<char>());
+
+    // probes are described by "stapsdt" ELF notes holding the provider and the probe name
+    ASSERT_NE(std::string::npos, contents.find(std::string("stapsdt", sizeof("stapsdt"))));
+
+    const char* probes[] = { "frame_received", "parse_start", "parse_end", "hub_dispatch", "invocation_send",
+        "invocation_complete", "state_change", "reconnect_attempt" };
+
+    for (auto probe : probes)
+    {
+        auto note = std::string("signalrclient", sizeof("signalrclient")).append(probe).append(1, '\0');
+        ASSERT_NE(std::string::npos, contents.find(note)) << "probe not found: " << probe;
+    }
+}
+
+// observing the probes adds a call to each of them so it is only compiled in builds for testing the probes
+#if defined(SIGNALRCLIENT_USDT_TESTING)
+
+namespace
+{
+    std::atomic<int> invocation_complete_count(0);
+
+    void count_invocation_complete(const char* probe)
+    {
+        if (strcmp(probe, "invocation_complete") == 0)
+        {
+            invocation_complete_count++;
+        }
+    }
+}
+
+TEST(trace_probes, invocation_complete_fires_once_per_invocation_with_progress_updates)
+{
+    auto callback_registered_event = std::make_shared<event>();
+
+    int call_number = -1;
+    auto websocket_client = create_test_websocket_client(
+        /* receive function */ [call_number, callback_registered_event]()
+        mutable {
+        std::string responses[]
+        {
+            "{\"C\":\"x\", \"S\":1, \"M\":[] }",
+            "{\"C\":\"d-5E80A020-A,1|B,0|C,15|D,0\", \"M\":[{\"I\":\"P|1\", \"P\":{\"I\":\"0\", \"D\":1}}] }",
+            "{\"C\":\"d-5E80A020-A,1|B,0|C,15|D,0\", \"M\":[{\"I\":\"P|1\", \"P\":{\"I\":\"0\", \"D\":2}}] }",
+            "{\"I\":\"0\"}",
+            "{}"
+        };
+
+        call_number = std::min(call_number + 1, 4);
+
+        if (call_number > 0)
+        {
+            callback_registered_event->wait();
+        }
+
+        return pplx::task_from_result(responses[call_number]);
+    });
+
+    auto hub_connection = hub_connection_impl::create(create_uri(), _XPLATSTR(""), trace_level::none,
+        std::make_shared<trace_log_writer>(), /*use_default_url*/ true, create_test_web_request_factory(),
+        std::make_unique<test_transport_factory>(websocket_client));
+
+    invocation_complete_count = 0;
+    trace_probes::set_observer(&count_invocation_complete);
+
+    hub_connection->start()
+        .then([hub_connection, callback_registered_event]()
+    {
+        auto t = hub_connection->invoke_void(_XPLATSTR("my_hub"), _XPLATSTR("method"), json::value::array(),
+            [](const json::value&) {});
+        callback_registered_event->set();
+        return t;
+    }).get();
+
+    trace_probes::set_observer(nullptr);
+
+    ASSERT_EQ(1, invocation_complete_count.load());
+}
+
+#endif
+
+#endif
@@ -276,4 +276,18 @@ TEST(url_builder_abort, url_correct_if_connection_data_not_empty)
         web::uri(_XPLATSTR("http://fake/signalr/abort?transport=longPolling&clientProtocol=1.4&connectionToken=connection%20token&connectionData=%5B%7B%22Name%22:%22ChatHub%22%7D%5D")),
         url_builder::build_abort(web::uri{ _XPLATSTR("http://fake/signalr/") }, transport_type::long_polling,
         _XPLATSTR("connection token"), _XPLATSTR("[{\"Name\":\"ChatHub\"}]"), _XPLATSTR("")));
-}
\ No newline at end of file
+}
+
+TEST(url_builder_ping, url_correct_if_query_string_empty)
+{
+    ASSERT_EQ(
+        web::uri(_XPLATSTR("http://fake/signalr/ping")),
+        url_builder::build_ping(web::uri{ _XPLATSTR("http://fake/signalr/") }, _XPLATSTR("")));
+}
+
+TEST(url_builder_ping, url_correct_if_query_string_not_empty)
+{
+    ASSERT_EQ(
+        web::uri(_XPLATSTR("http://fake/signalr/ping?q1=1&q2=2")),
+        url_builder::build_ping(web::uri{ _XPLATSTR("http://fake/signalr/") }, _XPLATSTR("q1=1&q2=2")));
+}
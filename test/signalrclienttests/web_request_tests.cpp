@@ -4,6 +4,7 @@
 #include "stdafx.h"
 #include "cpprest/http_listener.h"
 #include "web_request.h"
+#include "signalrclient/http_client_cache.h"
 
 using namespace web;
 using namespace signalr;
@@ -41,4 +42,43 @@ TEST(web_request_get_response, sends_request_receives_response)
 
     ASSERT_TRUE(request_received);
     ASSERT_EQ(_XPLATSTR("007"), user_agent_string);
+}
+
+TEST(web_request_get_response, requests_sent_using_http_client_cache_if_set)
+{
+    web::uri url(_XPLATSTR("http://localhost:56000/web_request_test"));
+    std::vector<utility::string_t> request_paths;
+
+    http::experimental::listener::http_listener listener(url);
+    listener.support(http::methods::GET, [&request_paths](http::http_request request)
+    {
+        request_paths.push_back(request.request_uri().to_string());
+        request.reply(http::status_codes::OK, _XPLATSTR("response"));
+    });
+
+    auto cache = std::make_shared<http_client_cache>();
+    signalr_client_config config;
+    config.set_http_client_cache(cache);
+
+    listener.open().wait();
+
+    for (int i = 0; i < 2; i++)
+    {
+        web_request request(web::uri(_XPLATSTR("http://localhost:56000/web_request_test?attempt=") + utility::conversions::to_string_t(std::to_string(i))));
+        request.set_method(http::methods::GET);
+        request.set_client_config(config);
+
+        auto response = request.get_response().get();
+        ASSERT_EQ((unsigned short)200, response.status_code);
+        ASSERT_EQ(_XPLATSTR("response"), response.body.get());
+    }
+
+    listener.close().wait();
+
+    ASSERT_EQ(std::vector<utility::string_t>({ _XPLATSTR("/web_request_test?attempt=0"), _XPLATSTR("/web_request_test?attempt=1") }), request_paths);
+
+    auto statistics = cache->get_statistics();
+    ASSERT_EQ(2U, statistics.requests);
+    ASSERT_EQ(1U, statistics.hits);
+    ASSERT_EQ(1U, statistics.hosts);
 }
\ No newline at end of file